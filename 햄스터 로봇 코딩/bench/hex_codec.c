@@ -0,0 +1,288 @@
+/*
+ * Part of the ROBOID project - http://hamster.school
+ * Copyright (C) 2016 Kwang-Hyun Park (akaii@kw.ac.kr)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA  02111-1307  USA
+*/
+
+// The hex fields of recorded Hamster frames, decoded and encoded by the switch and shift loop
+// roboid.c used to have and by the tables that replaced them.
+//
+// build: gcc -O2 -o hex_codec hex_codec.c -lpthread          (Linux, macOS)
+//
+// usage: hex_codec capture_file [rounds]
+//   capture_file  made by capture("...") against a robot or the emulator; its sensory frames
+//                 are read back through replay-fast://
+//   rounds        passes over the frames (default 20000)
+//
+// decode: the 13 sensory fields of a frame, field by field as the old decoder took them,
+//         then all 20 payload bytes at once as _hamster_decode_sensories does now.
+// encode: 13 motoring fields with the layout of the motoring packet, the values taken from
+//         the decoded frames, then the 20 payload bytes of each frame with _bytes_to_hex.
+// The program fails if the old and the new functions disagree on any frame.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // as roboid.c would, before the first system header
+#endif
+#include "../source/roboid.c"
+
+#define _BENCH_MAX_FRAMES 65536
+#define _BENCH_FIELDS 13
+
+// the old codec, as it was before the tables
+char _OLD_HEX_DIGITS[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+int _old_hex_char_to_value(char character) {
+	switch(character) {
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			return (int)(character - '0');
+		case 'a':
+		case 'b':
+		case 'c':
+		case 'd':
+		case 'e':
+		case 'f':
+			return (int)(character - 'a' + 10);
+		case 'A':
+		case 'B':
+		case 'C':
+		case 'D':
+		case 'E':
+		case 'F':
+			return (int)(character - 'A' + 10);
+	}
+	return ' ';
+}
+
+int _old_value_to_hex(char* buffer, int index, int value, int bytes) {
+	int high, low, val, i;
+
+	for(i = 0; i < bytes; ++i) {
+		val = value >> ((bytes - i - 1) * 8);
+		high = (val >> 4) & 0xf;
+		low = val & 0xf;
+		buffer[index++] = _OLD_HEX_DIGITS[high];
+		buffer[index++] = _OLD_HEX_DIGITS[low];
+	}
+	return index;
+}
+
+int _old_hex_to_value(const char* str, int start, int end) {
+	int result = 0, i;
+
+	for(i = start; i < end; ++i) {
+		result <<= 4;
+		result += _old_hex_char_to_value(str[i]);
+	}
+	return result;
+}
+
+// where the old decoder read the sensory fields: start digit, bytes
+const int _BENCH_SENSORY[_BENCH_FIELDS][2] = {
+	{ 6, 1 }, { 8, 1 }, { 10, 1 }, { 12, 1 }, { 14, 1 }, { 16, 2 }, { 20, 2 },
+	{ 24, 2 }, { 28, 1 }, { 30, 2 }, { 34, 1 }, { 36, 1 }, { 38, 1 }
+};
+// the bytes of the motoring fields, in packet order
+const int _BENCH_MOTORING[_BENCH_FIELDS] = { 1, 1, 1, 1, 1, 3, 1, 1, 1, 1, 1, 1, 1 };
+
+static int _bench_is_hex(const char* str, int length) {
+	int i;
+
+	for(i = 0; i < length; ++i) {
+		if(str[i] == '\0' || strchr("0123456789ABCDEFabcdef", str[i]) == NULL) return 0;
+	}
+	return 1;
+}
+
+static int _bench_load_frames(const char* path, char* frames) {
+	char port_name[_TEMP_CHAR_BUFFER_SIZE];
+	struct _serial_frame view[64];
+	struct _serial* serial = _serial_create();
+	int count = 0, n, i;
+
+	snprintf(port_name, sizeof(port_name), "replay-fast://%s", path);
+	if(_serial_open(serial, port_name, 115200, 0) == 0) {
+		_serial_dispose(serial);
+		return -1;
+	}
+	while(count < _BENCH_MAX_FRAMES) {
+		n = _serial_read_frames(serial, '\r', view, 64);
+		if(n == 0) {
+			if(_serial_wait(serial, '\r', 100) <= 0) break; // played out
+			continue;
+		}
+		for(i = 0; i < n && count < _BENCH_MAX_FRAMES; ++i) {
+			// sensory frames only: 40 digits, '-', the address
+			if(view[i].length > _DATA_LENGTH && view[i].data[_DATA_LENGTH] == '-' && _bench_is_hex(view[i].data, _DATA_LENGTH) == 1) {
+				memcpy(frames + count * _DATA_LENGTH, view[i].data, _DATA_LENGTH);
+				++ count;
+			}
+		}
+		_serial_release_frames(serial, view, n);
+	}
+	_serial_close(serial);
+	_serial_dispose(serial);
+	return count;
+}
+
+static double _bench_per_frame(unsigned long long start, int rounds, int count) {
+	return (double)(_clock_get_time() - start) / ((double)rounds * count);
+}
+
+int main(int argc, char** argv) {
+	char* frames;
+	int* values_old;
+	int* values_new;
+	unsigned char* payloads;
+	unsigned char bytes[_HAMSTER_PAYLOAD_SIZE];
+	char buffer[_DATA_LENGTH + 2];
+	char check[_DATA_LENGTH + 2];
+	volatile unsigned int sink = 0;
+	unsigned long long start;
+	double decode_old, decode_new, decode_bytes, encode_old, encode_new, encode_bytes;
+	int count, rounds, round, f, k, index, mismatches = 0;
+
+	if(argc < 2) {
+		fprintf(stderr, "usage: hex_codec capture_file [rounds]\n");
+		return 2;
+	}
+	rounds = (argc > 2) ? atoi(argv[2]) : 20000;
+	frames = (char*)malloc(_BENCH_MAX_FRAMES * _DATA_LENGTH);
+	count = _bench_load_frames(argv[1], frames);
+	if(count <= 0) {
+		fprintf(stderr, "no sensory frames in %s\n", argv[1]);
+		return 2;
+	}
+	values_old = (int*)malloc(sizeof(int) * count * _BENCH_FIELDS);
+	values_new = (int*)malloc(sizeof(int) * count * _BENCH_FIELDS);
+	payloads = (unsigned char*)malloc(count * _HAMSTER_PAYLOAD_SIZE);
+
+	// decode
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			const char* frame = frames + f * _DATA_LENGTH;
+			int* values = values_old + f * _BENCH_FIELDS;
+
+			for(k = 0; k < _BENCH_FIELDS; ++k) {
+				values[k] = _old_hex_to_value(frame, _BENCH_SENSORY[k][0], _BENCH_SENSORY[k][0] + _BENCH_SENSORY[k][1] * 2);
+			}
+		}
+		sink += values_old[round % count];
+	}
+	decode_old = _bench_per_frame(start, rounds, count);
+
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			const char* frame = frames + f * _DATA_LENGTH;
+			int* values = values_new + f * _BENCH_FIELDS;
+
+			for(k = 0; k < _BENCH_FIELDS; ++k) {
+				values[k] = (_BENCH_SENSORY[k][1] == 1) ? _hex_to_value_1(frame, _BENCH_SENSORY[k][0]) : _hex_to_value_2(frame, _BENCH_SENSORY[k][0]);
+			}
+		}
+		sink += values_new[round % count];
+	}
+	decode_new = _bench_per_frame(start, rounds, count);
+
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			_hex_to_bytes(frames + f * _DATA_LENGTH, bytes, _HAMSTER_PAYLOAD_SIZE);
+			sink += bytes[round % _HAMSTER_PAYLOAD_SIZE];
+		}
+	}
+	decode_bytes = _bench_per_frame(start, rounds, count);
+
+	for(f = 0; f < count * _BENCH_FIELDS; ++f) {
+		if(values_old[f] != values_new[f]) ++ mismatches;
+	}
+	for(f = 0; f < count; ++f) {
+		_hex_to_bytes(frames + f * _DATA_LENGTH, payloads + f * _HAMSTER_PAYLOAD_SIZE, _HAMSTER_PAYLOAD_SIZE);
+		for(k = 0; k < _HAMSTER_PAYLOAD_SIZE; ++k) {
+			if(payloads[f * _HAMSTER_PAYLOAD_SIZE + k] != _old_hex_to_value(frames + f * _DATA_LENGTH, k * 2, k * 2 + 2)) ++ mismatches;
+		}
+	}
+
+	// encode
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			const int* values = values_old + f * _BENCH_FIELDS;
+
+			index = 0;
+			for(k = 0; k < _BENCH_FIELDS; ++k) {
+				index = _old_value_to_hex(buffer, index, values[k], _BENCH_MOTORING[k]);
+			}
+			sink += (unsigned char)buffer[round % index];
+		}
+	}
+	encode_old = _bench_per_frame(start, rounds, count);
+
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			const int* values = values_new + f * _BENCH_FIELDS;
+
+			index = 0;
+			for(k = 0; k < _BENCH_FIELDS; ++k) {
+				index = (_BENCH_MOTORING[k] == 1) ? _value_to_hex_1(check, index, values[k]) : _value_to_hex_3(check, index, values[k]);
+			}
+			sink += (unsigned char)check[round % index];
+		}
+	}
+	encode_new = _bench_per_frame(start, rounds, count);
+
+	start = _clock_get_time();
+	for(round = 0; round < rounds; ++round) {
+		for(f = 0; f < count; ++f) {
+			_bytes_to_hex(payloads + f * _HAMSTER_PAYLOAD_SIZE, check, _HAMSTER_PAYLOAD_SIZE);
+			sink += (unsigned char)check[round % _DATA_LENGTH];
+		}
+	}
+	encode_bytes = _bench_per_frame(start, rounds, count);
+
+	for(f = 0; f < count; ++f) {
+		int n = 0;
+
+		index = 0;
+		for(k = 0; k < _BENCH_FIELDS; ++k) {
+			index = _old_value_to_hex(buffer, index, values_old[f * _BENCH_FIELDS + k], _BENCH_MOTORING[k]);
+			n = (_BENCH_MOTORING[k] == 1) ? _value_to_hex_1(check, n, values_old[f * _BENCH_FIELDS + k]) : _value_to_hex_3(check, n, values_old[f * _BENCH_FIELDS + k]);
+		}
+		if(n != index || memcmp(buffer, check, index) != 0) ++ mismatches;
+	}
+
+	printf("%d sensory frames from %s, %d rounds (ns per frame)\n", count, argv[1], rounds);
+	printf("decode  switch %6.1f  table %6.1f  (%.1fx)  whole payload %6.1f\n", decode_old, decode_new, decode_old / decode_new, decode_bytes);
+	printf("encode  shift  %6.1f  table %6.1f  (%.1fx)  whole payload %6.1f\n", encode_old, encode_new, encode_old / encode_new, encode_bytes);
+	printf("mismatches: %d\n", mismatches);
+	free(payloads);
+	free(values_new);
+	free(values_old);
+	free(frames);
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+/*
+ * Part of the ROBOID project - http://hamster.school
+ * Copyright (C) 2016 Kwang-Hyun Park (akaii@kw.ac.kr)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA  02111-1307  USA
+*/
+
+// Steady-state reads of struct _serial must not allocate: frames are assembled in the ring
+// that _serial_open allocates once, whatever the backlog.
+//
+// build: gcc -O2 -o serial_reads serial_reads.c -lpthread          (Linux, macOS)
+//
+// usage: serial_reads [capture_file] [rounds]
+//   capture_file  frames received in a capture("...") session, e.g. one made against the
+//                 emulator; without it a made-up Hamster sensory stream is used
+//   rounds        times the stream is pushed through a pipe:// port (default 2000)
+//
+// Every malloc and realloc of roboid.c is counted. After one round to warm up, the
+// rounds are fed in slices that do not end on frame boundaries and drained with
+// _serial_read_frames and _serial_read_string_until; the program fails if any of them
+// allocated.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // as roboid.c would, before the first system header
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long _bench_allocations = 0;
+
+static void* _bench_malloc(size_t size) {
+	++ _bench_allocations;
+	return malloc(size);
+}
+
+static void* _bench_realloc(void* block, size_t size) {
+	++ _bench_allocations;
+	return realloc(block, size);
+}
+
+#define malloc(size) _bench_malloc(size)
+#define realloc(block, size) _bench_realloc((block), (size))
+#include "../source/roboid.c"
+#undef malloc
+#undef realloc
+
+#define _BENCH_STREAM_SIZE (1024 * 1024)
+#define _BENCH_SLICE 700 // a dozen frames and a bit: most slices end inside a frame
+#define _BENCH_MAX_FRAMES 64
+
+static int _bench_load_capture(const char* path, char* stream, int size) {
+	struct _capture* capture = _capture_open(path);
+	const struct _capture_record* record;
+	size_t offset = _CAPTURE_MAGIC_SIZE;
+	int length = 0;
+
+	if(capture == NULL) return -1;
+	while((record = _capture_get_record(capture, offset)) != NULL) {
+		if(record->direction == _CAPTURE_RECEIVED && length + (int)record->length <= size) {
+			memcpy(stream + length, (const char*)(record + 1), record->length);
+			length += (int)record->length;
+		}
+		offset = _capture_next_record(record, offset);
+	}
+	_capture_close(capture);
+	return length;
+}
+
+static int _bench_make_stream(char* stream, int size) {
+	int length = 0, i = 0;
+
+	while(length + 64 <= size && i < 4000) {
+		length += sprintf(stream + length, "00001000%02X3C3D0010FF000400010101005A5A40-A1B2C3D4E5F6\r", i & 0xff);
+		++ i;
+	}
+	return length;
+}
+
+static int _bench_push(int fd, const char* data, int length) { // the pipe is non-blocking
+	int sent = 0, n;
+
+	while(sent < length) {
+		n = (int)send(fd, data + sent, (size_t)(length - sent), 0);
+		if(n > 0) sent += n;
+		else if(n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return -1;
+		else break; // full: let the reader catch up
+	}
+	return sent;
+}
+
+static int _bench_round(struct _serial* serial, int peer, const char* stream, int length, unsigned long* frames) {
+	struct _serial_frame view[_BENCH_MAX_FRAMES];
+	char line[_TEMP_CHAR_BUFFER_SIZE];
+	int offset = 0, slice, n, count, i;
+
+	for(i = 0; offset < length; ++i) {
+		slice = length - offset < _BENCH_SLICE ? length - offset : _BENCH_SLICE;
+		n = _bench_push(peer, stream + offset, slice);
+		if(n < 0) return 0;
+		offset += n;
+		if((i & 1) == 0) { // both ways a connector reads
+			while((count = _serial_read_frames(serial, '\r', view, _BENCH_MAX_FRAMES)) > 0) {
+				_serial_release_frames(serial, view, count);
+				*frames += count;
+			}
+		} else {
+			while(_serial_read_string_until(serial, line, sizeof(line), '\r') > 0) {
+				++ *frames;
+			}
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char** argv) {
+	char* stream = (char*)malloc(_BENCH_STREAM_SIZE);
+	struct _serial* serial;
+	unsigned long frames = 0, allocations;
+	unsigned long long start, elapsed;
+	int length, rounds, peer, i;
+
+	length = (argc > 1) ? _bench_load_capture(argv[1], stream, _BENCH_STREAM_SIZE) : _bench_make_stream(stream, _BENCH_STREAM_SIZE);
+	if(length <= 0) {
+		fprintf(stderr, "no received frames in %s\n", argc > 1 ? argv[1] : "the stream");
+		return 2;
+	}
+	rounds = (argc > 2) ? atoi(argv[2]) : 2000;
+
+	serial = _serial_create();
+	if(_serial_open(serial, "pipe://serial_reads", 115200, 0) == 0) {
+		fprintf(stderr, "cannot open pipe://serial_reads\n");
+		return 2;
+	}
+	peer = (int)_serial_pipe_connect("serial_reads");
+	_bench_round(serial, peer, stream, length, &frames); // warm up
+	printf("allocations while opening: %lu\n", _bench_allocations);
+
+	frames = 0;
+	allocations = _bench_allocations;
+	start = _clock_get_time();
+	for(i = 0; i < rounds; ++i) {
+		if(_bench_round(serial, peer, stream, length, &frames) == 0) {
+			fprintf(stderr, "pipe error\n");
+			return 2;
+		}
+	}
+	elapsed = _clock_get_time() - start;
+	allocations = _bench_allocations - allocations;
+
+	printf("%d rounds of %d bytes: %lu frames in %.1f ms, %.0f ns per frame\n", rounds, length, frames,
+		elapsed / 1e6, frames > 0 ? (double)elapsed / frames : 0.0);
+	printf("overflow: %u bytes in %u events\n", serial->overflow_bytes, serial->overflow_count);
+	printf("allocations while reading: %lu\n", allocations);
+
+	close(peer);
+	_serial_close(serial);
+	_serial_dispose(serial);
+	free(stream);
+	return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,509 @@
+/*
+ * Part of the ROBOID project - http://hamster.school
+ * Copyright (C) 2016 Kwang-Hyun Park (akaii@kw.ac.kr)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA  02111-1307  USA
+*/
+
+// Virtual USB-BLE bridge with a Hamster behind it, for machines without a robot.
+//
+// build: gcc -O2 -o emulator emulator.c          (Linux, macOS)
+//
+// usage: emulator [-n robots] [-r frames_per_second] [-t tcp_port] [-u unix_path] [-a address] [-b]
+//   -n  number of robots, one endpoint each (default 1)
+//   -b  all robots behind one bridge, on the endpoint of the first: frames interleaved, every robot
+//       answers the identity request and takes the motoring packets sent to its address
+//   -r  sensory frames per second per robot (default 50, the real bridge)
+//   -t  listen on tcp_port, tcp_port + 1, ... instead of creating ptys
+//   -u  listen on unix_path0, unix_path1, ... instead of creating ptys
+//   -a  address of the first robot as 12 hex digits, the others count up
+//   -v  print frame counters every second
+//
+// Each endpoint name is printed on start-up and can be given to hamster_create_port(),
+// e.g. "/dev/pts/5", "tcp://127.0.0.1:9000" or "unix:///tmp/hamster0".
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_ROBOTS 256
+#define PACKET_LENGTH 54
+#define DATA_LENGTH 40
+#define ADDRESS_LENGTH 12
+#define LINE_LENGTH 128
+#define MAX_BURST 64 // frames written at once when the loop falls behind
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // SIGPIPE is ignored instead
+#endif
+
+#define ENDPOINT_PTY 0
+#define ENDPOINT_TCP 1
+#define ENDPOINT_UNIX 2
+
+struct robot {
+	int index;
+	struct robot* bridge; // the robot whose endpoint it is behind, itself unless -b
+	char address[ADDRESS_LENGTH + 1];
+	char name[LINE_LENGTH];
+	int listen_fd; // -1 for a pty
+	int fd; // pty master or accepted client, -1 if none
+	int slave_fd; // kept open so that the master does not hang up between clients
+	char line[LINE_LENGTH];
+	int line_length;
+	double next_frame;
+	unsigned int sequence;
+	// motoring state, as last written by the library
+	int topology;
+	int left_wheel;
+	int right_wheel;
+	int line_tracer;
+	int io_mode;
+	int output_a;
+	int output_b;
+	// simulated world
+	double distance; // to the wall in front, mm
+	int line_tracer_state;
+	double line_tracer_until;
+	// counters
+	unsigned long sent;
+	unsigned long dropped;
+	unsigned long received;
+	unsigned long rejected;
+};
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+static volatile sig_atomic_t running = 1;
+static struct robot robots[MAX_ROBOTS];
+static int robot_count = 1;
+
+static void on_signal(int signal_number) {
+	running = 0;
+}
+
+static double now(void) {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+static int put_hex(char* buffer, int index, int value, int bytes) {
+	int i;
+
+	for(i = bytes * 2 - 1; i >= 0; --i) {
+		buffer[index++] = HEX_DIGITS[(value >> (i * 4)) & 0x0f];
+	}
+	return index;
+}
+
+static int hex_char_to_value(int c) {
+	if(c >= '0' && c <= '9') return c - '0';
+	if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+static int is_hex(const char* str, int length) {
+	int i;
+
+	for(i = 0; i < length; ++i) {
+		if(hex_char_to_value((unsigned char)str[i]) < 0) return 0;
+	}
+	return 1;
+}
+
+static int get_hex(const char* str, int start, int end) {
+	int result = 0, i;
+
+	for(i = start; i < end; ++i) {
+		result = (result << 4) | hex_char_to_value((unsigned char)str[i]);
+	}
+	return result;
+}
+
+static int open_pty(struct robot* robot) {
+	struct termios tio;
+	int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+	if(fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+		perror("pty");
+		return -1;
+	}
+	snprintf(robot->name, LINE_LENGTH, "%s", ptsname(fd));
+	robot->slave_fd = open(robot->name, O_RDWR | O_NOCTTY);
+	if(robot->slave_fd < 0) {
+		perror(robot->name);
+		return -1;
+	}
+	// raw so that '\r' is not translated, before the library sets its own parameters
+	if(tcgetattr(robot->slave_fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		tcsetattr(robot->slave_fd, TCSANOW, &tio);
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	robot->listen_fd = -1;
+	robot->fd = fd;
+	return 1;
+}
+
+static int open_listener(struct robot* robot, int type, int tcp_port, const char* unix_path) {
+	int fd, on = 1;
+
+	if(type == ENDPOINT_TCP) {
+		struct sockaddr_in address;
+
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		if(fd < 0) return -1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons((unsigned short)(tcp_port + robot->index));
+		if(bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+			perror("bind");
+			close(fd);
+			return -1;
+		}
+		snprintf(robot->name, LINE_LENGTH, "tcp://127.0.0.1:%d", tcp_port + robot->index);
+	} else {
+		struct sockaddr_un address;
+
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if(fd < 0) return -1;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		snprintf(address.sun_path, sizeof(address.sun_path), "%s%d", unix_path, robot->index);
+		unlink(address.sun_path);
+		if(bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+			perror("bind");
+			close(fd);
+			return -1;
+		}
+		snprintf(robot->name, LINE_LENGTH, "unix://%s", address.sun_path);
+	}
+	listen(fd, 1);
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	robot->listen_fd = fd;
+	robot->fd = -1;
+	robot->slave_fd = -1;
+	return 1;
+}
+
+static void accept_client(struct robot* robot) {
+	int fd = accept(robot->listen_fd, NULL, NULL), on = 1;
+
+	if(fd < 0) return;
+	if(robot->fd >= 0) { // one client per robot, like a serial port
+		close(fd);
+		return;
+	}
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	robot->fd = fd;
+	robot->line_length = 0;
+}
+
+static void drop_client(struct robot* robot) {
+	int i;
+
+	if(robot->listen_fd < 0) return; // a pty master stays open for the next client
+	close(robot->fd);
+	robot->fd = -1;
+	for(i = 0; i < robot_count; ++i) {
+		if(robots[i].bridge == robot) {
+			robots[i].left_wheel = 0;
+			robots[i].right_wheel = 0;
+		}
+	}
+}
+
+static int write_all(struct robot* robot, const char* buffer, int length) {
+	int written = 0, n;
+
+	robot = robot->bridge;
+
+	while(written < length) {
+		if(robot->listen_fd >= 0) {
+			n = (int)send(robot->fd, buffer + written, (size_t)(length - written), MSG_NOSIGNAL);
+		} else {
+			n = (int)write(robot->fd, buffer + written, (size_t)(length - written));
+		}
+		if(n > 0) {
+			written += n;
+		} else if(n < 0 && errno == EINTR) {
+			continue;
+		} else {
+			break;
+		}
+	}
+	return written;
+}
+
+static void handle_motoring(struct robot* robot, const char* line, double t) {
+	int line_tracer;
+
+	if(is_hex(line, DATA_LENGTH) == 0) {
+		++ robot->rejected;
+		return;
+	}
+	if(memcmp(line + DATA_LENGTH + 1, robot->address, ADDRESS_LENGTH) != 0) {
+		++ robot->rejected;
+		return;
+	}
+	++ robot->received;
+	robot->topology = get_hex(line, 0, 2);
+	robot->left_wheel = (signed char)get_hex(line, 6, 8);
+	robot->right_wheel = (signed char)get_hex(line, 8, 10);
+	line_tracer = get_hex(line, 22, 24);
+	robot->io_mode = get_hex(line, 28, 30);
+	robot->output_a = get_hex(line, 30, 32);
+	robot->output_b = get_hex(line, 32, 34);
+	if(((line_tracer ^ robot->line_tracer) & 0x80) != 0 && (line_tracer & 0x78) != 0) {
+		// a new line tracer command: report "moving", then "done" half a second later
+		robot->line_tracer_state = 0x41;
+		robot->line_tracer_until = t + 0.5;
+	}
+	robot->line_tracer = line_tracer;
+}
+
+static void handle_line(struct robot* robot, const char* line, int length, double t) {
+	char reply[LINE_LENGTH];
+	struct robot* target = robot;
+	int n, i;
+
+	if(length == 2 && line[0] == 'F' && line[1] == 'F') {
+		for(i = 0; i < robot_count; ++i) { // every robot behind the bridge answers
+			if(robots[i].bridge != robot) continue;
+			n = snprintf(reply, LINE_LENGTH, "FF,Hamster,04,00,%s\r", robots[i].address);
+			write_all(&robots[i], reply, n);
+		}
+	} else if(length == PACKET_LENGTH - 1 && line[DATA_LENGTH] == '-') {
+		for(i = 0; i < robot_count; ++i) {
+			if(robots[i].bridge == robot && memcmp(line + DATA_LENGTH + 1, robots[i].address, ADDRESS_LENGTH) == 0) {
+				target = &robots[i];
+				break;
+			}
+		}
+		handle_motoring(target, line, t);
+	} else {
+		++ robot->rejected;
+	}
+}
+
+static void receive(struct robot* robot, double t) {
+	char buffer[4096];
+	int n, i;
+
+	n = (int)read(robot->fd, buffer, sizeof(buffer));
+	if(n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+		drop_client(robot);
+		return;
+	}
+	for(i = 0; i < n; ++i) {
+		if(buffer[i] == '\r') {
+			handle_line(robot, robot->line, robot->line_length, t);
+			robot->line_length = 0;
+		} else if(robot->line_length < LINE_LENGTH - 1) {
+			robot->line[robot->line_length++] = buffer[i];
+		}
+	}
+}
+
+static int encode_sensory_packet(struct robot* robot, char* buffer, double t, double dt) {
+	int index = 0, proximity, value;
+	double speed = (robot->left_wheel + robot->right_wheel) * 0.5;
+
+	// a wall ahead that the robot drives towards and away from
+	robot->distance -= speed * 3.0 * dt; // about 300 mm/s at full speed
+	if(robot->distance < 5) robot->distance = 5;
+	if(robot->distance > 500) robot->distance = 500;
+	proximity = (int)(255 * 20 / (robot->distance + 15));
+	if(robot->line_tracer_state == 0x41 && t >= robot->line_tracer_until) {
+		robot->line_tracer_state = 0x40;
+	}
+
+	index = put_hex(buffer, index, robot->topology & 0x0f, 1);
+	index = put_hex(buffer, index, robot->sequence, 2); // not read by the library
+	index = put_hex(buffer, index, 0x100 - 40 - (robot->index % 30), 1); // signal strength
+	index = put_hex(buffer, index, proximity, 1);
+	index = put_hex(buffer, index, proximity + (robot->sequence & 3), 1);
+	index = put_hex(buffer, index, 60 + (robot->sequence & 7), 1); // left floor
+	index = put_hex(buffer, index, 62 + (robot->sequence & 7), 1); // right floor
+	index = put_hex(buffer, index, (robot->right_wheel - robot->left_wheel) * 8, 2); // acceleration x
+	index = put_hex(buffer, index, (int)(speed * 4), 2); // acceleration y
+	index = put_hex(buffer, index, 4096, 2); // acceleration z: 1 g
+	if((robot->sequence & 1) == 0) {
+		index = put_hex(buffer, index, 0, 1);
+		index = put_hex(buffer, index, 300 + (robot->sequence & 15), 2); // light
+	} else {
+		value = (25 - 24) * 2; // 25 degrees
+		index = put_hex(buffer, index, 1, 1);
+		index = put_hex(buffer, index, value, 1);
+		index = put_hex(buffer, index, 0, 1);
+	}
+	index = put_hex(buffer, index, (robot->io_mode & 0xf0) >= 0x80 ? robot->output_a : 0x80, 1); // input a
+	index = put_hex(buffer, index, (robot->io_mode & 0x0f) >= 0x08 ? robot->output_b : 0x80, 1); // input b
+	index = put_hex(buffer, index, robot->line_tracer_state, 1);
+	buffer[index++] = '-';
+	memcpy(buffer + index, robot->address, ADDRESS_LENGTH);
+	index += ADDRESS_LENGTH;
+	buffer[index++] = '\r';
+	++ robot->sequence;
+	return index;
+}
+
+static void send_frames(struct robot* robot, double t, double period) {
+	char buffer[PACKET_LENGTH * MAX_BURST];
+	int count = 0, length = 0, written;
+
+	if(robot->bridge->fd < 0) {
+		robot->next_frame = t;
+		return;
+	}
+	while(robot->next_frame <= t && count < MAX_BURST) {
+		length += encode_sensory_packet(robot, buffer + length, t, period);
+		robot->next_frame += period;
+		++ count;
+	}
+	if(robot->next_frame <= t) {
+		// too far behind: skip ahead rather than bursting forever
+		robot->dropped += (unsigned long)((t - robot->next_frame) / period);
+		robot->next_frame = t + period;
+	}
+	if(count == 0) return;
+	written = write_all(robot, buffer, length);
+	robot->sent += written / PACKET_LENGTH;
+	if(written < length) {
+		// the link is full, as a bridge would, lose whole frames
+		robot->dropped += (length - written) / PACKET_LENGTH;
+		if(written % PACKET_LENGTH != 0) {
+			write_all(robot, buffer + written, PACKET_LENGTH - written % PACKET_LENGTH);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	struct pollfd fds[MAX_ROBOTS];
+	unsigned long long address = 0xE0E000000000ULL;
+	const char* unix_path = NULL;
+	double rate = 50, period, t, next_report, wait_time;
+	int count = 1, tcp_port = 0, type = ENDPOINT_PTY, verbose = 0, bridged = 0;
+	int option, i, timeout;
+
+	while((option = getopt(argc, argv, "n:r:t:u:a:bv")) != -1) {
+		switch(option) {
+			case 'n': count = atoi(optarg); break;
+			case 'r': rate = atof(optarg); break;
+			case 't': tcp_port = atoi(optarg); type = ENDPOINT_TCP; break;
+			case 'u': unix_path = optarg; type = ENDPOINT_UNIX; break;
+			case 'a': address = strtoull(optarg, NULL, 16); break;
+			case 'b': bridged = 1; break;
+			case 'v': verbose = 1; break;
+			default:
+				fprintf(stderr, "usage: %s [-n robots] [-r frames_per_second] [-t tcp_port] [-u unix_path] [-a address] [-b] [-v]\n", argv[0]);
+				return 1;
+		}
+	}
+	if(count < 1 || count > MAX_ROBOTS || rate <= 0) {
+		fprintf(stderr, "robots must be 1 to %d and the rate positive\n", MAX_ROBOTS);
+		return 1;
+	}
+	period = 1.0 / rate;
+	robot_count = count;
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	signal(SIGPIPE, SIG_IGN);
+
+	t = now();
+	for(i = 0; i < count; ++i) {
+		struct robot* robot = &robots[i];
+
+		robot->index = i;
+		snprintf(robot->address, sizeof(robot->address), "%012llX", (address + i) & 0xFFFFFFFFFFFFULL);
+		robot->distance = 300;
+		robot->next_frame = t;
+		robot->bridge = (bridged == 1) ? &robots[0] : robot;
+		if(robot->bridge != robot) {
+			snprintf(robot->name, LINE_LENGTH, "%s", robots[0].name);
+			robot->listen_fd = -1;
+			robot->fd = -1; // reads and writes go through the bridge
+			robot->slave_fd = -1;
+		} else if(type == ENDPOINT_PTY) {
+			if(open_pty(robot) < 0) return 1;
+		} else if(open_listener(robot, type, tcp_port, unix_path) < 0) {
+			return 1;
+		}
+		printf("%s %s\n", robot->name, robot->address);
+	}
+	fflush(stdout);
+
+	next_report = t + 1;
+	while(running) {
+		t = now();
+		wait_time = next_report - t;
+		for(i = 0; i < count; ++i) {
+			if(robots[i].bridge->fd >= 0 && robots[i].next_frame - t < wait_time) {
+				wait_time = robots[i].next_frame - t;
+			}
+		}
+		timeout = wait_time > 0 ? (int)(wait_time * 1000) : 0;
+		for(i = 0; i < count; ++i) {
+			// behind the bridge of another robot: nothing to poll, a negative descriptor is skipped
+			fds[i].fd = robots[i].bridge != &robots[i] ? -1 : (robots[i].fd >= 0 ? robots[i].fd : robots[i].listen_fd);
+			fds[i].events = POLLIN;
+			fds[i].revents = 0;
+		}
+		if(poll(fds, (nfds_t)count, timeout) < 0 && errno != EINTR) break;
+
+		t = now();
+		for(i = 0; i < count; ++i) {
+			if((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+				if(robots[i].fd >= 0) receive(&robots[i], t);
+				else accept_client(&robots[i]);
+			}
+			send_frames(&robots[i], t, period);
+		}
+		if(verbose && t >= next_report) {
+			for(i = 0; i < count; ++i) {
+				printf("%s sent %lu dropped %lu received %lu rejected %lu\n", robots[i].name, robots[i].sent, robots[i].dropped, robots[i].received, robots[i].rejected);
+			}
+			fflush(stdout);
+		}
+		while(next_report <= t) next_report += 1;
+	}
+
+	for(i = 0; i < count; ++i) {
+		if(robots[i].fd >= 0) close(robots[i].fd);
+		if(robots[i].listen_fd >= 0) close(robots[i].listen_fd);
+		if(robots[i].slave_fd >= 0) close(robots[i].slave_fd);
+	}
+	return 0;
+}
@@ -1,3694 +1,7430 @@
-/*
- * Part of the ROBOID project - http://hamster.school
- * Copyright (C) 2016 Kwang-Hyun Park (akaii@kw.ac.kr)
- * 
- * This library is free software; you can redistribute it and/or
- * modify it under the terms of the GNU Lesser General Public
- * License as published by the Free Software Foundation; either
- * version 2.1 of the License, or (at your option) any later version.
- * 
- * This library is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- * Lesser General Public License for more details.
- * 
- * You should have received a copy of the GNU Lesser General
- * Public License along with this library; if not, write to the
- * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
- * Boston, MA  02111-1307  USA
-*/
-
-#include <process.h>
-#include <stdio.h>
-#include <windows.h>
-#include <signal.h>
-#include <sys/timeb.h>
-#include "roboid.h"
-
-#ifdef _MSC_VER
-#define _STRCPY(dst, sz, src) strcpy_s((dst), (sz), (src))
-#define _STRCAT(dst, sz, src) strcat_s((dst), (sz), (src))
-#define _STRNCPY(dst, sz, src, n) strncpy_s((dst), (sz), (src), (n))
-#define _STRICMP(s1, s2) _stricmp((s1), (s2))
-#else
-#define _STRCPY(dst, sz, src) strcpy((dst), (src))
-#define _STRCAT(dst, sz, src) strcat((dst), (src))
-#define _STRNCPY(dst, sz, src, n) strncpy((dst), (src), (n))
-#define _STRICMP(s1, s2) stricmp((s1), (s2))
-#endif
-
-#ifdef _WIN64
-#define _LONG long long
-#else
-#define _LONG long
-#endif
-
-/*------------------------------
-  SERIAL
-------------------------------*/
-
-#define _SERIAL_BAUDRATE_110 110
-#define _SERIAL_BAUDRATE_300 300
-#define _SERIAL_BAUDRATE_600 600
-#define _SERIAL_BAUDRATE_1200 1200
-#define _SERIAL_BAUDRATE_4800 4800
-#define _SERIAL_BAUDRATE_9600 9600
-#define _SERIAL_BAUDRATE_14400 14400
-#define _SERIAL_BAUDRATE_19200 19200
-#define _SERIAL_BAUDRATE_38400 38400
-#define _SERIAL_BAUDRATE_57600 57600
-#define _SERIAL_BAUDRATE_115200 115200
-#define _SERIAL_BAUDRATE_128000 128000
-#define _SERIAL_BAUDRATE_256000 256000
-
-#define _SERIAL_DATABITS_5 5
-#define _SERIAL_DATABITS_6 6
-#define _SERIAL_DATABITS_7 7
-#define _SERIAL_DATABITS_8 8
-
-#define _SERIAL_STOPBITS_1 1
-#define _SERIAL_STOPBITS_2 2
-#define _SERIAL_STOPBITS_1_5 3
-
-#define _SERIAL_PARITY_NONE 0
-#define _SERIAL_PARITY_ODD 1
-#define _SERIAL_PARITY_EVEN 2
-#define _SERIAL_PARITY_MARK 3
-#define _SERIAL_PARITY_SPACE 4
-
-#define _SERIAL_PURGE_RXABORT 0x0002
-#define _SERIAL_PURGE_RXCLEAR 0x0008
-#define _SERIAL_PURGE_TXABORT 0x0001
-#define _SERIAL_PURGE_TXCLEAR 0x0004
-
-#define _SERIAL_MASK_RXCHAR 1
-#define _SERIAL_MASK_RXFLAG 2
-#define _SERIAL_MASK_TXEMPTY 4
-#define _SERIAL_MASK_CTS 8
-#define _SERIAL_MASK_DSR 16
-#define _SERIAL_MASK_RLSD 32
-#define _SERIAL_MASK_BREAK 64
-#define _SERIAL_MASK_ERR 128
-#define _SERIAL_MASK_RING 256
-
-#define _SERIAL_FLOWCONTROL_NONE 0
-#define _SERIAL_FLOWCONTROL_RTSCTS_IN 1
-#define _SERIAL_FLOWCONTROL_RTSCTS_OUT 2
-#define _SERIAL_FLOWCONTROL_XONXOFF_IN 4
-#define _SERIAL_FLOWCONTROL_XONXOFF_OUT 8
-
-#define _SERIAL_ERROR_FRAME 0x0008
-#define _SERIAL_ERROR_OVERRUN 0x0002
-#define _SERIAL_ERROR_PARITY 0x0004
-
-#define _SERIAL_ERROR_PORT_BUSY -1
-#define _SERIAL_ERROR_PORT_NOT_FOUND -2
-#define _SERIAL_ERROR_PERMISSION_DENIED -3
-#define _SERIAL_ERROR_INCORRECT_SERIAL_PORT -4
-
-#define _SERIAL_PARAMS_FLAG_IGNPAR 1
-#define _SERIAL_PARAMS_FLAG_PARMRK 2
-
-#define _TEMP_CHAR_BUFFER_SIZE 256
-#define _SERIAL_BUFFER_SIZE 32768
-
-struct _serial {
-	_LONG port_handle;
-	int port_opened;
-	char* buffer;
-	int buffer_size;
-	int offset;
-};
-
-char** _serial_window_get_serial_port_names(const char* keyword, int* count);
-_LONG _serial_window_open_port(const char* port_name);
-int _serial_window_close_port(_LONG port_handle);
-int _serial_window_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags);
-int _serial_window_set_flow_control_mode(_LONG port_handle, int mask);
-int _serial_window_purge_port(_LONG port_handle, int flags);
-int _serial_window_count_read_bytes(_LONG port_handle);
-int _serial_window_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size);
-int _serial_window_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size);
-
-struct _serial* _serial_create(void);
-void _serial_dispose(struct _serial* serial);
-int _serial_open(struct _serial* serial, const char* port_name, int baud_rate, int flow_control);
-void _serial_close(struct _serial* serial);
-void _serial_clear(struct _serial* serial);
-int _serial_read_string_until(struct _serial* serial, char* buffer, int buffer_size, char delimiter);
-int _serial_write(const struct _serial* serial, const char* buffer, int buffer_size);
-
-char** _serial_window_get_serial_port_names(const char* keyword, int* count) {
-	HKEY result;
-	LPCSTR sub_key = "HARDWARE\\DEVICEMAP\\SERIALCOMM\\";
-	char** names = NULL;
-	int names_count = 0;
-	
-	if(RegOpenKeyExA(HKEY_LOCAL_MACHINE, sub_key, 0, KEY_READ, &result) == ERROR_SUCCESS) {
-		int has_more_elements = 1;
-		char value_name[_TEMP_CHAR_BUFFER_SIZE];
-		DWORD keys_count = 0, value_name_size, enum_result;
-		
-		while(has_more_elements == 1) {
-			value_name_size = _TEMP_CHAR_BUFFER_SIZE;
-			enum_result = RegEnumValueA(result, keys_count, value_name, &value_name_size, NULL, NULL, NULL, NULL);
-			if(enum_result == ERROR_SUCCESS) {
-				++ keys_count;
-				if(keyword == NULL || strstr(value_name, keyword) != NULL) {
-					++ names_count;
-				}
-			} else if(enum_result == ERROR_NO_MORE_ITEMS) {
-				has_more_elements = 0;
-			} else {
-				has_more_elements = 0;
-			}
-		}
-		if(names_count > 0) {
-			byte data[_TEMP_CHAR_BUFFER_SIZE];
-			DWORD data_size;
-			int names_index = 0, i;
-			DWORD j;
-			
-			names = (char**)malloc(sizeof(char*) * names_count);
-			for(i = 0; i < names_count; ++i) {
-				names[i] = (char*)malloc(sizeof(char) * _TEMP_CHAR_BUFFER_SIZE);
-			}
-			for(j = 0; j < keys_count; ++j) {
-				value_name_size = _TEMP_CHAR_BUFFER_SIZE;
-				data_size = _TEMP_CHAR_BUFFER_SIZE;
-				enum_result = RegEnumValueA(result, j, value_name, &value_name_size, NULL, NULL, data, &data_size);
-				if(enum_result == ERROR_SUCCESS) {
-					if(keyword == NULL || strstr(value_name, keyword) != NULL) {
-						_STRCPY(names[names_index], _TEMP_CHAR_BUFFER_SIZE, (const char*)data);
-						++ names_index;
-					}
-				}
-			}
-		}
-		CloseHandle(result);
-	}
-	*count = names_count;
-	return names;
-}
-
-_LONG _serial_window_open_port(const char* port_name) {
-	const char* prefix= "\\\\.\\";
-	char port_full_name[_TEMP_CHAR_BUFFER_SIZE];
-	HANDLE comm;
-
-	_STRCPY(port_full_name, _TEMP_CHAR_BUFFER_SIZE, prefix);
-	_STRCAT(port_full_name, _TEMP_CHAR_BUFFER_SIZE, port_name);
-
-	comm = CreateFileA((LPCSTR)port_full_name,
-		GENERIC_READ | GENERIC_WRITE,
-		0,
-		NULL,
-		OPEN_EXISTING,
-		FILE_FLAG_OVERLAPPED,
-		0);
-
-	if(comm != INVALID_HANDLE_VALUE) {
-		DCB dcb = { 0 };
-		dcb.DCBlength = sizeof(DCB);
-		if(!GetCommState(comm, &dcb)) {
-			CloseHandle(comm);
-			comm = (HANDLE)_SERIAL_ERROR_INCORRECT_SERIAL_PORT;
-		}
-	} else {
-		DWORD error_value = GetLastError();
-		if(error_value == ERROR_ACCESS_DENIED) {
-			comm = (HANDLE)_SERIAL_ERROR_PORT_BUSY;
-		} else if(error_value == ERROR_FILE_NOT_FOUND) {
-			comm = (HANDLE)_SERIAL_ERROR_PORT_NOT_FOUND;
-		}
-	}
-	return (_LONG)comm;
-}
-
-int _serial_window_close_port(_LONG port_handle) {
-	return CloseHandle((HANDLE)port_handle) ? 1 : 0;
-}
-
-int _serial_window_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags) {
-	HANDLE comm = (HANDLE)port_handle;
-	int return_value = 0;
-	DCB dcb = { 0 };
-
-	dcb.DCBlength = sizeof(DCB);
-	if(GetCommState(comm, &dcb)) {
-		dcb.BaudRate = baud_rate;
-		dcb.ByteSize = byte_size;
-		dcb.StopBits = stop_bits;
-		dcb.Parity = parity;
-
-		if(set_rts == 1) {
-			dcb.fRtsControl = RTS_CONTROL_ENABLE;
-		} else {
-			dcb.fRtsControl = RTS_CONTROL_DISABLE;
-		}
-		if(set_dtr == 1) {
-			dcb.fDtrControl = DTR_CONTROL_ENABLE;
-		} else {
-			dcb.fDtrControl = DTR_CONTROL_DISABLE;
-		}
-		dcb.fOutxCtsFlow = FALSE;
-		dcb.fOutxDsrFlow = FALSE;
-		dcb.fDsrSensitivity = FALSE;
-		dcb.fTXContinueOnXoff = TRUE;
-		dcb.fOutX = FALSE;
-		dcb.fInX = FALSE;
-		dcb.fErrorChar = FALSE;
-		dcb.fNull = FALSE;
-		dcb.fAbortOnError = FALSE;
-		dcb.XonLim = 2048;
-		dcb.XoffLim = 512;
-		dcb.XonChar = (char)17; //DC1
-		dcb.XoffChar = (char)19; //DC3
-
-		if(SetCommState(comm, &dcb)) {
-			COMMTIMEOUTS comm_timeouts = { 0 };
-			comm_timeouts.ReadIntervalTimeout = 0;
-			comm_timeouts.ReadTotalTimeoutConstant = 100;
-			comm_timeouts.ReadTotalTimeoutMultiplier = 0;
-			comm_timeouts.WriteTotalTimeoutConstant = 0;
-			comm_timeouts.WriteTotalTimeoutMultiplier = 0;
-			if(SetCommTimeouts(comm, &comm_timeouts)) {
-				return_value = 1;
-			}
-		}
-	}
-	return return_value;
-}
-
-int _serial_window_set_flow_control_mode(_LONG port_handle, int mask) {
-	HANDLE comm = (HANDLE)port_handle;
-	int return_value = 0;
-	DCB dcb = { 0 };
-
-	dcb.DCBlength = sizeof(DCB);
-	if(GetCommState(comm, &dcb)) {
-		dcb.fRtsControl = RTS_CONTROL_ENABLE;
-		dcb.fOutxCtsFlow = FALSE;
-		dcb.fOutX = FALSE;
-		dcb.fInX = FALSE;
-		if(mask != _SERIAL_FLOWCONTROL_NONE) {
-			if((mask & _SERIAL_FLOWCONTROL_RTSCTS_IN) == _SERIAL_FLOWCONTROL_RTSCTS_IN) {
-				dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
-			}
-			if((mask & _SERIAL_FLOWCONTROL_RTSCTS_OUT) == _SERIAL_FLOWCONTROL_RTSCTS_OUT) {
-				dcb.fOutxCtsFlow = TRUE;
-			}
-			if((mask & _SERIAL_FLOWCONTROL_XONXOFF_IN) == _SERIAL_FLOWCONTROL_XONXOFF_IN) {
-				dcb.fInX = TRUE;
-			}
-			if((mask & _SERIAL_FLOWCONTROL_XONXOFF_OUT) == _SERIAL_FLOWCONTROL_XONXOFF_OUT) {
-				dcb.fOutX = TRUE;
-			}
-		}
-		if(SetCommState(comm, &dcb)) {
-			return_value = 1;
-		}
-	}
-	return return_value;
-}
-
-int _serial_window_purge_port(_LONG port_handle, int flags) {
-	return PurgeComm((HANDLE)port_handle, (DWORD)flags) ? 1 : 0;
-}
-
-int _serial_window_count_read_bytes(_LONG port_handle) {
-	HANDLE comm = (HANDLE)port_handle;
-	DWORD errors;
-	COMSTAT comstat = { 0 };
-	int return_value = -1;
-
-	if(ClearCommError(comm, &errors, &comstat)) {
-		return_value = comstat.cbInQue;
-	} else {
-		return_value = -1;
-	}
-	return return_value;
-}
-
-int _serial_window_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size) {
-	HANDLE comm = (HANDLE)port_handle;
-	DWORD number_of_bytes_transferred;
-	DWORD number_of_bytes_read;
-	OVERLAPPED overlapped = { 0 };
-	int return_value = 0;
-
-	overlapped.hEvent = CreateEventA(NULL, 1, 0, NULL);
-	if(ReadFile(comm, buffer, (DWORD)buffer_size, &number_of_bytes_read, &overlapped)) {
-		return_value = number_of_bytes_read;
-	} else if(GetLastError() == ERROR_IO_PENDING) {
-		if(WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
-			if(GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 0)) {
-				return_value = number_of_bytes_transferred;
-			}
-		}
-	}
-	CloseHandle(overlapped.hEvent);
-	return return_value;
-}
-
-int _serial_window_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size) {
-	HANDLE comm = (HANDLE)port_handle;
-	DWORD number_of_bytes_transferred;
-	DWORD number_of_bytes_written;
-	OVERLAPPED overlapped = { 0 };
-	int return_value = 0;
-
-	overlapped.hEvent = CreateEventA(NULL, 1, 0, NULL);
-	if(WriteFile(comm, buffer, buffer_size, &number_of_bytes_written, &overlapped)) {
-		return_value = 1;
-	} else if(GetLastError() == ERROR_IO_PENDING) {
-		if(WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
-			if(GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 0)) {
-				return_value = 1;
-			}
-		}
-	}
-	CloseHandle(overlapped.hEvent);
-	return return_value;
-}
-
-struct _serial* _serial_create(void) {
-	struct _serial* serial = (struct _serial*)malloc(sizeof(struct _serial));
-	serial->port_handle = 0;
-	serial->port_opened = 0;
-	serial->buffer = NULL;
-	serial->buffer_size = 0;
-	serial->offset = 0;
-	return serial;
-}
-
-void _serial_dispose(struct _serial* serial) {
-	if(serial == NULL) return;
-	_serial_close(serial); // free buffer
-	free(serial);
-}
-
-int _serial_open(struct _serial* serial, const char* port_name, int baud_rate, int flow_control) {
-	_LONG port_handle;
-
-	if(serial == NULL) return 0;
-	if(serial->port_opened == 1) return 0;
-	
-	port_handle = _serial_window_open_port(port_name);
-	if(port_handle == _SERIAL_ERROR_PORT_BUSY) return 0;
-	else if(port_handle == _SERIAL_ERROR_PORT_NOT_FOUND) return 0;
-	else if(port_handle == _SERIAL_ERROR_PERMISSION_DENIED) return 0;
-	else if(port_handle == _SERIAL_ERROR_INCORRECT_SERIAL_PORT) return 0;
-	
-	serial->port_handle = port_handle;
-	serial->port_opened = 1;
-	serial->offset = 0;
-	
-	if(serial->buffer != NULL) {
-		free(serial->buffer);
-		serial->buffer = NULL;
-	}
-	serial->buffer_size = _SERIAL_BUFFER_SIZE;
-	serial->buffer = (char*)malloc(sizeof(char) * _SERIAL_BUFFER_SIZE);
-	_serial_window_set_params(port_handle, baud_rate, _SERIAL_DATABITS_8, 0, _SERIAL_PARITY_NONE, 1, 1, 0);
-	_serial_window_set_flow_control_mode(port_handle, flow_control);
-	return 1;
-}
-
-void _serial_close(struct _serial* serial) {
-	if(serial == NULL) return;
-	if(serial->port_opened == 0) return;
-
-	serial->buffer_size = 0;
-	if(serial->buffer != NULL) {
-		free(serial->buffer);
-		serial->buffer = NULL;
-	}
-	if(_serial_window_close_port(serial->port_handle) == 1) {
-		serial->port_opened = 0;
-	}
-	serial->offset = 0;
-	serial->port_handle = 0;
-}
-
-void _serial_clear(struct _serial* serial) {
-	if(serial == NULL) return;
-	if(serial->port_opened == 0) return;
-	
-	serial->offset = 0;
-	_serial_window_purge_port(serial->port_handle, _SERIAL_PURGE_RXCLEAR | _SERIAL_PURGE_RXABORT | _SERIAL_PURGE_TXCLEAR | _SERIAL_PURGE_TXABORT);
-}
-
-int _serial_read_string_until(struct _serial* serial, char* buffer, int buffer_size, char delimiter) {
-	_LONG port_handle;
-	int to_read, read_bytes;
-	int size, found, i;
-	char* temp;
-
-	if(serial == NULL) return 0;
-	if(serial->port_opened == 0) return 0;
-
-	port_handle = serial->port_handle;
-	to_read = _serial_window_count_read_bytes(port_handle);
-	while(to_read > 0) {
-		if(serial->buffer_size < serial->offset + to_read) {
-			size = (serial->offset + to_read) * 2;
-			temp = (char*)malloc(sizeof(char) * size);
-			_STRNCPY(temp, size, serial->buffer, serial->buffer_size);
-			free(serial->buffer);
-			serial->buffer = temp;
-			serial->buffer_size = size;
-		}
-		read_bytes = _serial_window_read_bytes(port_handle, (unsigned char*)(serial->buffer + serial->offset), to_read);
-		serial->offset += read_bytes;
-
-		found = -1;
-		for(i = 0; i < serial->offset; ++i) {
-			if(serial->buffer[i] == delimiter) {
-				found = i;
-				break;
-			}
-		}
-		if(found != -1) {
-			int to_copy = found + 1;
-			if(to_copy < buffer_size) {
-				_STRNCPY(buffer, buffer_size, serial->buffer, to_copy);
-				_STRNCPY(serial->buffer, serial->buffer_size, serial->buffer + to_copy, serial->offset - to_copy + 1);
-				serial->offset -= to_copy;
-				return to_copy;
-			}
-		}
-		to_read = _serial_window_count_read_bytes(port_handle);
-	}
-	return 0;
-}
-
-int _serial_write(const struct _serial* serial, const char* buffer, int buffer_size) {
-	if(serial == NULL) return 0;
-	if(serial->port_opened == 0) return 0;
-	return _serial_window_write_bytes(serial->port_handle, (const unsigned char*)buffer, buffer_size);
-}
-
-/*------------------------------
-  CONNECTOR
-------------------------------*/
-
-#define _CONNECTION_STATE_NONE 0
-#define _CONNECTION_STATE_CONNECTING 1
-#define _CONNECTION_STATE_CONNECTED 2
-#define _CONNECTION_STATE_CONNECTION_LOST 3
-#define _CONNECTION_STATE_DISCONNECTED 4
-#define _CONNECTION_STATE_DISPOSED 5
-#define _CONNECTION_RESULT_FOUND 1
-#define _CONNECTION_RESULT_NOT_CONNECTED 2
-#define _CONNECTION_RESULT_NOT_AVAILABLE 3
-
-#define _CONNECTOR_INFO_BUFFER_SIZE 20
-#define _CONNECTOR_BUFFER_SIZE 256
-#define _TIMEOUT 100 // milliseconds
-#define _RETRY 10
-
-#define _VALID_PACKET_LENGTH 54
-#define _MOTORING_PACKET_LENGTH 54
-#define _CR 13
-
-#define _DEFAULT_ADDRESS "000000000000"
-
-struct _connector;
-typedef int (*_CHECK_CONNECTION)(struct _connector* connector, struct _serial* serial);
-
-struct _connector {
-	struct _serial* serial;
-	char* tag;
-	int index;
-	int packet_length;
-	char delimiter;
-	char* address;
-	char* port_name;
-	int found;
-	int connected;
-	int checking_timeout;
-	double timestamp;
-	char* buffer;
-	_CHECK_CONNECTION check_connection;
-};
-
-struct _connector* _connector_create(const char* tag, int index, int packet_length, char delimiter);
-void _connector_dispose(struct _connector* connector);
-int _connector_open(struct _connector* connector, const char* port_name, int baud_rate, int flow_control);
-int _connector_check_port(struct _connector* connector, struct _serial* serial);
-int _connector_open_port(struct _connector* connector, const char* port_name, int baud_rate, int flow_control);
-void _connector_close(struct _connector* connector);
-int _connector_is_connected(const struct _connector* connector);
-const char* _connector_get_port_name(const struct _connector* connector);
-const char* _connector_get_address(const struct _connector* connector);
-void _connector_set_address(const struct _connector* connector, const char* address);
-void _connector_set_connection_state(struct _connector* connector, int state);
-int _connector_read_packet(const struct _connector* connector, struct _serial* serial, const char* start_bytes);
-void _connector_write(const struct _connector* connector, const char* buffer, int buffer_size);
-int _connector_read(struct _connector* _connector);
-void _connector_print_state(const struct _connector* connector, int state);
-void _connector_print_error(const struct _connector* connector, int error_code);
-
-double _get_timestamp(struct timeb* t) {
-	ftime(t);
-	return (double)t->time + (double)t->millitm / 1000.0;
-}
-
-struct _connector* _connector_create(const char* tag, int index, int packet_length, char delimiter) {
-	struct _connector* connector = (struct _connector*)malloc(sizeof(struct _connector));
-	
-	connector->serial = NULL;
-	connector->index = index;
-	connector->packet_length = packet_length;
-	connector->delimiter = delimiter;
-	
-	connector->tag = (char*)malloc(sizeof(char) * _CONNECTOR_INFO_BUFFER_SIZE);
-	connector->address = (char*)malloc(sizeof(char) * _CONNECTOR_INFO_BUFFER_SIZE);
-	connector->port_name = (char*)malloc(sizeof(char) * _CONNECTOR_INFO_BUFFER_SIZE);
-	_STRCPY(connector->tag, _CONNECTOR_INFO_BUFFER_SIZE, tag);
-	_STRCPY(connector->address, _CONNECTOR_INFO_BUFFER_SIZE, _DEFAULT_ADDRESS);
-	_STRCPY(connector->port_name, _CONNECTOR_INFO_BUFFER_SIZE, "");
-	
-	connector->found = 0;
-	connector->connected = 0;
-	connector->checking_timeout = 0;
-	connector->timestamp = 0;
-	
-	connector->buffer = (char*)malloc(sizeof(char) * _CONNECTOR_BUFFER_SIZE);
-	connector->check_connection = NULL;
-
-	return connector;
-}
-
-void _connector_dispose(struct _connector* connector) {
-	if(connector == NULL) return;
-
-	_connector_close(connector); // close serial
-	if(connector->tag != NULL) {
-		free(connector->tag);
-		connector->tag = NULL;
-	}
-	if(connector->address != NULL) {
-		free(connector->address);
-		connector->address = NULL;
-	}
-	if(connector->port_name != NULL) {
-		free(connector->port_name);
-		connector->port_name = NULL;
-	}
-	if(connector->buffer != NULL) {
-		free(connector->buffer);
-		connector->buffer = NULL;
-	}
-	connector->check_connection = NULL;
-	free(connector);
-}
-
-int _connector_open(struct _connector* connector, const char* port_name, int baud_rate, int flow_control) {
-	int result = _CONNECTION_RESULT_NOT_AVAILABLE;
-
-	if(connector == NULL) return _CONNECTION_RESULT_NOT_AVAILABLE;
-	if(port_name == NULL) {
-		int port_count = 0;
-		char** port_names = _serial_window_get_serial_port_names(NULL, &port_count);
-		if(port_count > 0 && port_names != NULL) {
-			int i;
-	
-			for(i = 0; i < port_count; ++i) {
-				result = _connector_open_port(connector, port_names[i], baud_rate, flow_control);
-				if(result != _CONNECTION_RESULT_NOT_AVAILABLE) {
-					break;
-				}
-			}
-			for(i = 0; i < port_count; ++i) {
-				free(port_names[i]);
-			}
-			free(port_names);
-		}
-	} else {
-		result = _connector_open_port(connector, port_name, baud_rate, flow_control);
-	}
-	if(result == _CONNECTION_RESULT_NOT_AVAILABLE) {
-		_connector_print_error(connector, result);
-	}
-	return result;
-}
-
-int _connector_check_port(struct _connector* connector, struct _serial* serial) {
-	int read_bytes1, read_bytes2;
-
-	_connector_read_packet(connector, serial, NULL);
-	read_bytes1 = _connector_read_packet(connector, serial, NULL);
-	read_bytes2 = _connector_read_packet(connector, serial, NULL);
-
-	if(read_bytes2 != 0) {
-		if(read_bytes2 == connector->packet_length) {
-			if(connector->check_connection != NULL) {
-				return connector->check_connection(connector, serial);
-			}
-		} else if(read_bytes1 != 0 && read_bytes2 == 2) {
-			_connector_print_error(connector, _CONNECTION_RESULT_NOT_CONNECTED);
-			return _CONNECTION_RESULT_NOT_CONNECTED;
-		}
-	}
-	return _CONNECTION_RESULT_NOT_AVAILABLE;
-}
-
-int _connector_open_port(struct _connector* connector, const char* port_name, int baud_rate, int flow_control) {
-	struct _serial* serial = _serial_create();
-	if(_serial_open(serial, port_name, baud_rate, flow_control) == 1) {
-		int result;
-		
-		_serial_clear(serial);
-		_STRCPY(connector->port_name, _CONNECTOR_INFO_BUFFER_SIZE, port_name);
-		
-		result = _connector_check_port(connector, serial);
-		if(result != _CONNECTION_RESULT_NOT_AVAILABLE) {
-			connector->serial = serial;
-			return result;
-		}
-		_serial_close(serial);
-	}
-	_serial_dispose(serial);
-	serial = NULL;
-	
-	return _CONNECTION_RESULT_NOT_AVAILABLE;
-}
-
-void _connector_close(struct _connector* connector) {
-	if(connector == NULL) return;
-	if(connector->serial != NULL) {
-		_serial_dispose(connector->serial);
-		connector->serial = NULL;
-	}
-	connector->connected = 0;
-	_connector_print_state(connector, _CONNECTION_STATE_DISPOSED);
-}
-
-int _connector_is_connected(const struct _connector* connector) {
-	if(connector == NULL) return 0;
-	return connector->connected;
-}
-
-const char* _connector_get_port_name(const struct _connector* connector) {
-	if(connector == NULL) return "";
-	return connector->port_name;
-}
-
-const char* _connector_get_address(const struct _connector* connector) {
-	if(connector == NULL) return _DEFAULT_ADDRESS;
-	return connector->address;
-}
-
-void _connector_set_address(const struct _connector* connector, const char* address) {
-	if(connector == NULL) return;
-	_STRCPY(connector->address, _CONNECTOR_INFO_BUFFER_SIZE, address);
-}
-
-void _connector_set_connection_state(struct _connector* connector, int state) {
-	if(connector == NULL) return;
-	connector->connected = (state == _CONNECTION_STATE_CONNECTED) ? 1 : 0;
-	if(connector->found == 0 && connector->connected == 1) {
-		connector->found = 1;
-	}
-	if(connector->found == 1) {
-		_connector_print_state(connector, state);
-	}
-}
-
-int _connector_read_packet(const struct _connector* connector, struct _serial* serial, const char* start_bytes) {
-	if(connector != NULL) {
-		char* buffer = connector->buffer;
-		int read_bytes = 0, i;
-
-		for(i = 0; i < _RETRY; ++i) {
-			Sleep(10);
-			if((read_bytes = _serial_read_string_until(serial, buffer, _CONNECTOR_BUFFER_SIZE, connector->delimiter)) != 0) {
-				if(start_bytes == NULL) {
-					return read_bytes;
-				}
-				if(buffer[0] == start_bytes[0] && buffer[1] == start_bytes[1]) {
-					return read_bytes;
-				}
-			}
-		}
-	}
-	return 0;
-}
-
-void _connector_write(const struct _connector* connector, const char* buffer, int buffer_size) {
-	if(connector == NULL || connector->serial == NULL) return;
-	_serial_write(connector->serial, buffer, buffer_size);
-}
-
-int _connector_read(struct _connector* connector) {
-	int read_bytes;
-
-	if(connector == NULL || connector->serial == NULL) return 0;
-	read_bytes = _serial_read_string_until(connector->serial, connector->buffer, _CONNECTOR_BUFFER_SIZE, connector->delimiter);
-	if(read_bytes == connector->packet_length) {
-		if(connector->found == 0) {
-			if(connector->check_connection != NULL) {
-				connector->check_connection(connector, connector->serial);
-			}
-		} else if(connector->connected == 0) {
-			_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTED);
-		}
-		connector->checking_timeout = 0;
-		connector->timestamp = 0;
-		return read_bytes;
-	} else if(connector->connected == 1) {
-		struct timeb time;
-		double t;
-
-		t = _get_timestamp(&time);
-		if(connector->checking_timeout == 0) {
-			connector->checking_timeout = 1;
-			connector->timestamp = t;
-		} else if(t - connector->timestamp > _TIMEOUT) {
-			_serial_clear(connector->serial);
-			_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTION_LOST);
-		}
-	}
-	return 0;
-}
-
-void _connector_print_state(const struct _connector* connector, int state) {
-	switch(state) {
-		case _CONNECTION_STATE_CONNECTED:
-			printf("%s[%d] Connected: %s\n", connector->tag, connector->index, connector->port_name);
-			break;
-		case _CONNECTION_STATE_CONNECTION_LOST:
-			printf("%s[%d] Connection lost\n", connector->tag, connector->index);
-			break;
-		case _CONNECTION_STATE_DISCONNECTED:
-			printf("%s[%d] Disconnected\n", connector->tag, connector->index);
-			break;
-		case _CONNECTION_STATE_DISPOSED:
-			printf("%s[%d] Disposed\n", connector->tag, connector->index);
-			break;
-	}
-}
-
-void _connector_print_error(const struct _connector* connector, int error_code) {
-	switch(error_code) {
-		case _CONNECTION_RESULT_NOT_AVAILABLE:
-			printf("%s[%d] No available USB to BLE bridge\n", connector->tag, connector->index);
-			break;
-		case _CONNECTION_RESULT_NOT_CONNECTED:
-			printf("%s[%d] Not connected\n", connector->tag, connector->index);
-			break;
-	}
-}
-
-/*------------------------------
-  DEVICE
-------------------------------*/
-
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
-
-struct _device {
-	char* name;
-	int id;
-	int device_type;
-	int data_type;
-	int data_size;
-	int data_len;
-	void* data;
-	float min_value;
-	float max_value;
-	float initial_value;
-	int event;
-	int fired;
-	int written;
-	void (*reset)(struct _device* device);
-	int (*read)(const struct _device* device);
-	int (*read_at)(const struct _device* device, int index);
-	int (*read_array)(const struct _device* device, int* data, int length);
-	float (*read_float)(const struct _device* device);
-	float (*read_float_at)(const struct _device* device, int index);
-	int (*read_float_array)(const struct _device* device, float* data, int length);
-	int (*write)(struct _device* device, int data);
-	int (*write_at)(struct _device* device, int index, int data);
-	int (*write_array)(struct _device* device, const int* data, int length);
-	int (*write_float)(struct _device* device, float data);
-	int (*write_float_at)(struct _device* device, int index, float data);
-	int (*write_float_array)(struct _device* device, const float* data, int length);
-	int (*put)(struct _device* device, int data);
-	int (*put_at)(struct _device* device, int index, int data);
-	int (*put_array)(struct _device* device, const int* data, int length);
-	int (*put_float)(struct _device* device, float data);
-	int (*put_float_at)(struct _device* device, int index, float data);
-	int (*put_float_array)(struct _device* device, const float* data, int length);
-};
-
-struct _device* _device_create(int id, const char* name, int device_type, int data_type, int data_size, float min_value, float max_value, float initial_value);
-void _device_dispose(struct _device* device);
-const char* _device_get_name(const struct _device* device);
-void _device_set_name(struct _device* device, const char* name);
-int _device_get_id(const struct _device* device);
-int _device_get_device_type(const struct _device* device);
-int _device_get_data_type(const struct _device* device);
-int _device_get_data_size(const struct _device* device);
-int _device_e(const struct _device* device);
-void _device_reset(struct _device* device);
-int _device_read(const struct _device* device);
-int _device_read_at(const struct _device* device, int index);
-int _device_read_array(const struct _device* device, int* data, int length);
-float _device_read_float(const struct _device* device);
-float _device_read_float_at(const struct _device* device, int index);
-int _device_read_float_array(const struct _device* device, float* data, int length);
-int _device_write(struct _device* device, int data);
-int _device_write_at(struct _device* device, int index, int data);
-int _device_write_array(struct _device* device, const int* data, int length);
-int _device_write_float(struct _device* device, float data);
-int _device_write_float_at(struct _device* device, int index, float data);
-int _device_write_float_array(struct _device* device, const float* data, int length);
-int _device_put(struct _device* device, int data);
-int _device_put_at(struct _device* device, int index, int data);
-int _device_put_array(struct _device* device, const int* data, int length);
-int _device_put_float(struct _device* device, float data);
-int _device_put_float_at(struct _device* device, int index, float data);
-int _device_put_float_array(struct _device* device, const float* data, int length);
-void _device_update_device_state(struct _device* device);
-
-void _int_device_reset(struct _device* device) {
-	int* this_data = (int*)device->data;
-	
-	if(this_data != NULL) {
-		int this_len = device->data_len, i;
-		int initial_value = (int)device->initial_value;
-		
-		for(i = 0; i < this_len; ++i) {
-			this_data[i] = initial_value;
-		}
-	}
-	device->event = 0;
-	device->fired = 0;
-	device->written = 0;
-}
-
-int _int_device_read(const struct _device* device) {
-	int* this_data;
-	
-	if(device->data_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	return this_data[0];
-}
-
-int _int_device_read_at(const struct _device* device, int index) {
-	int* this_data;
-
-	if(index < 0 || index >= device->data_len) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	return this_data[index];
-}
-
-int _int_device_read_array(const struct _device* device, int* data, int length) {
-	int* this_data;
-	int this_len, len;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	memcpy(data, this_data, sizeof(int) * len);
-	return len;
-}
-
-float _int_device_read_float(const struct _device* device) {
-	return (float)_int_device_read(device);
-}
-
-float _int_device_read_float_at(const struct _device* device, int index) {
-	return (float)_int_device_read_at(device, index);
-}
-
-int _int_device_read_float_array(const struct _device* device, float* data, int length) {
-	int* this_data;
-	int this_len, len, i;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	for(i = 0; i < len; ++i) {
-		data[i] = (float)this_data[i];
-	}
-	return len;
-}
-
-int _int_device_write(struct _device* device, int data) {
-	int* this_data;
-	int min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(device->data_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	min_value = (int)device->min_value;
-	max_value = (int)device->max_value;
-	if(data < min_value) data = min_value;
-	else if(data > max_value) data = max_value;
-	
-	this_data[0] = data;
-	device->fired = 1;
-	device->written = 1;
-	return 1;
-}
-
-int _int_device_write_at(struct _device* device, int index, int data) {
-	int* this_data;
-	int min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(index < 0 || index >= device->data_len) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	min_value = (int)device->min_value;
-	max_value = (int)device->max_value;
-	if(data < min_value) data = min_value;
-	else if(data > max_value) data = max_value;
-	
-	this_data[index] = data;
-	device->fired = 1;
-	device->written = 1;
-	return 1;
-}
-
-int _int_device_write_array(struct _device* device, const int* data, int length) {
-	int* this_data;
-	int this_len, len, i;
-	int value, min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	min_value = (int)device->min_value;
-	max_value = (int)device->max_value;
-	for(i = 0; i < len; ++i) {
-		value = data[i];
-		if(value < min_value) value = min_value;
-		else if(value > max_value) value = max_value;
-		this_data[i] = value;
-	}
-	device->fired = 1;
-	device->written = 1;
-	return len;
-}
-
-int _int_device_write_float(struct _device* device, float data) {
-	return _int_device_write(device, (int)data);
-}
-
-int _int_device_write_float_at(struct _device* device, int index, float data) {
-	return _int_device_write_at(device, index, (int)data);
-}
-
-int _int_device_write_float_array(struct _device* device, const float* data, int length) {
-	int* this_data;
-	int this_len, len, i;
-	int value, min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	min_value = (int)device->min_value;
-	max_value = (int)device->max_value;
-	for(i = 0; i < len; ++i) {
-		value = (int)data[i];
-		if(value < min_value) value = min_value;
-		else if(value > max_value) value = max_value;
-		this_data[i] = value;
-	}
-	device->fired = 1;
-	device->written = 1;
-	return len;
-}
-
-int _int_device_put(struct _device* device, int data) {
-	int* this_data;
-
-	if(device->data_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	this_data[0] = data;
-	device->fired = 1;
-	return 1;
-}
-
-int _int_device_put_at(struct _device* device, int index, int data) {
-	int* this_data;
-
-	if(index < 0 || index >= device->data_len) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	this_data[index] = data;
-	device->fired = 1;
-	return 1;
-}
-
-int _int_device_put_array(struct _device* device, const int* data, int length) {
-	int* this_data;
-	int this_len, len;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	memcpy(this_data, data, sizeof(int) * len);
-	device->fired = 1;
-	return len;
-}
-
-int _int_device_put_float(struct _device* device, float data) {
-	return _int_device_put(device, (int)data);
-}
-
-int _int_device_put_float_at(struct _device* device, int index, float data) {
-	return _int_device_put_at(device, index, (int)data);
-}
-
-int _int_device_put_float_array(struct _device* device, const float* data, int length) {
-	int* this_data;
-	int this_len, len, i;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (int*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	for(i = 0; i < len; ++i) {
-		this_data[i] = (int)data[i];
-	}
-	device->fired = 1;
-	return len;
-}
-
-void _float_device_reset(struct _device* device) {
-	float* this_data = (float*)device->data;
-	
-	if(this_data != NULL) {
-		int this_len = device->data_len, i;
-		float initial_value = device->initial_value;
-		
-		for(i = 0; i < this_len; ++i) {
-			this_data[i] = initial_value;
-		}
-	}
-	device->event = 0;
-	device->fired = 0;
-	device->written = 0;
-}
-
-int _float_device_read_array(const struct _device* device, int* data, int length) {
-	float* this_data;
-	int this_len, len, i;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	for(i = 0; i < len; ++i) {
-		data[i] = (int)this_data[i];
-	}
-	return len;
-}
-
-float _float_device_read_float(const struct _device* device) {
-	float* this_data;
-
-	if(device->data_len <= 0) return 0.0f;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0.0f;
-	
-	return this_data[0];
-}
-
-float _float_device_read_float_at(const struct _device* device, int index) {
-	float* this_data;
-
-	if(index < 0 || index >= device->data_len) return 0.0f;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0.0f;
-	
-	return this_data[index];
-}
-
-int _float_device_read(const struct _device* device) {
-	return (int)_float_device_read_float(device);
-}
-
-int _float_device_read_at(const struct _device* device, int index) {
-	return (int)_float_device_read_float_at(device, index);
-}
-
-int _float_device_read_float_array(const struct _device* device, float* data, int length) {
-	float* this_data;
-	int this_len, len;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	memcpy(data, this_data, sizeof(float) * len);
-	return len;
-}
-
-int _float_device_write_array(struct _device* device, const int* data, int length) {
-	float* this_data;
-	int this_len, len, i;
-	float value, min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	min_value = device->min_value;
-	max_value = device->max_value;
-	for(i = 0; i < len; ++i) {
-		value = (float)data[i];
-		if(value < min_value) value = min_value;
-		else if(value > max_value) value = max_value;
-		this_data[i] = value;
-	}
-	device->fired = 1;
-	device->written = 1;
-	return len;
-}
-
-int _float_device_write_float(struct _device* device, float data) {
-	float* this_data;
-	float min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(device->data_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	min_value = device->min_value;
-	max_value = device->max_value;
-	if(data < min_value) data = min_value;
-	else if(data > max_value) data = max_value;
-	
-	this_data[0] = data;
-	device->fired = 1;
-	device->written = 1;
-	return 1;
-}
-
-int _float_device_write_float_at(struct _device* device, int index, float data) {
-	float* this_data;
-	float min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(index < 0 || index >= device->data_len) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	min_value = device->min_value;
-	max_value = device->max_value;
-	if(data < min_value) data = min_value;
-	else if(data > max_value) data = max_value;
-	
-	this_data[index] = data;
-	device->fired = 1;
-	device->written = 1;
-	return 1;
-}
-
-int _float_device_write(struct _device* device, int data) {
-	return _float_device_write_float(device, (float)data);
-}
-
-int _float_device_write_at(struct _device* device, int index, int data) {
-	return _float_device_write_float_at(device, index, (float)data);
-}
-
-int _float_device_write_float_array(struct _device* device, const float* data, int length) {
-	float* this_data;
-	int this_len, len, i;
-	float value, min_value, max_value;
-
-	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	min_value = device->min_value;
-	max_value = device->max_value;
-	for(i = 0; i < len; ++i) {
-		value = data[i];
-		if(value < min_value) value = min_value;
-		else if(value > max_value) value = max_value;
-		this_data[i] = value;
-	}
-	device->fired = 1;
-	device->written = 1;
-	return len;
-}
-
-int _float_device_put_array(struct _device* device, const int* data, int length) {
-	float* this_data;
-	int this_len, len, i;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	for(i = 0; i < len; ++i) {
-		this_data[i] = (float)data[i];
-	}
-	device->fired = 1;
-	return len;
-}
-
-int _float_device_put_float(struct _device* device, float data) {
-	float* this_data;
-
-	if(device->data_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	this_data[0] = data;
-	device->fired = 1;
-	return 1;
-}
-
-int _float_device_put_float_at(struct _device* device, int index, float data) {
-	float* this_data;
-
-	if(index < 0 || index >= device->data_len) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	this_data[index] = data;
-	device->fired = 1;
-	return 1;
-}
-
-int _float_device_put(struct _device* device, int data) {
-	return _float_device_put_float(device, (float)data);
-}
-
-int _float_device_put_at(struct _device* device, int index, int data) {
-	return _float_device_put_float_at(device, index, (float)data);
-}
-
-int _float_device_put_float_array(struct _device* device, const float* data, int length) {
-	float* this_data;
-	int this_len, len;
-
-	if(data == NULL) return 0;
-	if(length <= 0) return 0;
-	
-	this_len = device->data_len;
-	if(this_len <= 0) return 0;
-	this_data = (float*)device->data;
-	if(this_data == NULL) return 0;
-	
-	len = MIN(this_len, length);
-	memcpy(this_data, data, sizeof(float) * len);
-	device->fired = 1;
-	return len;
-}
-
-struct _device* _device_create(int id, const char* name, int device_type, int data_type, int data_size, float min_value, float max_value, float initial_value) {
-	if(data_type == DATA_TYPE_INTEGER || data_type == DATA_TYPE_FLOAT) {
-		struct _device* device = (struct _device*)malloc(sizeof(struct _device));
-		int len;
-
-		if(name == NULL) name = "";
-		len = strlen(name) + 1;
-		device->name = (char*)malloc(sizeof(char) * len);
-		_STRCPY(device->name, len, name);
-
-		device->id = id & 0xfff00fff;
-		device->device_type = device_type;
-		device->data_type = data_type;
-		device->data_size = data_size;
-		device->data_len = 0;
-		device->data = NULL;
-		device->min_value = min_value;
-		device->max_value = max_value;
-		device->initial_value = initial_value;
-		device->event = 0;
-		device->fired = 0;
-		device->written = 0;
-
-		if(data_type == DATA_TYPE_INTEGER) {
-			device->reset = _int_device_reset;
-			device->read = _int_device_read;
-			device->read_at = _int_device_read_at;
-			device->read_array = _int_device_read_array;
-			device->read_float = _int_device_read_float;
-			device->read_float_at = _int_device_read_float_at;
-			device->read_float_array = _int_device_read_float_array;
-			device->write = _int_device_write;
-			device->write_at = _int_device_write_at;
-			device->write_array = _int_device_write_array;
-			device->write_float = _int_device_write_float;
-			device->write_float_at = _int_device_write_float_at;
-			device->write_float_array = _int_device_write_float_array;
-			device->put = _int_device_put;
-			device->put_at = _int_device_put_at;
-			device->put_array = _int_device_put_array;
-			device->put_float = _int_device_put_float;
-			device->put_float_at = _int_device_put_float_at;
-			device->put_float_array = _int_device_put_float_array;
-		
-			if(data_size > 0) {
-				int* data;
-				int i;
-
-				data = (int*)malloc(sizeof(int) * data_size);
-				for(i = 0; i < data_size; ++i) {
-					data[i] = (int)initial_value;
-				}
-				device->data = data;
-				device->data_len = data_size;
-			}
-		} else if(data_type == DATA_TYPE_FLOAT) {
-			device->reset = _float_device_reset;
-			device->read = _float_device_read;
-			device->read_at = _float_device_read_at;
-			device->read_array = _float_device_read_array;
-			device->read_float = _float_device_read_float;
-			device->read_float_at = _float_device_read_float_at;
-			device->read_float_array = _float_device_read_float_array;
-			device->write = _float_device_write;
-			device->write_at = _float_device_write_at;
-			device->write_array = _float_device_write_array;
-			device->write_float = _float_device_write_float;
-			device->write_float_at = _float_device_write_float_at;
-			device->write_float_array = _float_device_write_float_array;
-			device->put = _float_device_put;
-			device->put_at = _float_device_put_at;
-			device->put_array = _float_device_put_array;
-			device->put_float = _float_device_put_float;
-			device->put_float_at = _float_device_put_float_at;
-			device->put_float_array = _float_device_put_float_array;
-		
-			if(data_size > 0) {
-				float* data;
-				int i;
-
-				data = (float*)malloc(sizeof(float) * data_size);
-				for(i = 0; i < data_size; ++i) {
-					data[i] = initial_value;
-				}
-				device->data = data;
-				device->data_len = data_size;
-			}
-		}
-		return device;
-	}
-	return NULL;
-}
-
-void _device_dispose(struct _device* device) {
-	if(device == NULL) return;
-	
-	if(device->name != NULL) {
-		free(device->name);
-		device->name = NULL;
-	}
-	if(device->data_type == DATA_TYPE_INTEGER) {
-		int* data = (int*)device->data;
-		if(data != NULL) {
-			free(data);
-			device->data = NULL;
-		}
-	} else if(device->data_type == DATA_TYPE_FLOAT) {
-		float* data = (float*)device->data;
-		if(data != NULL) {
-			free(data);
-			device->data = NULL;
-		}
-	}
-	free(device);
-}
-
-const char* _device_get_name(const struct _device* device) {
-	if(device == NULL) return "";
-	return device->name;
-}
-
-void _device_set_name(struct _device* device, const char* name) {
-	int len;
-
-	if(device == NULL) return;
-	if(name == NULL) name = "";
-	if(device->name != NULL) {
-		free(device->name);
-	}
-	len = strlen(name) + 1;
-	device->name = (char*)malloc(sizeof(char) * len);
-	_STRCPY(device->name, len, name);
-}
-
-int _device_get_id(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->id;
-}
-
-int _device_get_device_type(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->device_type;
-}
-
-int _device_get_data_type(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->data_type;
-}
-
-int _device_get_data_size(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->data_size;
-}
-
-int _device_e(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->event;
-}
-
-void _device_reset(struct _device* device) {
-	if(device == NULL) return;
-	device->reset(device);
-}
-
-int _device_read(const struct _device* device) {
-	if(device == NULL) return 0;
-	return device->read(device);
-}
-
-int _device_read_at(const struct _device* device, int index) {
-	if(device == NULL) return 0;
-	return device->read_at(device, index);
-}
-
-int _device_read_array(const struct _device* device, int* data, int length) {
-	if(device == NULL) return 0;
-	return device->read_array(device, data, length);
-}
-
-float _device_read_float(const struct _device* device) {
-	if(device == NULL) return 0.0f;
-	return device->read_float(device);
-}
-
-float _device_read_float_at(const struct _device* device, int index) {
-	if(device == NULL) return 0.0f;
-	return device->read_float_at(device, index);
-}
-
-int _device_read_float_array(const struct _device* device, float* data, int length) {
-	if(device == NULL) return 0;
-	return device->read_float_array(device, data, length);
-}
-
-int _device_write(struct _device* device, int data) {
-	if(device == NULL) return 0;
-	return device->write(device, data);
-}
-
-int _device_write_at(struct _device* device, int index, int data) {
-	if(device == NULL) return 0;
-	return device->write_at(device, index, data);
-}
-
-int _device_write_array(struct _device* device, const int* data, int length) {
-	if(device == NULL) return 0;
-	return device->write_array(device, data, length);
-}
-
-int _device_write_float(struct _device* device, float data) {
-	if(device == NULL) return 0;
-	return device->write_float(device, data);
-}
-
-int _device_write_float_at(struct _device* device, int index, float data) {
-	if(device == NULL) return 0;
-	return device->write_float_at(device, index, data);
-}
-
-int _device_write_float_array(struct _device* device, const float* data, int length) {
-	if(device == NULL) return 0;
-	return device->write_float_array(device, data, length);
-}
-
-int _device_put(struct _device* device, int data) {
-	if(device == NULL) return 0;
-	return device->put(device, data);
-}
-
-int _device_put_at(struct _device* device, int index, int data) {
-	if(device == NULL) return 0;
-	return device->put_at(device, index, data);
-}
-
-int _device_put_array(struct _device* device, const int* data, int length) {
-	if(device == NULL) return 0;
-	return device->put_array(device, data, length);
-}
-
-int _device_put_float(struct _device* device, float data) {
-	if(device == NULL) return 0;
-	return device->put_float(device, data);
-}
-
-int _device_put_float_at(struct _device* device, int index, float data) {
-	if(device == NULL) return 0;
-	return device->put_float_at(device, index, data);
-}
-
-int _device_put_float_array(struct _device* device, const float* data, int length) {
-	if(device == NULL) return 0;
-	return device->put_float_array(device, data, length);
-}
-
-void _device_update_device_state(struct _device* device) {
-	if(device == NULL) return;
-	device->event = device->fired;
-	device->fired = 0;
-}
-
-/*------------------------------
-  UTIL
-------------------------------*/
-
-int _hex_char_to_value(char character);
-int _value_to_hex(char* buffer, int index, int value, int bytes);
-int _hex_to_value(const char* str, int start, int end);
-
-char _HEX_DIGITS[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-
-int _hex_char_to_value(char character) {
-	switch(character) {
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-			return (int)(character - '0');
-		case 'a':
-		case 'b':
-		case 'c':
-		case 'd':
-		case 'e':
-		case 'f':
-			return (int)(character - 'a' + 10);
-		case 'A':
-		case 'B':
-		case 'C':
-		case 'D':
-		case 'E':
-		case 'F':
-			return (int)(character - 'A' + 10);
-	}
-	return ' ';
-}
-
-int _value_to_hex(char* buffer, int index, int value, int bytes) {
-	int high, low, val, i;
-
-	for(i = 0; i < bytes; ++i) {
-		val = value >> ((bytes - i - 1) * 8);
-		high = (val >> 4) & 0xf;
-		low = val & 0xf;
-		buffer[index++] = _HEX_DIGITS[high];
-		buffer[index++] = _HEX_DIGITS[low];
-	}
-	return index;
-}
-
-int _hex_to_value(const char* str, int start, int end) {
-	int result = 0, i;
-
-	for(i = start; i < end; ++i) {
-		result <<= 4;
-		result += _hex_char_to_value(str[i]);
-	}
-	return result;
-}
-
-/*------------------------------
-  ROBOT
-------------------------------*/
-
-struct _robot;
-typedef void (*_REQUEST_MOTORING_DATA)(struct _robot* robot);
-typedef void (*_UPDATE_SENSORY_DEVICE_STATE)(struct _robot* robot);
-typedef void (*_UPDATE_MOTORING_DEVICE_STATE)(struct _robot* robot);
-typedef void (*_RESET)(struct _robot* robot);
-typedef void (*_DISPOSE)(struct _robot* robot);
-
-struct _robot {
-	int index;
-	char* name;
-	char* write_buffer;
-	int devices_size;
-	struct _device** devices;
-	struct _connector* connector;
-	int alive;
-	int running;
-	int ready;
-	int thread_alive;
-	HANDLE thread_handle;
-	_REQUEST_MOTORING_DATA request_motoring_data;
-	_UPDATE_SENSORY_DEVICE_STATE update_sensory_device_state;
-	_UPDATE_MOTORING_DEVICE_STATE update_motoring_device_state;
-	_RESET reset;
-	_DISPOSE dispose;
-};
-
-void _robot_init(struct _robot* robot, int index, const char* name, int write_buffer_size) {
-	if(robot != NULL) {
-		int len;
-		robot->index = index;
-		if(name == NULL) name = "";
-		len = strlen(name) + 1;
-		robot->name = (char*)malloc(sizeof(char) * len);
-		_STRCPY(robot->name, len, name);
-		robot->write_buffer = (char*)malloc(sizeof(char) * write_buffer_size);
-		robot->alive = 0;
-		robot->running = 0;
-		robot->ready = 0;
-		robot->thread_alive = 0;
-		robot->thread_handle = 0;
-	}
-}
-
-void _robot_dispose(struct _robot* robot) {
-	if(robot != NULL) {
-		struct _device** devices = robot->devices;
-		int size = robot->devices_size, i;
-
-		if(robot->connector != NULL) {
-			_connector_dispose(robot->connector);
-			robot->connector = NULL;
-		}
-		if(robot->name != NULL) {
-			free(robot->name);
-			robot->name = NULL;
-		}
-		if(robot->write_buffer != NULL) {
-			free(robot->write_buffer);
-			robot->write_buffer = NULL;
-		}
-		for(i = 0; i < size; ++i) {
-			_device_dispose(devices[i]);
-			devices[i] = NULL;
-		}
-		free(devices);
-		robot->devices = NULL;
-		robot->devices_size = 0;
-	}
-}
-
-const char* _robot_get_name(struct _robot* robot) {
-	if(robot == NULL) return "";
-	return robot->name;
-}
-
-void _robot_set_name(struct _robot* robot, const char* name) {
-	if(robot != NULL) {
-		int len;
-		if(robot->name != NULL) {
-			free(robot->name);
-		}
-		if(name == NULL) name = "";
-		len = strlen(name) + 1;
-		robot->name = (char*)malloc(sizeof(char) * len);
-		_STRCPY(robot->name, len, name);
-	}
-}
-
-int _robot_get_index(struct _robot* robot) {
-	if(robot == NULL) return 0;
-	return robot->index;
-}
-
-void _robot_reset(struct _robot* robot) {
-	if(robot != NULL) {
-		struct _device** devices = robot->devices;
-		int size = robot->devices_size, i;
-		for(i = 0; i < size; ++i) {
-			_device_reset(devices[i]);
-		}
-	}
-}
-
-void _robot_clear_written(struct _robot* robot) {
-	if(robot != NULL) {
-		struct _device** devices = robot->devices;
-		int size = robot->devices_size, i;
-		for(i = 0; i < size; ++i) {
-			devices[i]->written = 0;
-		}
-	}
-}
-
-struct _device* _robot_find_device(struct _robot* robot, int device_id) {
-	if(robot == NULL) return NULL;
-	if(robot->devices == NULL) return NULL;
-	return robot->devices[device_id & 0xffff];
-}
-
-int _robot_e(struct _robot* robot, int device_id) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_e(device);
-}
-
-int _robot_read(struct _robot* robot, int device_id) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read(device);
-}
-
-int _robot_read_at(struct _robot* robot, int device_id, int index) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read_at(device, index);
-}
-
-int _robot_read_array(struct _robot* robot, int device_id, int* data, int length) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read_array(device, data, length);
-}
-
-float _robot_read_float(struct _robot* robot, int device_id) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read_float(device);
-}
-
-float _robot_read_float_at(struct _robot* robot, int device_id, int index) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read_float_at(device, index);
-}
-
-int _robot_read_float_array(struct _robot* robot, int device_id, float* data, int length) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_read_float_array(device, data, length);
-}
-
-int _robot_write(struct _robot* robot, int device_id, int data) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write(device, data);
-}
-
-int _robot_write_at(struct _robot* robot, int device_id, int index, int data) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write_at(device, index, data);
-}
-
-int _robot_write_array(struct _robot* robot, int device_id, const int* data, int length) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write_array(device, data, length);
-}
-
-int _robot_write_float(struct _robot* robot, int device_id, float data) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write_float(device, data);
-}
-
-int _robot_write_float_at(struct _robot* robot, int device_id, int index, float data) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write_float_at(device, index, data);
-}
-
-int _robot_write_float_array(struct _robot* robot, int device_id, const float* data, int length) {
-	struct _device* device = _robot_find_device(robot, device_id);
-	return _device_write_float_array(device, data, length);
-}
-
-#define _NUM_ROBOT_GROUPS 1
-
-struct _robot_group {
-	int robots_size;
-	int robots_count;
-	struct _robot** robots;
-};
-
-struct _robot_group** _robot_groups = NULL;
-
-void _robot_group_dispose_all(void) {
-	if(_robot_groups != NULL) {
-		struct _robot_group* group;
-		int i;
-		for(i = 0; i < _NUM_ROBOT_GROUPS; ++i) {
-			group = _robot_groups[i];
-			if(group != NULL) {
-				if(group->robots != NULL) {
-					free(group->robots);
-					group->robots = NULL;
-				}
-				free(group);
-				_robot_groups[i] = NULL;
-			}
-		}
-		free(_robot_groups);
-		_robot_groups = NULL;
-	}
-}
-
-struct _robot_group* _robot_group_get(int group_index) {
-	struct _robot_group* group;
-	
-	if(group_index < 0 || group_index >= _NUM_ROBOT_GROUPS) return NULL;
-	if(_robot_groups == NULL) {
-		int i;
-		_robot_groups = (struct _robot_group**)malloc(sizeof(struct _robot_group*) * _NUM_ROBOT_GROUPS);
-		for(i = 0; i < _NUM_ROBOT_GROUPS; ++i) {
-			_robot_groups[i] = NULL;
-		}
-	}
-	group = _robot_groups[group_index];
-	if(group == NULL) {
-		group = (struct _robot_group*)malloc(sizeof(struct _robot_group));
-		group->robots_size = 1;
-		group->robots_count = 0;
-		group->robots = (struct _robot**)malloc(sizeof(struct _robot*));
-		group->robots[0] = NULL;
-		_robot_groups[group_index] = group;
-	}
-	return group;
-}
-
-struct _robot* _robot_group_get_robot(int group_index, int robot_index) {
-	struct _robot_group* group = _robot_group_get(group_index);
-	if(group == NULL) return NULL;
-	if(robot_index < 0 || robot_index >= group->robots_count) return NULL;
-	return group->robots[robot_index];
-}
-
-void _robot_group_add_robot(int group_index, struct _robot* robot) {
-	if(robot != NULL) {
-		struct _robot_group* group = _robot_group_get(group_index);
-		if(group != NULL) {
-			if(group->robots_size <= group->robots_count) {
-				int size = group->robots_size * 2, i;
-				struct _robot** temp = (struct _robot**)malloc(sizeof(struct _robot*) * size);
-				for(i = 0; i < size; ++i) {
-					temp[i] = NULL;
-				}
-				memcpy(temp, group->robots, sizeof(struct _robot*) * group->robots_size);
-				free(group->robots);
-				group->robots = temp;
-				group->robots_size = size;
-			}
-			group->robots[group->robots_count] = robot;
-			group->robots_count ++;
-		}
-	}
-}
-
-void _robot_group_remove_robot(int group_index, struct _robot* robot) {
-	if(robot != NULL) {
-		struct _robot_group* group = _robot_group_get(group_index);
-		if(group == NULL) return;
-		if(robot->index < 0 || robot->index >= group->robots_size) return;
-		group->robots[robot->index] = NULL;
-	}
-}
-
-int _robot_group_count_robots(int group_index) {
-	struct _robot_group* group = _robot_group_get(group_index);
-	if(group == NULL) return 0;
-	return group->robots_count;
-}
-
-const char* _robot_group_get_name(int group_index, int robot_index) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_get_name(robot);
-}
-
-void _robot_group_set_name(int group_index, int robot_index, const char* name) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	_robot_set_name(robot, name);
-}
-
-void _robot_group_reset(int group_index, int robot_index) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	if(robot != NULL) {
-		robot->reset(robot);
-	}
-}
-
-void _robot_group_dispose(int group_index, int robot_index) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	if(robot != NULL) {
-		robot->alive = 0;
-		robot->reset(robot);
-		robot->dispose(robot);
-	}
-}
-
-int _robot_group_e(int group_index, int robot_index, int device_id) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_e(robot, device_id);
-}
-
-int _robot_group_read(int group_index, int robot_index, int device_id) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read(robot, device_id);
-}
-
-int _robot_group_read_at(int group_index, int robot_index, int device_id, int index) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read_at(robot, device_id, index);
-}
-
-int _robot_group_read_array(int group_index, int robot_index, int device_id, int* data, int length) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read_array(robot, device_id, data, length);
-}
-
-float _robot_group_read_float(int group_index, int robot_index, int device_id) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read_float(robot, device_id);
-}
-
-float _robot_group_read_float_at(int group_index, int robot_index, int device_id, int index) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read_float_at(robot, device_id, index);
-}
-
-int _robot_group_read_float_array(int group_index, int robot_index, int device_id, float* data, int length) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_read_float_array(robot, device_id, data, length);
-}
-
-int _robot_group_write(int group_index, int robot_index, int device_id, int data) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write(robot, device_id, data);
-}
-
-int _robot_group_write_at(int group_index, int robot_index, int device_id, int index, int data) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write_at(robot, device_id, index, data);
-}
-
-int _robot_group_write_array(int group_index, int robot_index, int device_id, const int* data, int length) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write_array(robot, device_id, data, length);
-}
-
-int _robot_group_write_float(int group_index, int robot_index, int device_id, float data) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write_float(robot, device_id, data);
-}
-
-int _robot_group_write_float_at(int group_index, int robot_index, int device_id, int index, float data) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write_float_at(robot, device_id, index, data);
-}
-
-int _robot_group_write_float_array(int group_index, int robot_index, int device_id, const float* data, int length) {
-	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
-	return _robot_write_float_array(robot, device_id, data, length);
-}
-
-/*------------------------------
-  RUNNER
-------------------------------*/
-
-typedef void (*_EXECUTE)(void* arg);
-typedef int (*_EVALUATE)(void* arg);
-
-struct _runner {
-	int started;
-	int connection_required;
-	int connection_checked;
-	int robots_count;
-	int robots_size;
-	struct _robot** robots;
-	_EXECUTE execute;
-	void* execute_arg;
-	_EVALUATE evaluate;
-	void* evaluate_arg;
-	int evaluate_result;
-	int running;
-	int thread_alive;
-	HANDLE thread_handle;
-};
-
-struct _runner* _runner = NULL;
-
-void _runner_create(void);
-void _runner_shutdown(void);
-void _runner_start(void);
-void _runner_register_required(void);
-void _runner_register_checked(void);
-int _runner_is_all_checked(void);
-void _runner_add_robot(struct _robot* robot);
-
-void _runner_create(void) {
-	if(_runner != NULL) return;
-	_runner = (struct _runner*)malloc(sizeof(struct _runner));
-	_runner->started = 0;
-	_runner->connection_required = 0;
-	_runner->connection_checked = 0;
-	_runner->robots_count = 0;
-	_runner->robots_size = 1;
-	_runner->robots = (struct _robot**)malloc(sizeof(struct _robot*));
-	_runner->robots[0] = NULL;
-	_runner->execute = NULL;
-	_runner->execute_arg = NULL;
-	_runner->evaluate = NULL;
-	_runner->evaluate_arg = NULL;
-	_runner->evaluate_result = 0;
-	_runner->running = 0;
-	_runner->thread_alive = 0;
-	_runner->thread_handle = 0;
-}
-
-void _runner_shutdown(void) {
-	if(_runner != NULL) {
-		struct _robot** robots = _runner->robots;
-		int count = _runner->robots_count, i;
-		struct _robot* robot;
-
-		if(robots != NULL) {
-			for(i = 0; i < count; ++i) {
-				robot = robots[i];
-				if(robot != NULL) {
-					robot->alive = 0;
-					robot->reset(robot);
-				}
-			}
-		}
-
-		_runner->running = 0;
-		if(_runner->thread_alive == 1) {
-			WaitForSingleObject(_runner->thread_handle, INFINITE);
-		}
-
-		if(robots != NULL) {
-			for(i = 0; i < count; ++i) {
-				robot = robots[i];
-				if(robot != NULL) {
-					robot->dispose(robot);
-					robots[i] = NULL;
-				}
-			}
-			free(robots);
-			_runner->robots = NULL;
-		}
-		free(_runner);
-		_runner = NULL;
-	}
-}
-
-unsigned WINAPI _runner_thread_proc(void* arg) {
-	struct _runner* runner = (struct _runner*)arg;
-	struct _robot** robots;
-	struct _robot* robot;
-	int count, i;
-	struct timeb time;
-	double target_time;
-
-	if(runner == NULL) return 0;
-	
-	runner->thread_alive = 1;
-	target_time = _get_timestamp(&time);
-	while(runner->running == 1) {
-		if(_get_timestamp(&time) > target_time) {
-			robots = runner->robots;
-			count = runner->robots_count;
-	
-			for(i = 0; i < count; ++i) {
-				robot = robots[i];
-				if(robot != NULL && robot->alive == 1) {
-					robot->update_sensory_device_state(robot);
-				}
-			}
-			
-			if(runner->evaluate != NULL) {
-				runner->evaluate_result = runner->evaluate(runner->evaluate_arg);
-				if(runner->evaluate_result == 1) {
-					runner->evaluate = NULL;
-				}
-			}
-			
-			if(runner->execute != NULL) {
-				runner->execute(runner->execute_arg);
-			}
-			
-			for(i = 0; i < count; ++i) {
-				robot = robots[i];
-				if(robot != NULL && robot->alive == 1) {
-					robot->request_motoring_data(robot);
-				}
-			}
-			for(i = 0; i < count; ++i) {
-				robot = robots[i];
-				if(robot != NULL && robot->alive == 1) {
-					robot->update_motoring_device_state(robot);
-				}
-			}
-			target_time += 0.02;
-		}
-		Sleep(5);
-	}
-	runner->thread_alive = 0;
-	return 0;
-}
-
-void _runner_signal_handler(int sig) {
-	dispose_all();
-	exit(1);
-}
-
-void _runner_start(void) {
-	if(_runner == NULL) return;
-	if(_runner->started == 0) {
-		unsigned int thread_id;
-		
-		_runner->started = 1;
-		_runner->running = 1;
-		signal(SIGINT, _runner_signal_handler);
-		_runner->thread_handle = (HANDLE)_beginthreadex(NULL,
-			0,
-			_runner_thread_proc,
-			_runner,
-			CREATE_SUSPENDED,
-			&thread_id);
-		if(_runner->thread_handle != 0) {
-			ResumeThread(_runner->thread_handle);
-		}
-	}
-}
-
-void _runner_register_required(void) {
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	_runner->connection_required ++;
-}
-
-void _runner_register_checked(void) {
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	_runner->connection_checked ++;
-}
-
-int _runner_is_all_checked(void) {
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	return (_runner->connection_checked >= _runner->connection_required) ? 1 : 0;
-}
-
-void _runner_add_robot(struct _robot* robot) {
-	if(robot == NULL) return;
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	if(_runner->robots_size <= _runner->robots_count) {
-		int size = _runner->robots_size * 2, i;
-		struct _robot** temp = (struct _robot**)malloc(sizeof(struct _robot*) * size);
-		for(i = 0; i < size; ++i) {
-			temp[i] = 0;
-		}
-		memcpy(temp, _runner->robots, sizeof(struct _robot*) * _runner->robots_size);
-		free(_runner->robots);
-		_runner->robots = temp;
-		_runner->robots_size = size;
-	}
-	_runner->robots[_runner->robots_count] = robot;
-	_runner->robots_count ++;
-}
-
-void _runner_remove_robot(struct _robot* robot) {
-	struct _robot** robots;
-	int count, i;
-	
-	if(robot == NULL) return;
-	if(_runner == NULL) return;
-	count = _runner->robots_count;
-	robots = _runner->robots;
-	for(i = 0; i < count; ++i) {
-		if(robots[i] == robot) {
-			robots[i] = NULL;
-		}
-	}
-}
-
-/*------------------------------
-  COMMON
-------------------------------*/
-
-void scan(void) {
-	int port_count = 0;
-	char** port_names;
-	
-	printf("Serial ports:\n");
-
-	port_names = _serial_window_get_serial_port_names(NULL, &port_count);
-	if(port_count > 0 && port_names != NULL) {
-		int i;
-		for(i = 0; i < port_count; ++i) {
-			printf("%s\n", port_names[i]);
-			free(port_names[i]);
-		}
-		free(port_names);
-	} else {
-		printf("No available serial port\n");
-	}
-}
-
-void set_executable(void (*execute)(void* arg), void* arg) {
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	_runner->execute_arg = arg;
-	_runner->execute = execute;
-}
-
-void wait(int milliseconds) {
-	if(milliseconds > 0) {
-		struct timeb time;
-		double timeout;
-		
-		timeout = _get_timestamp(&time) + (double)milliseconds / 1000.0;
-		while(1) {
-			if(_get_timestamp(&time) >= timeout) {
-				break;
-			}
-			Sleep(1);
-		}
-	}
-}
-
-void wait_until(int (*evaluate)(void* arg), void* arg) {
-	if(_runner == NULL) {
-		_runner_create();
-	}
-	_runner->evaluate_arg = arg;
-	_runner->evaluate_result = 0;
-	_runner->evaluate = evaluate;
-	while(_runner->evaluate_result == 0) {
-		Sleep(10);
-	}
-}
-
-void wait_until_ready(void) {
-	while(_runner_is_all_checked() == 0) {
-		Sleep(10);
-	}
-}
-
-void dispose_all(void) {
-	_runner_shutdown();
-	_robot_group_dispose_all();
-}
-
-/*------------------------------
-  HAMSTER
-------------------------------*/
-
-#define _HAMSTER_LEFT_WHEEL_INDEX 0
-#define _HAMSTER_RIGHT_WHEEL_INDEX 1
-#define _HAMSTER_BUZZER_INDEX 2
-#define _HAMSTER_OUTPUT_A_INDEX 3
-#define _HAMSTER_OUTPUT_B_INDEX 4
-#define _HAMSTER_TOPOLOGY_INDEX 5
-#define _HAMSTER_LEFT_LED_INDEX 6
-#define _HAMSTER_RIGHT_LED_INDEX 7
-#define _HAMSTER_NOTE_INDEX 8
-#define _HAMSTER_LINE_TRACER_MODE_INDEX 9
-#define _HAMSTER_LINE_TRACER_SPEED_INDEX 10
-#define _HAMSTER_IO_MODE_A_INDEX 11
-#define _HAMSTER_IO_MODE_B_INDEX 12
-#define _HAMSTER_CONFIG_PROXIMITY_INDEX 13
-#define _HAMSTER_CONFIG_GRAVITY_INDEX 14
-#define _HAMSTER_CONFIG_BAND_WIDTH_INDEX 15
-#define _HAMSTER_SIGNAL_STRENGTH_INDEX 16
-#define _HAMSTER_LEFT_PROXIMITY_INDEX 17
-#define _HAMSTER_RIGHT_PROXIMITY_INDEX 18
-#define _HAMSTER_LEFT_FLOOR_INDEX 19
-#define _HAMSTER_RIGHT_FLOOR_INDEX 20
-#define _HAMSTER_ACCELERATION_INDEX 21
-#define _HAMSTER_LIGHT_INDEX 22
-#define _HAMSTER_TEMPERATURE_INDEX 23
-#define _HAMSTER_INPUT_A_INDEX 24
-#define _HAMSTER_INPUT_B_INDEX 25
-#define _HAMSTER_LINE_TRACER_STATE_INDEX 26
-
-#define _GROUP_HAMSTER 0
-
-struct _hamster_robot {
-	struct _robot robot;
-	int left_wheel;
-	int right_wheel;
-	float buzzer;
-	int output_a;
-	int output_b;
-	int topology;
-	int left_led;
-	int right_led;
-	int note;
-	int line_tracer_mode;
-	int line_tracer_speed;
-	int io_mode_a;
-	int io_mode_b;
-	int config_proximity;
-	int config_gravity;
-	int config_band_width;
-	int light;
-	int temperature;
-	double bpm;
-	int line_tracer_mode_written;
-	int line_tracer_flag;
-	int line_tracer_state;
-	int line_tracer_event;
-	int board_count;
-	int board_state;
-};
-
-int _hamster_check_connection(struct _connector* connector, struct _serial* serial) {
-	int i, read_bytes;
-
-	for(i = 0; i < _RETRY; ++i) {
-		_serial_write(serial, "FF\r", 3);
-		read_bytes = _connector_read_packet(connector, serial, "FF");
-		if(read_bytes != 0) {
-			char tmp[5][256];
-			int index = 0, len;
-			char* buf;
-			char* comma;
-
-			buf = connector->buffer;
-			comma = strchr(buf, ',');
-			while(comma != NULL && index < 5) {
-				len = comma - buf;
-				_STRNCPY(tmp[index], 256, buf, len);
-				tmp[index][len] = '\0';
-				index ++;
-				buf = comma + 1;
-				comma = strchr(buf, ',');
-			}
-			if(index >= 4 && buf != NULL && strlen(buf) >= 12) {
-				if(_STRICMP(tmp[1], "Hamster") == 0 && _STRICMP(tmp[2], "04") == 0) {
-					buf[12] = '\0';
-					_connector_set_address(connector, buf);
-					_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTED);
-					return _CONNECTION_RESULT_FOUND;
-				}
-			}
-			return _CONNECTION_RESULT_NOT_AVAILABLE;
-		}
-	}
-	return _CONNECTION_RESULT_NOT_AVAILABLE;
-}
-
-void _hamster_request_motoring_data(struct _robot* robot) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	struct _device** devices = robot->devices;
-	
-	hamster->left_wheel = _device_read(devices[_HAMSTER_LEFT_WHEEL_INDEX]);
-	hamster->right_wheel = _device_read(devices[_HAMSTER_RIGHT_WHEEL_INDEX]);
-	hamster->buzzer = _device_read_float(devices[_HAMSTER_BUZZER_INDEX]);
-	hamster->output_a = _device_read(devices[_HAMSTER_OUTPUT_A_INDEX]);
-	hamster->output_b = _device_read(devices[_HAMSTER_OUTPUT_B_INDEX]);
-	if(devices[_HAMSTER_TOPOLOGY_INDEX]->written == 1) {
-		hamster->topology = _device_read(devices[_HAMSTER_TOPOLOGY_INDEX]);
-	}
-	if(devices[_HAMSTER_LEFT_LED_INDEX]->written == 1) {
-		hamster->left_led = _device_read(devices[_HAMSTER_LEFT_LED_INDEX]);
-	}
-	if(devices[_HAMSTER_RIGHT_LED_INDEX]->written == 1) {
-		hamster->right_led = _device_read(devices[_HAMSTER_RIGHT_LED_INDEX]);
-	}
-	if(devices[_HAMSTER_NOTE_INDEX]->written == 1) {
-		hamster->note = _device_read(devices[_HAMSTER_NOTE_INDEX]);
-	}
-	if(devices[_HAMSTER_LINE_TRACER_MODE_INDEX]->written == 1) {
-		hamster->line_tracer_mode = _device_read(devices[_HAMSTER_LINE_TRACER_MODE_INDEX]);
-		hamster->line_tracer_mode_written = 1;
-	}
-	if(devices[_HAMSTER_LINE_TRACER_SPEED_INDEX]->written == 1) {
-		hamster->line_tracer_speed = _device_read(devices[_HAMSTER_LINE_TRACER_SPEED_INDEX]);
-	}
-	if(devices[_HAMSTER_IO_MODE_A_INDEX]->written == 1) {
-		hamster->io_mode_a = _device_read(devices[_HAMSTER_IO_MODE_A_INDEX]);
-	}
-	if(devices[_HAMSTER_IO_MODE_B_INDEX]->written == 1) {
-		hamster->io_mode_b = _device_read(devices[_HAMSTER_IO_MODE_B_INDEX]);
-	}
-	if(devices[_HAMSTER_CONFIG_PROXIMITY_INDEX]->written == 1) {
-		hamster->config_proximity = _device_read(devices[_HAMSTER_CONFIG_PROXIMITY_INDEX]);
-	}
-	if(devices[_HAMSTER_CONFIG_GRAVITY_INDEX]->written == 1) {
-		hamster->config_gravity = _device_read(devices[_HAMSTER_CONFIG_GRAVITY_INDEX]);
-	}
-	if(devices[_HAMSTER_CONFIG_BAND_WIDTH_INDEX]->written == 1) {
-		hamster->config_band_width = _device_read(devices[_HAMSTER_CONFIG_BAND_WIDTH_INDEX]);
-	}
-	_robot_clear_written(robot);
-}
-
-void _hamster_encode_motoring_packet(struct _robot* robot) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	struct _device** devices = robot->devices;
-	char* buffer = robot->write_buffer;
-	int index = 0, temp, i;
-	const char* address;
-
-	index = _value_to_hex(buffer, index, hamster->topology & 0x0f, 1);
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '1';
-	buffer[index++] = '0';
-	index = _value_to_hex(buffer, index, hamster->left_wheel, 1);
-	index = _value_to_hex(buffer, index, hamster->right_wheel, 1);
-	index = _value_to_hex(buffer, index, hamster->left_led, 1);
-	index = _value_to_hex(buffer, index, hamster->right_led, 1);
-	index = _value_to_hex(buffer, index, (int)(hamster->buzzer * 100), 3);
-	index = _value_to_hex(buffer, index, hamster->note, 1);
-	if(hamster->line_tracer_mode_written == 1) {
-		if(hamster->line_tracer_mode > 0) {
-			hamster->line_tracer_flag ^= 0x80;
-			hamster->line_tracer_event = 1;
-		}
-		hamster->line_tracer_mode_written = 0;
-	}
-	temp = (hamster->line_tracer_mode & 0x0f) << 3;
-	temp |= (hamster->line_tracer_speed - 1) & 0x07;
-	temp |= hamster->line_tracer_flag;
-	index = _value_to_hex(buffer, index, temp, 1);
-	index = _value_to_hex(buffer, index, hamster->config_proximity, 1);
-	temp = (hamster->config_gravity & 0x0f) << 4;
-	temp |= hamster->config_band_width & 0x0f;
-	index = _value_to_hex(buffer, index, temp, 1);
-	temp = (hamster->io_mode_a & 0x0f) << 4;
-	temp |= hamster->io_mode_b & 0x0f;
-	index = _value_to_hex(buffer, index, temp, 1);
-	index = _value_to_hex(buffer, index, hamster->output_a, 1);
-	index = _value_to_hex(buffer, index, hamster->output_b, 1);
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '0';
-	buffer[index++] = '-';
-	address = _connector_get_address(robot->connector);
-	for(i = 0; i < 12; ++i) {
-		buffer[index++] = address[i];
-	}
-	buffer[index++] = '\r';
-	
-	_connector_write(robot->connector, buffer, _MOTORING_PACKET_LENGTH);
-}
-
-int _hamster_decode_sensory_packet(struct _robot* robot, char* packet) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	struct _device** devices = robot->devices;
-	char* buffer = packet;
-	int value;
-	
-	value = _hex_to_value(buffer, 6, 8);
-	value -= 0x100;
-	_device_put(devices[_HAMSTER_SIGNAL_STRENGTH_INDEX], value);
-	_device_put(devices[_HAMSTER_LEFT_PROXIMITY_INDEX], _hex_to_value(buffer, 8, 10)); // left proximity
-	_device_put(devices[_HAMSTER_RIGHT_PROXIMITY_INDEX], _hex_to_value(buffer, 10, 12)); // right proximity
-	_device_put(devices[_HAMSTER_LEFT_FLOOR_INDEX], _hex_to_value(buffer, 12, 14)); // left floor
-	_device_put(devices[_HAMSTER_RIGHT_FLOOR_INDEX], _hex_to_value(buffer, 14, 16)); // right floor
-	value = _hex_to_value(buffer, 16, 20);
-	if(value > 0x7FFF) value -= 0x10000;
-	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 0, value);
-	value = _hex_to_value(buffer, 20, 24);
-	if(value > 0x7FFF) value -= 0x10000;
-	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 1, value);
-	value = _hex_to_value(buffer, 24, 28);
-	if(value > 0x7FFF) value -= 0x10000;
-	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 2, value);
-	value = _hex_to_value(buffer, 28, 30);
-	if(value == 0) {
-		hamster->light = _hex_to_value(buffer, 30, 34);
-	} else {
-		value = _hex_to_value(buffer, 30, 32);
-		if(value > 0x7F) value -= 0x100;
-		hamster->temperature = (int)(value / 2.0f + 24);
-	}
-	_device_put(devices[_HAMSTER_LIGHT_INDEX], hamster->light);
-	_device_put(devices[_HAMSTER_TEMPERATURE_INDEX], hamster->temperature);
-	_device_put(devices[_HAMSTER_INPUT_A_INDEX], _hex_to_value(buffer, 34, 36));
-	_device_put(devices[_HAMSTER_INPUT_B_INDEX], _hex_to_value(buffer, 36, 38));
-	value = _hex_to_value(buffer, 38, 40);
-	if((value & 0x40) != 0) {
-		if(hamster->line_tracer_event == 1) {
-			if(value != 0x40) {
-				hamster->line_tracer_event = 2;
-			}
-		}
-		if(hamster->line_tracer_event == 2) {
-			if(value != hamster->line_tracer_state) {
-				hamster->line_tracer_state = value;
-				_device_put(devices[_HAMSTER_LINE_TRACER_STATE_INDEX], value);
-				if(value == 0x40) {
-					hamster->line_tracer_event = 0;
-				}
-			}
-		}
-	}
-	return 1;
-}
-
-int _hamster_receive(struct _robot* robot) {
-	struct _connector* connector = robot->connector;
-	
-	if(connector != NULL) {
-		int read_bytes = _connector_read(connector);
-		if(read_bytes != 0) {
-			if(_hamster_decode_sensory_packet(robot, connector->buffer) == 1) {
-				if(robot->ready == 0) {
-					robot->ready = 1;
-					_runner_register_checked();
-				}
-			}
-			return 1;
-		}
-	}
-	return 0;
-}
-
-void _hamster_send(struct _robot* robot) {
-	struct _connector* connector = robot->connector;
-	
-	if(connector != NULL) {
-		_hamster_encode_motoring_packet(robot);
-	}
-}
-
-void _hamster_update_sensory_device_state(struct _robot* robot) {
-	struct _device** devices = robot->devices;
-	int i;
-
-	for(i = _HAMSTER_SIGNAL_STRENGTH_INDEX; i <= _HAMSTER_LINE_TRACER_STATE_INDEX; ++i) {
-		_device_update_device_state(devices[i]);
-	}
-}
-
-void _hamster_update_motoring_device_state(struct _robot* robot) {
-	struct _device** devices = robot->devices;
-	int i;
-
-	for(i = _HAMSTER_LEFT_WHEEL_INDEX; i <= _HAMSTER_CONFIG_BAND_WIDTH_INDEX; ++i) {
-		_device_update_device_state(devices[i]);
-	}
-}
-
-void _hamster_reset(struct _robot* robot) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return;
-	_robot_reset(robot);
-	
-	hamster->left_wheel = 0;
-	hamster->right_wheel = 0;
-	hamster->buzzer = 0;
-	hamster->output_a = 0;
-	hamster->output_b = 0;
-	hamster->topology = 0;
-	hamster->left_led = 0;
-	hamster->right_led = 0;
-	hamster->note = 0;
-	hamster->line_tracer_mode = 0;
-	hamster->line_tracer_speed = 5;
-	hamster->io_mode_a = 0;
-	hamster->io_mode_b = 0;
-	hamster->config_proximity = 2;
-	hamster->config_gravity = 0;
-	hamster->config_band_width = 3;
-	
-	hamster->light = 0;
-	hamster->temperature = 0;
-	hamster->line_tracer_mode_written = 0;
-	hamster->line_tracer_flag = 0;
-	hamster->line_tracer_state = 0;
-	hamster->line_tracer_event = 0;
-}
-
-void _hamster_dispose(struct _robot* robot) {
-	_robot_group_remove_robot(_GROUP_HAMSTER, robot);
-	_runner_remove_robot(robot);
-
-	robot->running = 0;
-	if(robot->thread_alive == 1) {
-		WaitForSingleObject(robot->thread_handle, 1000);
-	}
-	Sleep(100);
-	_robot_dispose(robot);
-	free((struct _hamster_robot*)robot);
-}
-
-unsigned WINAPI _hamster_thread_proc(void* arg) {
-	struct _robot* robot = (struct _robot*)arg;
-	int shutdown = 0, shutdown_count = 0;
-	
-	if(robot == NULL) return 0;
-
-	robot->thread_alive = 1;
-	while(1) {
-		if(_hamster_receive(robot) == 1) {
-			_hamster_send(robot);
-			if(shutdown == 1) {
-				break;
-			}
-		}
-		if(shutdown == 1) {
-			if(++shutdown_count > 5) {
-				break;
-			}
-		}
-		if(robot->running == 0) {
-			shutdown = 1;
-		}
-		Sleep(5);
-	}
-	robot->thread_alive = 0;
-	return 0;
-}
-
-struct _hamster_robot* _hamster_create(const char* port_name) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)malloc(sizeof(struct _hamster_robot));
-	struct _robot* robot = (struct _robot*)hamster;
-	struct _device** devices;
-	struct _connector* connector;
-	unsigned int thread_id;
-	
-	_robot_init(robot, _robot_group_count_robots(_GROUP_HAMSTER), "Hamster", 55);
-	
-	hamster->left_wheel = 0;
-	hamster->right_wheel = 0;
-	hamster->buzzer = 0;
-	hamster->output_a = 0;
-	hamster->output_b = 0;
-	hamster->topology = 0;
-	hamster->left_led = 0;
-	hamster->right_led = 0;
-	hamster->note = 0;
-	hamster->line_tracer_mode = 0;
-	hamster->line_tracer_speed = 5;
-	hamster->io_mode_a = 0;
-	hamster->io_mode_b = 0;
-	hamster->config_proximity = 2;
-	hamster->config_gravity = 0;
-	hamster->config_band_width = 3;
-	
-	hamster->light = 0;
-	hamster->temperature = 0;
-	hamster->bpm = 60;
-	hamster->line_tracer_mode_written = 0;
-	hamster->line_tracer_flag = 0;
-	hamster->line_tracer_state = 0;
-	hamster->line_tracer_event = 0;
-	hamster->board_count = 0;
-	hamster->board_state = 0;
-	
-	robot->request_motoring_data = _hamster_request_motoring_data;
-	robot->update_sensory_device_state = _hamster_update_sensory_device_state;
-	robot->update_motoring_device_state = _hamster_update_motoring_device_state;
-	robot->reset = _hamster_reset;
-	robot->dispose = _hamster_dispose;
-	
-	robot->devices_size = 27;
-	devices = (struct _device**)malloc(sizeof(struct _device*) * 27);
-	devices[0] = _device_create(HAMSTER_LEFT_WHEEL, "LeftWheel", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, -100, 100, 0);
-	devices[1] = _device_create(HAMSTER_RIGHT_WHEEL, "RightWheel", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, -100, 100, 0);
-	devices[2] = _device_create(HAMSTER_BUZZER, "Buzzer", DEVICE_TYPE_EFFECTOR, DATA_TYPE_FLOAT, 1, 0, 167772.15f, 0);
-	devices[3] = _device_create(HAMSTER_OUTPUT_A, "OutputA", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[4] = _device_create(HAMSTER_OUTPUT_B, "OutputB", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[5] = _device_create(HAMSTER_TOPOLOGY, "Topology", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
-	devices[6] = _device_create(HAMSTER_LEFT_LED, "LeftLed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 7, 0);
-	devices[7] = _device_create(HAMSTER_RIGHT_LED, "RightLed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 7, 0);
-	devices[8] = _device_create(HAMSTER_NOTE, "Note", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 88, 0);
-	devices[9] = _device_create(HAMSTER_LINE_TRACER_MODE, "LineTracerMode", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
-	devices[10] = _device_create(HAMSTER_LINE_TRACER_SPEED, "LineTracerSpeed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 8, 5);
-	devices[11] = _device_create(HAMSTER_IO_MODE_A, "IoModeA", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
-	devices[12] = _device_create(HAMSTER_IO_MODE_B, "IoModeB", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
-	devices[13] = _device_create(HAMSTER_CONFIG_PROXIMITY, "ConfigProximity", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 7, 2);
-	devices[14] = _device_create(HAMSTER_CONFIG_GRAVITY, "ConfigGravity", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 3, 0);
-	devices[15] = _device_create(HAMSTER_CONFIG_BAND_WIDTH, "ConfigBandWidth", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 8, 3);
-	devices[16] = _device_create(HAMSTER_SIGNAL_STRENGTH, "SignalStrength", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, -128, 0, 0);
-	devices[17] = _device_create(HAMSTER_LEFT_PROXIMITY, "LeftProximity", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[18] = _device_create(HAMSTER_RIGHT_PROXIMITY, "RightProximity", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[19] = _device_create(HAMSTER_LEFT_FLOOR, "LeftFloor", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[20] = _device_create(HAMSTER_RIGHT_FLOOR, "RightFloor", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[21] = _device_create(HAMSTER_ACCELERATION, "Acceleration", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 3, -32768, 32767, 0);
-	devices[22] = _device_create(HAMSTER_LIGHT, "Light", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 65535, 0);
-	devices[23] = _device_create(HAMSTER_TEMPERATURE, "Temperature", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, -40, 88, 0);
-	devices[24] = _device_create(HAMSTER_INPUT_A, "inputA", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[25] = _device_create(HAMSTER_INPUT_B, "inputB", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	devices[26] = _device_create(HAMSTER_LINE_TRACER_STATE, "LineTracerState", DEVICE_TYPE_EVENT, DATA_TYPE_INTEGER, 1, 0, 255, 0);
-	robot->devices = devices;
-	robot->connector = NULL;
-	robot->alive = 1;
-
-	_robot_group_add_robot(_GROUP_HAMSTER, robot);
-	_runner_add_robot(robot);
-	_runner_start();
-	
-	_runner_register_required();
-	robot->running = 1;
-	robot->thread_handle = (HANDLE)_beginthreadex(NULL,
-		0,
-		_hamster_thread_proc,
-		robot,
-		CREATE_SUSPENDED,
-		&thread_id);
-	if(robot->thread_handle != 0) {
-		ResumeThread(robot->thread_handle);
-	}
-
-	connector = _connector_create("Hamster", robot->index, _VALID_PACKET_LENGTH, _CR);
-	robot->connector = connector;
-	if(connector != NULL) {
-		int result;
-		connector->check_connection = _hamster_check_connection;
-		result = _connector_open(connector, port_name, _SERIAL_BAUDRATE_115200, _SERIAL_FLOWCONTROL_RTSCTS_IN | _SERIAL_FLOWCONTROL_RTSCTS_OUT);
-		if(result == _CONNECTION_RESULT_FOUND) {
-			while(robot->ready == 0 && robot->running == 1) {
-				Sleep(10);
-			}
-		} else if(result == _CONNECTION_RESULT_NOT_AVAILABLE) {
-			_runner_register_checked();
-		}
-	}
-	return hamster;
-}
-
-const char* _hamster_get_id(void) {
-	return HAMSTER_ID;
-}
-
-void _hamster_wheels(int hamster_index, double left_speed, double right_speed) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)left_speed);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)right_speed);
-}
-
-void _hamster_left_wheel(int hamster_index, double speed) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)speed);
-}
-
-void _hamster_right_wheel(int hamster_index, double speed) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)speed);
-}
-
-void _hamster_stop(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
-}
-
-int _hamster_line_tracer_mode_callback(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 1;
-	return _robot_e(robot, HAMSTER_LINE_TRACER_STATE) && _robot_read(robot, HAMSTER_LINE_TRACER_STATE) == 0x40;
-}
-
-void _hamster_line_tracer_mode(int hamster_index, int mode, int (*callback)(void* arg)) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, mode);
-	
-	switch(mode) {
-		case HAMSTER_LINE_TRACER_MODE_BLACK_MOVE_FORWARD:
-		case HAMSTER_LINE_TRACER_MODE_BLACK_TURN_LEFT:
-		case HAMSTER_LINE_TRACER_MODE_BLACK_TURN_RIGHT:
-		case HAMSTER_LINE_TRACER_MODE_BLACK_UTURN:
-		case HAMSTER_LINE_TRACER_MODE_WHITE_MOVE_FORWARD:
-		case HAMSTER_LINE_TRACER_MODE_WHITE_TURN_LEFT:
-		case HAMSTER_LINE_TRACER_MODE_WHITE_TURN_RIGHT:
-		case HAMSTER_LINE_TRACER_MODE_WHITE_UTURN: {
-			wait_until(callback, NULL);
-			break;
-		}
-	}
-}
-
-void _hamster_line_tracer_speed(int hamster_index, double speed) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LINE_TRACER_SPEED, (int)speed);
-}
-
-int _hamster_board_forward_callback(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return 1;
-	switch(hamster->board_state) {
-		case 1: {
-			if(hamster->board_count < 2) {
-				int left_floor = _robot_read(robot, HAMSTER_LEFT_FLOOR);
-				int right_floor = _robot_read(robot, HAMSTER_RIGHT_FLOOR);
-				int diff = left_floor - right_floor;
-				if(left_floor < 50 && right_floor < 50) {
-					hamster->board_count ++;
-				} else {
-					hamster->board_count = 0;
-				}
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(45 + diff * 0.25f));
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(45 - diff * 0.25f));
-			} else {
-				hamster->board_count = 0;
-				hamster->board_state = 2;
-			}
-			break;
-		}
-		case 2: {
-			if(hamster->board_count < 10) {
-				int diff = _robot_read(robot, HAMSTER_LEFT_FLOOR) - _robot_read(robot, HAMSTER_RIGHT_FLOOR);
-				hamster->board_count ++;
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(45 + diff * 0.25f));
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(45 - diff * 0.25f));
-			} else {
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
-				return 1;
-			}
-			break;
-		}
-	}
-	return 0;
-}
-
-void _hamster_board_forward(int hamster_index, int (*callback)(void* arg)) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return;
-	hamster->board_count = 0;
-	hamster->board_state = 1;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, 45);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 45);
-	wait_until(callback, NULL);
-}
-
-int _hamster_board_left_callback(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return 1;
-	switch(hamster->board_state) {
-		case 1: {
-			if(hamster->board_count < 2) {
-				if(_robot_read(robot, HAMSTER_LEFT_FLOOR) > 50) {
-					hamster->board_count ++;
-				}
-			} else {
-				hamster->board_count = 0;
-				hamster->board_state = 2;
-			}
-			break;
-		}
-		case 2: {
-			if(_robot_read(robot, HAMSTER_LEFT_FLOOR) < 20) {
-				hamster->board_state = 3;
-			}
-			break;
-		}
-		case 3: {
-			if(hamster->board_count < 2) {
-				if(_robot_read(robot, HAMSTER_LEFT_FLOOR) < 20) {
-					hamster->board_count ++;
-				}
-			} else {
-				hamster->board_count = 0;
-				hamster->board_state = 4;
-			}
-			break;
-		}
-		case 4: {
-			if(_robot_read(robot, HAMSTER_LEFT_FLOOR) > 50) {
-				hamster->board_state = 5;
-			}
-			break;
-		}
-		case 5: {
-			int diff = _robot_read(robot, HAMSTER_LEFT_FLOOR) - _robot_read(robot, HAMSTER_RIGHT_FLOOR);
-			if(diff > -15) {
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
-				return 1;
-			} else {
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(diff * 0.5f));
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, -(int)(diff * 0.5f));
-			}
-			break;
-		}
-	}
-	return 0;
-}
-
-void _hamster_board_left(int hamster_index, int (*callback)(void* arg)) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return;
-	hamster->board_count = 0;
-	hamster->board_state = 1;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, -45);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 45);
-	wait_until(callback, NULL);
-}
-
-int _hamster_board_right_callback(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return 1;
-	switch(hamster->board_state) {
-		case 1: {
-			if(hamster->board_count < 2) {
-				if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) > 50) {
-					hamster->board_count ++;
-				}
-			} else {
-				hamster->board_count = 0;
-				hamster->board_state = 2;
-			}
-			break;
-		}
-		case 2: {
-			if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) < 20) {
-				hamster->board_state = 3;
-			}
-			break;
-		}
-		case 3: {
-			if(hamster->board_count < 2) {
-				if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) < 20) {
-					hamster->board_count ++;
-				}
-			} else {
-				hamster->board_count = 0;
-				hamster->board_state = 4;
-			}
-			break;
-		}
-		case 4: {
-			if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) > 50) {
-				hamster->board_state = 5;
-			}
-			break;
-		}
-		case 5: {
-			int diff = _robot_read(robot, HAMSTER_RIGHT_FLOOR) - _robot_read(robot, HAMSTER_LEFT_FLOOR);
-			if(diff > -15) {
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
-				return 1;
-			} else {
-				_robot_write(robot, HAMSTER_LEFT_WHEEL, -(int)(diff * 0.5f));
-				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(diff * 0.5f));
-			}
-			break;
-		}
-	}
-	return 0;
-}
-
-void _hamster_board_right(int hamster_index, int (*callback)(void* arg)) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return;
-	hamster->board_count = 0;
-	hamster->board_state = 1;
-	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
-	_robot_write(robot, HAMSTER_LEFT_WHEEL, 45);
-	_robot_write(robot, HAMSTER_RIGHT_WHEEL, -45);
-	wait_until(callback, NULL);
-}
-
-void _hamster_leds(int hamster_index, int left_color, int right_color) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LEFT_LED, left_color);
-	_robot_write(robot, HAMSTER_RIGHT_LED, right_color);
-}
-
-void _hamster_left_led(int hamster_index, int color) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_LEFT_LED, color);
-}
-
-void _hamster_right_led(int hamster_index, int color) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_RIGHT_LED, color);
-}
-
-void _hamster_beep(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
-	_robot_write(robot, HAMSTER_BUZZER, 440);
-	wait(200);
-	_robot_write(robot, HAMSTER_BUZZER, 0);
-}
-
-void _hamster_buzzer(int hamster_index, double hz) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
-	_robot_write_float(robot, HAMSTER_BUZZER, (float)hz);
-}
-
-void _hamster_tempo(int hamster_index, double bpm) {
-	struct _hamster_robot* hamster = (struct _hamster_robot*)_robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(hamster == NULL) return;
-	if(bpm > 0) {
-		hamster->bpm = bpm;
-	}
-}
-
-void _hamster_pitch(int hamster_index, double pitch) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-
-	if(hamster == NULL) return;
-	if(pitch < 0) return;
-	_robot_write(robot, HAMSTER_BUZZER, 0);
-	_robot_write(robot, HAMSTER_NOTE, (int)pitch);
-}
-
-void _hamster_note(int hamster_index, double pitch, double beats) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
-	
-	if(hamster == NULL) return;
-	if(beats > 0) {
-		double bpm = hamster->bpm;
-		if(bpm > 0) {
-			int _pitch = (int)pitch;
-			if(_pitch == 0) {
-				_robot_write(robot, HAMSTER_BUZZER, 0);
-				_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
-				wait((int)(beats * 60 * 1000 / bpm));
-			} else if(_pitch > 0) {
-				int timeout = (int)(beats * 60 * 1000 / bpm);
-				int tail = 0;
-				if(timeout > 100) {
-					tail = 100;
-				}
-				_robot_write(robot, HAMSTER_BUZZER, 0);
-				_robot_write(robot, HAMSTER_NOTE, _pitch);
-				wait(timeout - tail);
-				_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
-				if(tail > 0) {
-					wait(tail);
-				}
-			}
-		}
-	}
-}
-
-void _hamster_io_mode_a(int hamster_index, int mode) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_IO_MODE_A, mode);
-}
-
-void _hamster_io_mode_b(int hamster_index, int mode) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_IO_MODE_B, mode);
-}
-
-void _hamster_output_a(int hamster_index, double value) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_OUTPUT_A, (int)value);
-}
-
-void _hamster_output_b(int hamster_index, double value) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return;
-	_robot_write(robot, HAMSTER_OUTPUT_B, (int)value);
-}
-
-int _hamster_signal_strength(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_SIGNAL_STRENGTH);
-}
-
-int _hamster_left_proximity(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_LEFT_PROXIMITY);
-}
-
-int _hamster_right_proximity(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_RIGHT_PROXIMITY);
-}
-
-int _hamster_left_floor(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_LEFT_FLOOR);
-}
-
-int _hamster_right_floor(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_RIGHT_FLOOR);
-}
-
-int _hamster_acceleration_x(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read_at(robot, HAMSTER_ACCELERATION, 0);
-}
-
-int _hamster_acceleration_y(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read_at(robot, HAMSTER_ACCELERATION, 1);
-}
-
-int _hamster_acceleration_z(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read_at(robot, HAMSTER_ACCELERATION, 2);
-}
-
-int _hamster_light(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_LIGHT);
-}
-
-int _hamster_temperature(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_TEMPERATURE);
-}
-
-int _hamster_input_a(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_INPUT_A);
-}
-
-int _hamster_input_b(int hamster_index) {
-	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
-	
-	if(robot == NULL) return 0;
-	return _robot_read(robot, HAMSTER_INPUT_B);
-}
-
-#define _MAX_NUM_HAMSTERS 10
-
-#define _FUNCTION_HAMSTER(n) \
-	__inline const char* _hamster_get_name_##n(void) { return _robot_group_get_name(_GROUP_HAMSTER, n); } \
-	__inline void _hamster_set_name_##n(const char* name) { _robot_group_set_name(_GROUP_HAMSTER, n, name); } \
-	__inline const char* _hamster_get_id_##n(void) { return HAMSTER_ID; } \
-	__inline int _hamster_get_index_##n(void) { return n; } \
-	__inline int _hamster_e_##n(int device_id) { return _robot_group_e(_GROUP_HAMSTER, n, device_id); } \
-	__inline int _hamster_read_##n(int device_id) { return _robot_group_read(_GROUP_HAMSTER, n, device_id); } \
-	__inline int _hamster_read_at_##n(int device_id, int index) { return _robot_group_read_at(_GROUP_HAMSTER, n, device_id, index); } \
-	__inline int _hamster_read_array_##n(int device_id, int* data, int length) { return _robot_group_read_array(_GROUP_HAMSTER, n, device_id, data, length); } \
-	__inline float _hamster_read_float_##n(int device_id) { return _robot_group_read_float(_GROUP_HAMSTER, n, device_id); } \
-	__inline float _hamster_read_float_at_##n(int device_id, int index) { return _robot_group_read_float_at(_GROUP_HAMSTER, n, device_id, index); } \
-	__inline int _hamster_read_float_array_##n(int device_id, float* data, int length) { return _robot_group_read_float_array(_GROUP_HAMSTER, n, device_id, data, length); } \
-	__inline int _hamster_write_##n(int device_id, int data) { return _robot_group_write(_GROUP_HAMSTER, n, device_id, data); } \
-	__inline int _hamster_write_at_##n(int device_id, int index, int data) { return _robot_group_write_at(_GROUP_HAMSTER, n, device_id, index, data); } \
-	__inline int _hamster_write_array_##n(int device_id, const int* data, int length) { return _robot_group_write_array(_GROUP_HAMSTER, n, device_id, data, length); } \
-	__inline int _hamster_write_float_##n(int device_id, float data) { return _robot_group_write_float(_GROUP_HAMSTER, n, device_id, data); } \
-	__inline int _hamster_write_float_at_##n(int device_id, int index, float data) { return _robot_group_write_float_at(_GROUP_HAMSTER, n, device_id, index, data); } \
-	__inline int _hamster_write_float_array_##n(int device_id, const float* data, int length) { return _robot_group_write_float_array(_GROUP_HAMSTER, n, device_id, data, length); } \
-	__inline void _hamster_reset_##n(void) { _robot_group_reset(_GROUP_HAMSTER, n); } \
-	__inline void _hamster_dispose_##n(void) { _robot_group_dispose(_GROUP_HAMSTER, n); } \
-	__inline void _hamster_wheels_##n(double left_speed, double right_speed) { _hamster_wheels(n, left_speed, right_speed); } \
-	__inline void _hamster_left_wheel_##n(double speed) { _hamster_left_wheel(n, speed); } \
-	__inline void _hamster_right_wheel_##n(double speed) { _hamster_right_wheel(n, speed); } \
-	__inline void _hamster_stop_##n(void) { _hamster_stop(n); } \
-	__inline int _hamster_line_tracer_mode_callback_##n(void* arg) { return _hamster_line_tracer_mode_callback(n); } \
-	__inline void _hamster_line_tracer_mode_##n(int mode) { _hamster_line_tracer_mode(n, mode, _hamster_line_tracer_mode_callback_##n); } \
-	__inline void _hamster_line_tracer_speed_##n(double speed) { _hamster_line_tracer_speed(n, speed); } \
-	__inline int _hamster_board_forward_callback_##n(void* arg) { return _hamster_board_forward_callback(n); } \
-	__inline void _hamster_board_forward_##n(void) { _hamster_board_forward(n, _hamster_board_forward_callback_##n); } \
-	__inline int _hamster_board_left_callback_##n(void* arg) { return _hamster_board_left_callback(n); } \
-	__inline void _hamster_board_left_##n(void) { _hamster_board_left(n, _hamster_board_left_callback_##n); } \
-	__inline int _hamster_board_right_callback_##n(void* arg) { return _hamster_board_right_callback(n); } \
-	__inline void _hamster_board_right_##n(void) { _hamster_board_right(n, _hamster_board_right_callback_##n); } \
-	__inline void _hamster_leds_##n(int left_color, int right_color) { _hamster_leds(n, left_color, right_color); } \
-	__inline void _hamster_left_led_##n(int color) { _hamster_left_led(n, color); } \
-	__inline void _hamster_right_led_##n(int color) { _hamster_right_led(n, color); } \
-	__inline void _hamster_beep_##n(void) { _hamster_beep(n); } \
-	__inline void _hamster_buzzer_##n(double hz) { _hamster_buzzer(n, hz); } \
-	__inline void _hamster_tempo_##n(double bpm) { _hamster_tempo(n, bpm); } \
-	__inline void _hamster_pitch_##n(double pitch) { _hamster_pitch(n, pitch); } \
-	__inline void _hamster_note_##n(double pitch, double beats) { _hamster_note(n, pitch, beats); } \
-	__inline void _hamster_io_mode_a_##n(int mode) { _hamster_io_mode_a(n, mode); } \
-	__inline void _hamster_io_mode_b_##n(int mode) { _hamster_io_mode_b(n, mode); } \
-	__inline void _hamster_output_a_##n(double value) { _hamster_output_a(n, value); } \
-	__inline void _hamster_output_b_##n(double value) { _hamster_output_b(n, value); } \
-	__inline int _hamster_signal_strength_##n(void) { return _hamster_signal_strength(n); } \
-	__inline int _hamster_left_proximity_##n(void) { return _hamster_left_proximity(n); } \
-	__inline int _hamster_right_proximity_##n(void) { return _hamster_right_proximity(n); } \
-	__inline int _hamster_left_floor_##n(void) { return _hamster_left_floor(n); } \
-	__inline int _hamster_right_floor_##n(void) { return _hamster_right_floor(n); } \
-	__inline int _hamster_acceleration_x_##n(void) { return _hamster_acceleration_x(n); } \
-	__inline int _hamster_acceleration_y_##n(void) { return _hamster_acceleration_y(n); } \
-	__inline int _hamster_acceleration_z_##n(void) { return _hamster_acceleration_z(n); } \
-	__inline int _hamster_light_##n(void) { return _hamster_light(n); } \
-	__inline int _hamster_temperature_##n(void) { return _hamster_temperature(n); } \
-	__inline int _hamster_input_a_##n(void) { return _hamster_input_a(n); } \
-	__inline int _hamster_input_b_##n(void) { return _hamster_input_b(n); }
-
-#define _FUNCTION_PTR_HAMSTER(name, n) \
-	name->get_name = _hamster_get_name_##n; \
-	name->set_name = _hamster_set_name_##n; \
-	name->get_id = _hamster_get_id_##n; \
-	name->get_index = _hamster_get_index_##n; \
-	name->e = _hamster_e_##n; \
-	name->read = _hamster_read_##n; \
-	name->read_at = _hamster_read_at_##n; \
-	name->read_array = _hamster_read_array_##n; \
-	name->read_float = _hamster_read_float_##n; \
-	name->read_float_at = _hamster_read_float_at_##n; \
-	name->read_float_array = _hamster_read_float_array_##n; \
-	name->write = _hamster_write_##n; \
-	name->write_at = _hamster_write_at_##n; \
-	name->write_array = _hamster_write_array_##n; \
-	name->write_float = _hamster_write_float_##n; \
-	name->write_float_at = _hamster_write_float_at_##n; \
-	name->write_float_array = _hamster_write_float_array_##n; \
-	name->reset = _hamster_reset_##n; \
-	name->dispose = _hamster_dispose_##n; \
-	name->wheels = _hamster_wheels_##n; \
-	name->left_wheel = _hamster_left_wheel_##n; \
-	name->right_wheel = _hamster_right_wheel_##n; \
-	name->stop = _hamster_stop_##n; \
-	name->line_tracer_mode = _hamster_line_tracer_mode_##n; \
-	name->line_tracer_speed = _hamster_line_tracer_speed_##n; \
-	name->board_forward = _hamster_board_forward_##n; \
-	name->board_left = _hamster_board_left_##n; \
-	name->board_right = _hamster_board_right_##n; \
-	name->leds = _hamster_leds_##n; \
-	name->left_led = _hamster_left_led_##n; \
-	name->right_led = _hamster_right_led_##n; \
-	name->beep = _hamster_beep_##n; \
-	name->buzzer = _hamster_buzzer_##n; \
-	name->tempo = _hamster_tempo_##n; \
-	name->pitch = _hamster_pitch_##n; \
-	name->note = _hamster_note_##n; \
-	name->io_mode_a = _hamster_io_mode_a_##n; \
-	name->io_mode_b = _hamster_io_mode_b_##n; \
-	name->output_a = _hamster_output_a_##n; \
-	name->output_b = _hamster_output_b_##n; \
-	name->signal_strength = _hamster_signal_strength_##n; \
-	name->left_proximity = _hamster_left_proximity_##n; \
-	name->right_proximity = _hamster_right_proximity_##n; \
-	name->left_floor = _hamster_left_floor_##n; \
-	name->right_floor = _hamster_right_floor_##n; \
-	name->acceleration_x = _hamster_acceleration_x_##n; \
-	name->acceleration_y = _hamster_acceleration_y_##n; \
-	name->acceleration_z = _hamster_acceleration_z_##n; \
-	name->light = _hamster_light_##n; \
-	name->temperature = _hamster_temperature_##n; \
-	name->input_a = _hamster_input_a_##n; \
-	name->input_b = _hamster_input_b_##n;
-
-_FUNCTION_HAMSTER(0);
-_FUNCTION_HAMSTER(1);
-_FUNCTION_HAMSTER(2);
-_FUNCTION_HAMSTER(3);
-_FUNCTION_HAMSTER(4);
-_FUNCTION_HAMSTER(5);
-_FUNCTION_HAMSTER(6);
-_FUNCTION_HAMSTER(7);
-_FUNCTION_HAMSTER(8);
-_FUNCTION_HAMSTER(9);
-
-Hamster* hamster_create_port(const char* port_name) {
-	if(_robot_group_count_robots(_GROUP_HAMSTER) < _MAX_NUM_HAMSTERS) {
-		struct hamster* hamster = (struct hamster*)malloc(sizeof(struct hamster));
-		struct _robot* robot = (struct _robot*)_hamster_create(port_name);
-	
-		switch(robot->index) {
-			case 0: _FUNCTION_PTR_HAMSTER(hamster, 0); break;
-			case 1: _FUNCTION_PTR_HAMSTER(hamster, 1); break;
-			case 2: _FUNCTION_PTR_HAMSTER(hamster, 2); break;
-			case 3: _FUNCTION_PTR_HAMSTER(hamster, 3); break;
-			case 4: _FUNCTION_PTR_HAMSTER(hamster, 4); break;
-			case 5: _FUNCTION_PTR_HAMSTER(hamster, 5); break;
-			case 6: _FUNCTION_PTR_HAMSTER(hamster, 6); break;
-			case 7: _FUNCTION_PTR_HAMSTER(hamster, 7); break;
-			case 8: _FUNCTION_PTR_HAMSTER(hamster, 8); break;
-			case 9: _FUNCTION_PTR_HAMSTER(hamster, 9); break;
-		}
-		return hamster;
-	}
-	return NULL;
-}
-
-Hamster* hamster_create(void) {
-	return hamster_create_port(NULL);
-}
-
-const char* hamster_get_name(void) {
-	return _robot_group_get_name(_GROUP_HAMSTER, 0);
-}
-
-void hamster_set_name(const char* name) {
-	_robot_group_set_name(_GROUP_HAMSTER, 0, name);
-}
-
-const char* hamster_get_id(void) {
-	return HAMSTER_ID;
-}
-
-int hamster_e(int device_id) {
-	return _robot_group_e(_GROUP_HAMSTER, 0, device_id);
-}
-
-int hamster_read(int device_id) {
-	return _robot_group_read(_GROUP_HAMSTER, 0, device_id);
-}
-
-int hamster_read_at(int device_id, int index) {
-	return _robot_group_read_at(_GROUP_HAMSTER, 0, device_id, index);
-}
-
-int hamster_read_array(int device_id, int* data, int length) {
-	return _robot_group_read_array(_GROUP_HAMSTER, 0, device_id, data, length);
-}
-
-float hamster_read_float(int device_id) {
-	return _robot_group_read_float(_GROUP_HAMSTER, 0, device_id);
-}
-
-float hamster_read_float_at(int device_id, int index) {
-	return _robot_group_read_float_at(_GROUP_HAMSTER, 0, device_id, index);
-}
-
-int hamster_read_float_array(int device_id, float* data, int length) {
-	return _robot_group_read_float_array(_GROUP_HAMSTER, 0, device_id, data, length);
-}
-
-int hamster_write(int device_id, int data) {
-	return _robot_group_write(_GROUP_HAMSTER, 0, device_id, data);
-}
-
-int hamster_write_at(int device_id, int index, int data) {
-	return _robot_group_write_at(_GROUP_HAMSTER, 0, device_id, index, data);
-}
-
-int hamster_write_array(int device_id, const int* data, int length) {
-	return _robot_group_write_array(_GROUP_HAMSTER, 0, device_id, data, length);
-}
-
-int hamster_write_float(int device_id, float data) {
-	return _robot_group_write_float(_GROUP_HAMSTER, 0, device_id, data);
-}
-
-int hamster_write_float_at(int device_id, int index, float data) {
-	return _robot_group_write_float_at(_GROUP_HAMSTER, 0, device_id, index, data);
-}
-
-int hamster_write_float_array(int device_id, const float* data, int length) {
-	return _robot_group_write_float_array(_GROUP_HAMSTER, 0, device_id, data, length);
-}
-
-void hamster_reset(void) {
-	_robot_group_reset(_GROUP_HAMSTER, 0);
-}
-
-void hamster_dispose(void) {
-	_robot_group_dispose(_GROUP_HAMSTER, 0);
-}
-
-void hamster_wheels(double left_speed, double right_speed) {
-	_hamster_wheels(0, left_speed, right_speed);
-}
-
-void hamster_left_wheel(double speed) {
-	_hamster_left_wheel(0, speed);
-}
-
-void hamster_right_wheel(double speed) {
-	_hamster_right_wheel(0, speed);
-}
-
-void hamster_stop(void) {
-	_hamster_stop(0);
-}
-
-int _hamster_line_tracer_mode_evaluate(void* arg) {
-	return _hamster_line_tracer_mode_callback(0);
-}
-
-void hamster_line_tracer_mode(int mode) {
-	_hamster_line_tracer_mode(0, mode, _hamster_line_tracer_mode_evaluate);
-}
-
-void hamster_line_tracer_speed(double speed) {
-	_hamster_line_tracer_speed(0, speed);
-}
-
-int _hamster_board_forward_evaluate(void* arg) {
-	return _hamster_board_forward_callback(0);
-}
-
-void hamster_board_forward(void) {
-	_hamster_board_forward(0, _hamster_board_forward_evaluate);
-}
-
-int _hamster_board_left_evaluate(void* arg) {
-	return _hamster_board_left_callback(0);
-}
-
-void hamster_board_left(void) {
-	_hamster_board_left(0, _hamster_board_left_evaluate);
-}
-
-int _hamster_board_right_evaluate(void* arg) {
-	return _hamster_board_right_callback(0);
-}
-
-void hamster_board_right(void) {
-	_hamster_board_right(0, _hamster_board_right_evaluate);
-}
-
-void hamster_leds(int left_color, int right_color) {
-	_hamster_leds(0, left_color, right_color);
-}
-
-void hamster_left_led(int color) {
-	_hamster_left_led(0, color);
-}
-
-void hamster_right_led(int color) {
-	_hamster_right_led(0, color);
-}
-
-void hamster_beep(void) {
-	_hamster_beep(0);
-}
-
-void hamster_buzzer(double hz) {
-	_hamster_buzzer(0, hz);
-}
-
-void hamster_tempo(double bpm) {
-	_hamster_tempo(0, bpm);
-}
-
-void hamster_pitch(double pitch) {
-	_hamster_pitch(0, pitch);
-}
-
-void hamster_note(double pitch, double beats) {
-	_hamster_note(0, pitch, beats);
-}
-
-void hamster_io_mode_a(int mode) {
-	_hamster_io_mode_a(0, mode);
-}
-
-void hamster_io_mode_b(int mode) {
-	_hamster_io_mode_b(0, mode);
-}
-
-void hamster_output_a(double value) {
-	_hamster_output_a(0, value);
-}
-
-void hamster_output_b(double value) {
-	_hamster_output_b(0, value);
-}
-
-int hamster_signal_strength(void) {
-	return _hamster_signal_strength(0);
-}
-
-int hamster_left_proximity(void) {
-	return _hamster_left_proximity(0);
-}
-
-int hamster_right_proximity(void) {
-	return _hamster_right_proximity(0);
-}
-
-int hamster_left_floor(void) {
-	return _hamster_left_floor(0);
-}
-
-int hamster_right_floor(void) {
-	return _hamster_right_floor(0);
-}
-
-int hamster_acceleration_x(void) {
-	return _hamster_acceleration_x(0);
-}
-
-int hamster_acceleration_y(void) {
-	return _hamster_acceleration_y(0);
-}
-
-int hamster_acceleration_z(void) {
-	return _hamster_acceleration_z(0);
-}
-
-int hamster_light(void) {
-	return _hamster_light(0);
-}
-
-int hamster_temperature(void) {
-	return _hamster_temperature(0);
-}
-
-int hamster_input_a(void) {
-	return _hamster_input_a(0);
-}
-
-int hamster_input_b(void) {
-	return _hamster_input_b(0);
-}
+/*
+ * Part of the ROBOID project - http://hamster.school
+ * Copyright (C) 2016 Kwang-Hyun Park (akaii@kw.ac.kr)
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA  02111-1307  USA
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // pthread_timedjoin_np
+#endif
+#ifdef _WIN32
+#include <process.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <strings.h>
+#include <termios.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#if defined(ROBOID_IO_URING) && defined(__linux__)
+#define _SERIAL_URING // one io_uring for the reads and writes of all serial ports
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _HEX_SSE2 // 16 hex digits per step in _hex_to_bytes
+#include <emmintrin.h>
+#endif
+#include <signal.h>
+#include "roboid.h"
+
+#ifdef _MSC_VER
+#define _STRCPY(dst, sz, src) strcpy_s((dst), (sz), (src))
+#define _STRCAT(dst, sz, src) strcat_s((dst), (sz), (src))
+#define _STRNCPY(dst, sz, src, n) strncpy_s((dst), (sz), (src), (n))
+#define _STRICMP(s1, s2) _stricmp((s1), (s2))
+#elif defined(_WIN32)
+#define _STRCPY(dst, sz, src) strcpy((dst), (src))
+#define _STRCAT(dst, sz, src) strcat((dst), (src))
+#define _STRNCPY(dst, sz, src, n) strncpy((dst), (src), (n))
+#define _STRICMP(s1, s2) stricmp((s1), (s2))
+#else
+#define _STRCPY(dst, sz, src) strcpy((dst), (src))
+#define _STRCAT(dst, sz, src) strcat((dst), (src))
+#define _STRNCPY(dst, sz, src, n) strncpy((dst), (src), (n))
+#define _STRICMP(s1, s2) strcasecmp((s1), (s2))
+#endif
+
+#ifdef _WIN64
+#define _LONG long long
+#else
+#define _LONG long
+#endif
+
+/*------------------------------
+  THREAD
+------------------------------*/
+
+#ifdef _WIN32
+#define _THREAD HANDLE
+#define _THREAD_PROC unsigned WINAPI
+#define _SLEEP(milliseconds) Sleep(milliseconds)
+#define _MUTEX CRITICAL_SECTION
+#define _MUTEX_INIT(mutex) InitializeCriticalSection(mutex)
+#define _MUTEX_LOCK(mutex) EnterCriticalSection(mutex)
+#define _MUTEX_UNLOCK(mutex) LeaveCriticalSection(mutex)
+#define _MUTEX_DESTROY(mutex) DeleteCriticalSection(mutex)
+#define _COND CONDITION_VARIABLE
+#define _COND_INIT(cond) InitializeConditionVariable(cond)
+#define _COND_SIGNAL(cond) WakeConditionVariable(cond)
+#define _COND_BROADCAST(cond) WakeAllConditionVariable(cond)
+#define _COND_DESTROY(cond)
+typedef unsigned (WINAPI *_THREAD_START)(void* arg);
+#else
+#define _THREAD pthread_t
+#define _THREAD_PROC void*
+#define _SLEEP(milliseconds) usleep((milliseconds) * 1000)
+#define _MUTEX pthread_mutex_t
+#define _MUTEX_INIT(mutex) pthread_mutex_init((mutex), NULL)
+#define _MUTEX_LOCK(mutex) pthread_mutex_lock(mutex)
+#define _MUTEX_UNLOCK(mutex) pthread_mutex_unlock(mutex)
+#define _MUTEX_DESTROY(mutex) pthread_mutex_destroy(mutex)
+#define _COND pthread_cond_t
+#define _COND_INIT(cond) _cond_init(cond)
+#ifdef __APPLE__
+#define _COND_CLOCK CLOCK_REALTIME // no pthread_condattr_setclock
+#else
+#define _COND_CLOCK CLOCK_MONOTONIC // timed waits don't stretch or shrink when the wall clock is set
+#endif
+#define _COND_SIGNAL(cond) pthread_cond_signal(cond)
+#define _COND_BROADCAST(cond) pthread_cond_broadcast(cond)
+#define _COND_DESTROY(cond) pthread_cond_destroy(cond)
+typedef void* (*_THREAD_START)(void* arg);
+#endif
+
+int _thread_start(_THREAD* thread, _THREAD_START start, void* arg);
+void _thread_join(_THREAD thread, int timeout);
+void _cond_wait(_COND* cond, _MUTEX* mutex, int timeout);
+#ifndef _WIN32
+void _cond_init(_COND* cond);
+void _cond_get_until(struct timespec* until, int timeout);
+#endif
+
+int _thread_start(_THREAD* thread, _THREAD_START start, void* arg) {
+#ifdef _WIN32
+	unsigned int thread_id;
+
+	*thread = (HANDLE)_beginthreadex(NULL,
+		0,
+		start,
+		arg,
+		CREATE_SUSPENDED,
+		&thread_id);
+	if(*thread != 0) {
+		ResumeThread(*thread);
+		return 1;
+	}
+	return 0;
+#else
+	return pthread_create(thread, NULL, start, arg) == 0 ? 1 : 0;
+#endif
+}
+
+void _thread_join(_THREAD thread, int timeout) { // timeout < 0: infinite
+#ifdef _WIN32
+	WaitForSingleObject(thread, timeout < 0 ? INFINITE : (DWORD)timeout);
+#elif defined(__GLIBC__)
+	struct timespec until;
+
+	if(timeout < 0) {
+		pthread_join(thread, NULL);
+		return;
+	}
+	clock_gettime(CLOCK_REALTIME, &until); // pthread_timedjoin_np waits on the wall clock
+	until.tv_sec += timeout / 1000;
+	until.tv_nsec += (timeout % 1000) * 1000000L;
+	if(until.tv_nsec >= 1000000000L) {
+		until.tv_nsec -= 1000000000L;
+		++ until.tv_sec;
+	}
+	if(pthread_timedjoin_np(thread, NULL, &until) != 0) {
+		pthread_detach(thread); // left to finish on its own like the thread WaitForSingleObject gives up on
+	}
+#else
+	pthread_join(thread, NULL); // no timed join here: wait it out
+#endif
+}
+
+void _cond_wait(_COND* cond, _MUTEX* mutex, int timeout) { // mutex locked, may wake early
+#ifdef _WIN32
+	SleepConditionVariableCS(cond, mutex, (DWORD)timeout);
+#else
+	struct timespec until;
+
+	_cond_get_until(&until, timeout);
+	pthread_cond_timedwait(cond, mutex, &until);
+#endif
+}
+
+#ifndef _WIN32
+void _cond_init(_COND* cond) {
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+#ifndef __APPLE__
+	pthread_condattr_setclock(&attr, _COND_CLOCK);
+#endif
+	pthread_cond_init(cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+void _cond_get_until(struct timespec* until, int timeout) { // for pthread_cond_timedwait on a _COND_INIT condition
+	clock_gettime(_COND_CLOCK, until);
+	until->tv_sec += timeout / 1000;
+	until->tv_nsec += (timeout % 1000) * 1000000L;
+	if(until->tv_nsec >= 1000000000L) {
+		until->tv_nsec -= 1000000000L;
+		++ until->tv_sec;
+	}
+}
+#endif
+
+/*------------------------------
+  CLOCK
+------------------------------*/
+
+#define _CLOCK_MILLISECOND 1000000ULL // in nanoseconds
+#define _CLOCK_SECOND 1000000000ULL
+
+unsigned long long _clock_get_time(void);
+
+unsigned long long _clock_get_time(void) { // nanoseconds on a clock that only goes forward, from an arbitrary start
+#ifdef _WIN32
+	static LARGE_INTEGER frequency; // fixed at boot
+	LARGE_INTEGER counter;
+
+	if(frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	QueryPerformanceCounter(&counter);
+	return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * _CLOCK_SECOND
+		+ (unsigned long long)(counter.QuadPart % frequency.QuadPart) * _CLOCK_SECOND / (unsigned long long)frequency.QuadPart;
+#else
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long)t.tv_sec * _CLOCK_SECOND + (unsigned long long)t.tv_nsec;
+#endif
+}
+
+/*------------------------------
+  CAPTURE
+------------------------------*/
+
+#define _CAPTURE_MAGIC "ROBOID CAPTURE1\n" // 16 bytes
+#define _CAPTURE_MAGIC_SIZE 16
+#define _CAPTURE_INITIAL_SIZE (1024 * 1024)
+#define _CAPTURE_RECEIVED 1
+#define _CAPTURE_SENT 2
+
+struct _capture_record { // followed by the data, padded to 8 bytes
+	unsigned long long time; // nanoseconds since the capture was opened
+	unsigned int length;
+	unsigned int direction;
+};
+
+struct _capture {
+	char* base; // mapped file
+	size_t size; // mapped size
+	size_t length; // used size
+	unsigned long long start;
+	int writable; // made by _capture_create: cut to its used length when closed
+	_MUTEX lock; // the writer thread appends what it sends
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int fd;
+#endif
+};
+
+char* _capture_path = NULL;
+
+int _capture_map(struct _capture* capture, size_t size, int writable);
+void _capture_unmap(struct _capture* capture);
+struct _capture* _capture_create(const char* path);
+struct _capture* _capture_open(const char* path);
+void _capture_close(struct _capture* capture);
+void _capture_append(struct _capture* capture, int direction, const char* data, int length);
+size_t _capture_get_length(struct _capture* capture);
+void _capture_rewind(struct _capture* capture, size_t length);
+const struct _capture_record* _capture_get_record(const struct _capture* capture, size_t offset);
+size_t _capture_next_record(const struct _capture_record* record, size_t offset);
+
+int _capture_map(struct _capture* capture, size_t size, int writable) {
+#ifdef _WIN32
+	capture->mapping = CreateFileMappingA(capture->file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD)((unsigned long long)size >> 32), (DWORD)size, NULL);
+	if(capture->mapping == NULL) return 0;
+	capture->base = (char*)MapViewOfFile(capture->mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	if(capture->base == NULL) {
+		CloseHandle(capture->mapping);
+		capture->mapping = NULL;
+		return 0;
+	}
+#else
+	if(writable && ftruncate(capture->fd, (off_t)size) != 0) return 0;
+	capture->base = (char*)mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, capture->fd, 0);
+	if(capture->base == (char*)MAP_FAILED) {
+		capture->base = NULL;
+		return 0;
+	}
+#endif
+	capture->size = size;
+	return 1;
+}
+
+void _capture_unmap(struct _capture* capture) {
+	if(capture->base == NULL) return;
+#ifdef _WIN32
+	UnmapViewOfFile(capture->base);
+	CloseHandle(capture->mapping);
+	capture->mapping = NULL;
+#else
+	munmap(capture->base, capture->size);
+#endif
+	capture->base = NULL;
+}
+
+struct _capture* _capture_create(const char* path) {
+	struct _capture* capture = (struct _capture*)malloc(sizeof(struct _capture));
+
+	capture->base = NULL;
+	capture->length = _CAPTURE_MAGIC_SIZE;
+	capture->start = _clock_get_time();
+	capture->writable = 1;
+#ifdef _WIN32
+	capture->mapping = NULL;
+	capture->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(capture->file == INVALID_HANDLE_VALUE) {
+		free(capture);
+		return NULL;
+	}
+	if(_capture_map(capture, _CAPTURE_INITIAL_SIZE, 1) == 0) {
+		CloseHandle(capture->file);
+		free(capture);
+		return NULL;
+	}
+#else
+	capture->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(capture->fd < 0) {
+		free(capture);
+		return NULL;
+	}
+	if(_capture_map(capture, _CAPTURE_INITIAL_SIZE, 1) == 0) {
+		close(capture->fd);
+		free(capture);
+		return NULL;
+	}
+#endif
+	memcpy(capture->base, _CAPTURE_MAGIC, _CAPTURE_MAGIC_SIZE);
+	_MUTEX_INIT(&capture->lock);
+	return capture;
+}
+
+struct _capture* _capture_open(const char* path) {
+	struct _capture* capture = (struct _capture*)malloc(sizeof(struct _capture));
+	size_t size;
+
+	capture->base = NULL;
+	capture->start = 0;
+	capture->writable = 0;
+#ifdef _WIN32
+	capture->mapping = NULL;
+	capture->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(capture->file == INVALID_HANDLE_VALUE) {
+		free(capture);
+		return NULL;
+	}
+	size = (size_t)GetFileSize(capture->file, NULL);
+	if(size < _CAPTURE_MAGIC_SIZE || _capture_map(capture, size, 0) == 0) {
+		CloseHandle(capture->file);
+		free(capture);
+		return NULL;
+	}
+#else
+	{
+		struct stat info;
+
+		capture->fd = open(path, O_RDONLY);
+		if(capture->fd < 0) {
+			free(capture);
+			return NULL;
+		}
+		size = fstat(capture->fd, &info) == 0 ? (size_t)info.st_size : 0;
+		if(size < _CAPTURE_MAGIC_SIZE || _capture_map(capture, size, 0) == 0) {
+			close(capture->fd);
+			free(capture);
+			return NULL;
+		}
+	}
+#endif
+	capture->length = size;
+	_MUTEX_INIT(&capture->lock);
+	if(memcmp(capture->base, _CAPTURE_MAGIC, _CAPTURE_MAGIC_SIZE) != 0) {
+		_capture_close(capture);
+		return NULL;
+	}
+	return capture;
+}
+
+void _capture_close(struct _capture* capture) { // a created capture is cut to its used length
+	int cut = 1;
+
+	if(capture == NULL) return;
+	if(capture->writable == 1 && capture->base != NULL && capture->length + sizeof(struct _capture_record) <= capture->size) {
+		// an empty record ends the replay if the file keeps its padding: records dropped by a rewind are not played
+		memset(capture->base + capture->length, 0, sizeof(struct _capture_record));
+	}
+	_capture_unmap(capture);
+#ifdef _WIN32
+	if(capture->writable == 1) {
+		LONG high = (LONG)((unsigned long long)capture->length >> 32);
+
+		if((SetFilePointer(capture->file, (LONG)capture->length, &high, FILE_BEGIN) == INVALID_SET_FILE_POINTER && GetLastError() != NO_ERROR)
+			|| SetEndOfFile(capture->file) == 0) {
+			cut = 0;
+		}
+	}
+	CloseHandle(capture->file);
+#else
+	if(capture->writable == 1 && ftruncate(capture->fd, (off_t)capture->length) != 0) {
+		cut = 0;
+	}
+	close(capture->fd);
+#endif
+	if(cut == 0) {
+		printf("Capture not cut to its length: it is played up to its last record\n");
+	}
+	_MUTEX_DESTROY(&capture->lock);
+	free(capture);
+}
+
+void _capture_append(struct _capture* capture, int direction, const char* data, int length) {
+	struct _capture_record* record;
+	size_t needed = sizeof(struct _capture_record) + (((size_t)length + 7) & ~(size_t)7);
+
+	if(length <= 0) return;
+	_MUTEX_LOCK(&capture->lock);
+	if(capture->base != NULL && capture->length + needed > capture->size) {
+		size_t size = capture->size;
+
+		while(capture->length + needed > size) size *= 2;
+		_capture_unmap(capture);
+		_capture_map(capture, size, 1); // on failure stop capturing, keep what we have
+	}
+	if(capture->base != NULL) {
+		record = (struct _capture_record*)(capture->base + capture->length);
+		record->time = _clock_get_time() - capture->start;
+		record->length = (unsigned int)length;
+		record->direction = (unsigned int)direction;
+		memcpy(record + 1, data, (size_t)length);
+		capture->length += needed;
+	}
+	_MUTEX_UNLOCK(&capture->lock);
+}
+
+size_t _capture_get_length(struct _capture* capture) {
+	size_t length;
+
+	_MUTEX_LOCK(&capture->lock);
+	length = capture->length;
+	_MUTEX_UNLOCK(&capture->lock);
+	return length;
+}
+
+void _capture_rewind(struct _capture* capture, size_t length) { // drop the records appended since length was taken
+	_MUTEX_LOCK(&capture->lock);
+	if(length >= _CAPTURE_MAGIC_SIZE && length < capture->length) {
+		capture->length = length;
+	}
+	_MUTEX_UNLOCK(&capture->lock);
+}
+
+const struct _capture_record* _capture_get_record(const struct _capture* capture, size_t offset) {
+	const struct _capture_record* record;
+
+	if(offset + sizeof(struct _capture_record) > capture->length) return NULL;
+	record = (const struct _capture_record*)(capture->base + offset);
+	if(record->length == 0 || offset + sizeof(struct _capture_record) + record->length > capture->length) return NULL;
+	return record;
+}
+
+size_t _capture_next_record(const struct _capture_record* record, size_t offset) {
+	return offset + sizeof(struct _capture_record) + (((size_t)record->length + 7) & ~(size_t)7);
+}
+
+/*------------------------------
+  SERIAL
+------------------------------*/
+
+#define _SERIAL_BAUDRATE_110 110
+#define _SERIAL_BAUDRATE_300 300
+#define _SERIAL_BAUDRATE_600 600
+#define _SERIAL_BAUDRATE_1200 1200
+#define _SERIAL_BAUDRATE_4800 4800
+#define _SERIAL_BAUDRATE_9600 9600
+#define _SERIAL_BAUDRATE_14400 14400
+#define _SERIAL_BAUDRATE_19200 19200
+#define _SERIAL_BAUDRATE_38400 38400
+#define _SERIAL_BAUDRATE_57600 57600
+#define _SERIAL_BAUDRATE_115200 115200
+#define _SERIAL_BAUDRATE_128000 128000
+#define _SERIAL_BAUDRATE_256000 256000
+
+#define _SERIAL_DATABITS_5 5
+#define _SERIAL_DATABITS_6 6
+#define _SERIAL_DATABITS_7 7
+#define _SERIAL_DATABITS_8 8
+
+#define _SERIAL_STOPBITS_1 1
+#define _SERIAL_STOPBITS_2 2
+#define _SERIAL_STOPBITS_1_5 3
+
+#define _SERIAL_PARITY_NONE 0
+#define _SERIAL_PARITY_ODD 1
+#define _SERIAL_PARITY_EVEN 2
+#define _SERIAL_PARITY_MARK 3
+#define _SERIAL_PARITY_SPACE 4
+
+#define _SERIAL_PURGE_RXABORT 0x0002
+#define _SERIAL_PURGE_RXCLEAR 0x0008
+#define _SERIAL_PURGE_TXABORT 0x0001
+#define _SERIAL_PURGE_TXCLEAR 0x0004
+
+#define _SERIAL_MASK_RXCHAR 1
+#define _SERIAL_MASK_RXFLAG 2
+#define _SERIAL_MASK_TXEMPTY 4
+#define _SERIAL_MASK_CTS 8
+#define _SERIAL_MASK_DSR 16
+#define _SERIAL_MASK_RLSD 32
+#define _SERIAL_MASK_BREAK 64
+#define _SERIAL_MASK_ERR 128
+#define _SERIAL_MASK_RING 256
+
+#define _SERIAL_FLOWCONTROL_NONE 0
+#define _SERIAL_FLOWCONTROL_RTSCTS_IN 1
+#define _SERIAL_FLOWCONTROL_RTSCTS_OUT 2
+#define _SERIAL_FLOWCONTROL_XONXOFF_IN 4
+#define _SERIAL_FLOWCONTROL_XONXOFF_OUT 8
+
+#define _SERIAL_ERROR_FRAME 0x0008
+#define _SERIAL_ERROR_OVERRUN 0x0002
+#define _SERIAL_ERROR_PARITY 0x0004
+
+#define _SERIAL_ERROR_PORT_BUSY -1
+#define _SERIAL_ERROR_PORT_NOT_FOUND -2
+#define _SERIAL_ERROR_PERMISSION_DENIED -3
+#define _SERIAL_ERROR_INCORRECT_SERIAL_PORT -4
+
+#define _SERIAL_PARAMS_FLAG_IGNPAR 1
+#define _SERIAL_PARAMS_FLAG_PARMRK 2
+
+#define _TEMP_CHAR_BUFFER_SIZE 256
+#define _SERIAL_BUFFER_SIZE 32768 // power of two, allocated twice over so that a wrapped frame can be viewed contiguously
+#define _SERIAL_MAX_WRITE_FRAMES 16
+#define _SERIAL_WRITE_TIMEOUT 100 // milliseconds a full port may take to make room
+#define _SERIAL_STAMPS 64 // power of two: chunks whose bytes are still in the ring
+#define _SERIAL_SHARE_MAX 16 // connectors on one port
+#define _SERIAL_SHARE_INBOX_SIZE 8192 // power of two
+#define _SERIAL_SHARE_READ_SIZE 1024
+#define _SERIAL_SHARE_LINE_SIZE 128 // a longer line is not told apart: it goes to every member in pieces
+#define _SERIAL_SHARE_KEY_SIZE 12 // the robot address that ends a frame or an identity reply
+
+#ifdef _SERIAL_URING
+#define _SERIAL_URING_ENTRIES 1024 // a read, a write and two cancels per port at most
+#define _SERIAL_URING_TICK 5 // milliseconds between batches
+#define _SERIAL_URING_READ_SIZE 1024
+#define _SERIAL_URING_INBOX_SIZE 8192 // power of two
+#define _SERIAL_URING_OUTBOX_SIZE 1024
+#define _SERIAL_URING_READ 0 // low bits of user_data, the port is the rest
+#define _SERIAL_URING_WRITE 1
+#define _SERIAL_URING_CANCEL 2
+#define _SERIAL_URING_MASK 3
+#endif
+
+struct _serial_frame { // view into the ring, valid until released
+	const char* data;
+	int length;
+	unsigned long long time; // arrival of the chunk that completed it
+};
+
+struct _serial_stamp {
+	unsigned int tail; // the ring's tail after the chunk
+	unsigned long long time;
+};
+
+struct _serial_transport { // byte stream under struct _serial
+	const char* scheme; // port name prefix, NULL for serial ports
+	int reopen; // worth opening again when the link is lost
+	_LONG (*open)(const char* address, int baud_rate, int flow_control); // negative: _SERIAL_ERROR_*
+	int (*close)(_LONG handle);
+	int (*purge)(_LONG handle);
+	int (*count_read_bytes)(_LONG handle);
+	int (*wait_read_bytes)(_LONG handle, int timeout);
+	int (*read_bytes)(_LONG handle, unsigned char* buffer, int buffer_size);
+	int (*write_bytes)(_LONG handle, const unsigned char* buffer, int buffer_size);
+	int (*get_fd)(_LONG handle); // descriptor to poll on, -1 if there is none
+	int (*write_frames)(_LONG handle, const struct _serial_frame* frames, int count); // one gathered write, NULL: joined for write_bytes
+};
+
+struct _serial {
+	const struct _serial_transport* transport;
+	_LONG port_handle;
+	int port_opened;
+	char* buffer; // ring buffer
+	int buffer_size;
+	unsigned int head; // free-running read index
+	unsigned int tail; // free-running write index
+	unsigned int scan; // [head, scan) is known to hold no delimiter
+	unsigned int overflow_bytes; // dropped because the ring was full or a frame did not fit
+	unsigned int overflow_count;
+	struct _capture* capture; // every byte read and written, if capturing; owned by the connector
+	struct _serial_stamp stamps[_SERIAL_STAMPS];
+	unsigned int stamps_head; // free-running
+	unsigned int stamps_tail;
+};
+
+#ifdef _WIN32
+char** _serial_window_get_serial_port_names(const char* keyword, int* count);
+_LONG _serial_window_open_port(const char* port_name);
+int _serial_window_close_port(_LONG port_handle);
+int _serial_window_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags);
+int _serial_window_set_flow_control_mode(_LONG port_handle, int mask);
+int _serial_window_purge_port(_LONG port_handle, int flags);
+int _serial_window_count_read_bytes(_LONG port_handle);
+int _serial_window_wait_read_bytes(_LONG port_handle, int timeout);
+int _serial_window_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size);
+int _serial_window_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size);
+
+#define _serial_port_get_serial_port_names _serial_window_get_serial_port_names
+#define _serial_port_open_port _serial_window_open_port
+#define _serial_port_close_port _serial_window_close_port
+#define _serial_port_set_params _serial_window_set_params
+#define _serial_port_set_flow_control_mode _serial_window_set_flow_control_mode
+#define _serial_port_purge_port _serial_window_purge_port
+#define _serial_port_count_read_bytes _serial_window_count_read_bytes
+#define _serial_port_wait_read_bytes _serial_window_wait_read_bytes
+#define _serial_port_read_bytes _serial_window_read_bytes
+#define _serial_port_write_bytes _serial_window_write_bytes
+#define _serial_port_write_frames NULL // WriteFileGather wants unbuffered files and whole pages
+#else
+char** _serial_posix_get_serial_port_names(const char* keyword, int* count);
+_LONG _serial_posix_open_port(const char* port_name);
+int _serial_posix_close_port(_LONG port_handle);
+int _serial_posix_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags);
+int _serial_posix_set_flow_control_mode(_LONG port_handle, int mask);
+int _serial_posix_purge_port(_LONG port_handle, int flags);
+int _serial_posix_count_read_bytes(_LONG port_handle);
+int _serial_posix_wait_read_bytes(_LONG port_handle, int timeout);
+int _serial_posix_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size);
+int _serial_posix_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size);
+int _serial_posix_wait_writable(int fd);
+int _serial_posix_write_frames(_LONG port_handle, const struct _serial_frame* frames, int count);
+int _serial_posix_write_vector(int fd, const struct _serial_frame* frames, int count, int socket);
+
+#define _serial_port_get_serial_port_names _serial_posix_get_serial_port_names
+#define _serial_port_open_port _serial_posix_open_port
+#define _serial_port_close_port _serial_posix_close_port
+#define _serial_port_set_params _serial_posix_set_params
+#define _serial_port_set_flow_control_mode _serial_posix_set_flow_control_mode
+#define _serial_port_purge_port _serial_posix_purge_port
+#define _serial_port_count_read_bytes _serial_posix_count_read_bytes
+#define _serial_port_wait_read_bytes _serial_posix_wait_read_bytes
+#define _serial_port_read_bytes _serial_posix_read_bytes
+#define _serial_port_write_bytes _serial_posix_write_bytes
+#define _serial_port_write_frames _serial_posix_write_frames
+
+#define _SERIAL_PIPE_MAX 16
+
+_LONG _serial_socket_open_tcp(const char* address, int baud_rate, int flow_control);
+_LONG _serial_socket_open_unix(const char* path, int baud_rate, int flow_control);
+_LONG _serial_socket_open_pipe(const char* name, int baud_rate, int flow_control);
+_LONG _serial_socket_connect(int fd, const struct sockaddr* address, socklen_t address_length);
+_LONG _serial_pipe_connect(const char* name);
+_LONG _serial_pipe_take(const char* name, int side);
+int _serial_socket_close(_LONG handle);
+int _serial_socket_purge(_LONG handle);
+int _serial_socket_wait_read_bytes(_LONG handle, int timeout);
+int _serial_socket_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size);
+int _serial_socket_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size);
+int _serial_socket_write_frames(_LONG handle, const struct _serial_frame* frames, int count);
+#endif
+
+_LONG _serial_port_open(const char* port_name, int baud_rate, int flow_control);
+int _serial_port_purge(_LONG port_handle);
+int _serial_port_get_fd(_LONG port_handle);
+struct _serial_replay;
+const struct _capture_record* _serial_replay_get_record(struct _serial_replay* replay);
+_LONG _serial_replay_open(const char* path, int baud_rate, int flow_control);
+_LONG _serial_replay_open_fast(const char* path, int baud_rate, int flow_control);
+int _serial_replay_close(_LONG handle);
+int _serial_replay_purge(_LONG handle);
+int _serial_replay_count_read_bytes(_LONG handle);
+int _serial_replay_wait_read_bytes(_LONG handle, int timeout);
+int _serial_replay_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size);
+int _serial_replay_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size);
+int _serial_replay_get_fd(_LONG handle);
+#ifdef _SERIAL_URING
+struct _serial_uring;
+struct _serial_uring* _serial_uring_get(void);
+struct _serial_uring* _serial_uring_setup(void);
+void _serial_uring_stop(void);
+int _serial_uring_count_closing(struct _serial_uring* uring);
+struct io_uring_sqe* _serial_uring_get_sqe(struct _serial_uring* uring);
+int _serial_uring_prepare(struct _serial_uring* uring);
+void _serial_uring_complete(struct _serial_uring* uring);
+_THREAD_PROC _serial_uring_thread_proc(void* arg);
+_LONG _serial_uring_open(const char* port_name, int baud_rate, int flow_control);
+int _serial_uring_close(_LONG handle);
+int _serial_uring_purge(_LONG handle);
+int _serial_uring_count_read_bytes(_LONG handle);
+int _serial_uring_wait_read_bytes(_LONG handle, int timeout);
+int _serial_uring_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size);
+int _serial_uring_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size);
+int _serial_uring_get_fd(_LONG handle);
+#endif
+const struct _serial_transport* _serial_get_transport(const char* port_name, const char** address);
+struct _serial_share;
+struct _serial_share_member;
+void _serial_share_start(void);
+struct _serial_share* _serial_share_join(const char* port_name, struct _serial_share_member* member);
+struct _serial_share* _serial_share_create(const char* port_name, const struct _serial_transport* transport, _LONG port_handle, char delimiter);
+int _serial_share_match(const char* key, const char* data);
+void _serial_share_put(struct _serial_share_member* member, const char* data, int length);
+void _serial_share_deliver(struct _serial_share* share, const char* line, int length);
+int _serial_share_pump(struct _serial_share* share);
+int _serial_share_close(_LONG handle);
+int _serial_share_purge(_LONG handle);
+int _serial_share_count_read_bytes(_LONG handle);
+int _serial_share_wait_read_bytes(_LONG handle, int timeout);
+int _serial_share_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size);
+int _serial_share_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size);
+int _serial_share_get_fd(_LONG handle);
+int _serial_share_write_frames(_LONG handle, const struct _serial_frame* frames, int count);
+
+struct _serial* _serial_create(void);
+void _serial_dispose(struct _serial* serial);
+void _serial_attach(struct _serial* serial, const struct _serial_transport* transport, _LONG port_handle);
+int _serial_open(struct _serial* serial, const char* port_name, int baud_rate, int flow_control);
+int _serial_open_shared(struct _serial* serial, const char* port_name, int baud_rate, int flow_control, char delimiter);
+int _serial_claim(struct _serial* serial, const char* key);
+int _serial_is_claimed(const char* port_name, const char* key);
+const void* _serial_get_port(const struct _serial* serial);
+void _serial_close(struct _serial* serial);
+void _serial_clear(struct _serial* serial);
+int _serial_fill(struct _serial* serial);
+int _serial_find(struct _serial* serial, unsigned int start, char delimiter);
+void _serial_copy(const struct _serial* serial, char* buffer, int length);
+void _serial_overflow(struct _serial* serial, int length);
+void _serial_stamp(struct _serial* serial, unsigned long long time);
+unsigned long long _serial_get_stamp(struct _serial* serial, unsigned int* stamp, unsigned int end);
+int _serial_wait(struct _serial* serial, char delimiter, int timeout);
+int _serial_read_string_until(struct _serial* serial, char* buffer, int buffer_size, char delimiter);
+int _serial_read_string_timeout(struct _serial* serial, char* buffer, int buffer_size, char delimiter, int timeout);
+int _serial_read_frames(struct _serial* serial, char delimiter, struct _serial_frame* frames, int max_count);
+void _serial_release_frames(struct _serial* serial, const struct _serial_frame* frames, int count);
+int _serial_write(const struct _serial* serial, const char* buffer, int buffer_size);
+int _serial_write_frames(struct _serial* const* serials, const struct _serial_frame* frames, int count);
+int _serial_can_write(const struct _serial* serial);
+
+#ifdef _WIN32
+
+char** _serial_window_get_serial_port_names(const char* keyword, int* count) {
+	HKEY result;
+	LPCSTR sub_key = "HARDWARE\\DEVICEMAP\\SERIALCOMM\\";
+	char** names = NULL;
+	int names_count = 0;
+	
+	if(RegOpenKeyExA(HKEY_LOCAL_MACHINE, sub_key, 0, KEY_READ, &result) == ERROR_SUCCESS) {
+		int has_more_elements = 1;
+		char value_name[_TEMP_CHAR_BUFFER_SIZE];
+		DWORD keys_count = 0, value_name_size, enum_result;
+		
+		while(has_more_elements == 1) {
+			value_name_size = _TEMP_CHAR_BUFFER_SIZE;
+			enum_result = RegEnumValueA(result, keys_count, value_name, &value_name_size, NULL, NULL, NULL, NULL);
+			if(enum_result == ERROR_SUCCESS) {
+				++ keys_count;
+				if(keyword == NULL || strstr(value_name, keyword) != NULL) {
+					++ names_count;
+				}
+			} else if(enum_result == ERROR_NO_MORE_ITEMS) {
+				has_more_elements = 0;
+			} else {
+				has_more_elements = 0;
+			}
+		}
+		if(names_count > 0) {
+			byte data[_TEMP_CHAR_BUFFER_SIZE];
+			DWORD data_size;
+			int names_index = 0, i;
+			DWORD j;
+			
+			names = (char**)malloc(sizeof(char*) * names_count);
+			for(i = 0; i < names_count; ++i) {
+				names[i] = (char*)malloc(sizeof(char) * _TEMP_CHAR_BUFFER_SIZE);
+			}
+			for(j = 0; j < keys_count; ++j) {
+				value_name_size = _TEMP_CHAR_BUFFER_SIZE;
+				data_size = _TEMP_CHAR_BUFFER_SIZE;
+				enum_result = RegEnumValueA(result, j, value_name, &value_name_size, NULL, NULL, data, &data_size);
+				if(enum_result == ERROR_SUCCESS) {
+					if(keyword == NULL || strstr(value_name, keyword) != NULL) {
+						_STRCPY(names[names_index], _TEMP_CHAR_BUFFER_SIZE, (const char*)data);
+						++ names_index;
+					}
+				}
+			}
+		}
+		CloseHandle(result);
+	}
+	*count = names_count;
+	return names;
+}
+
+_LONG _serial_window_open_port(const char* port_name) {
+	const char* prefix= "\\\\.\\";
+	char port_full_name[_TEMP_CHAR_BUFFER_SIZE];
+	HANDLE comm;
+
+	_STRCPY(port_full_name, _TEMP_CHAR_BUFFER_SIZE, prefix);
+	_STRCAT(port_full_name, _TEMP_CHAR_BUFFER_SIZE, port_name);
+
+	comm = CreateFileA((LPCSTR)port_full_name,
+		GENERIC_READ | GENERIC_WRITE,
+		0,
+		NULL,
+		OPEN_EXISTING,
+		FILE_FLAG_OVERLAPPED,
+		0);
+
+	if(comm != INVALID_HANDLE_VALUE) {
+		DCB dcb = { 0 };
+		dcb.DCBlength = sizeof(DCB);
+		if(!GetCommState(comm, &dcb)) {
+			CloseHandle(comm);
+			comm = (HANDLE)_SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+		}
+	} else {
+		DWORD error_value = GetLastError();
+		if(error_value == ERROR_ACCESS_DENIED) {
+			comm = (HANDLE)_SERIAL_ERROR_PORT_BUSY;
+		} else if(error_value == ERROR_FILE_NOT_FOUND) {
+			comm = (HANDLE)_SERIAL_ERROR_PORT_NOT_FOUND;
+		}
+	}
+	return (_LONG)comm;
+}
+
+int _serial_window_close_port(_LONG port_handle) {
+	return CloseHandle((HANDLE)port_handle) ? 1 : 0;
+}
+
+int _serial_window_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags) {
+	HANDLE comm = (HANDLE)port_handle;
+	int return_value = 0;
+	DCB dcb = { 0 };
+
+	dcb.DCBlength = sizeof(DCB);
+	if(GetCommState(comm, &dcb)) {
+		dcb.BaudRate = baud_rate;
+		dcb.ByteSize = byte_size;
+		dcb.StopBits = stop_bits;
+		dcb.Parity = parity;
+
+		if(set_rts == 1) {
+			dcb.fRtsControl = RTS_CONTROL_ENABLE;
+		} else {
+			dcb.fRtsControl = RTS_CONTROL_DISABLE;
+		}
+		if(set_dtr == 1) {
+			dcb.fDtrControl = DTR_CONTROL_ENABLE;
+		} else {
+			dcb.fDtrControl = DTR_CONTROL_DISABLE;
+		}
+		dcb.fOutxCtsFlow = FALSE;
+		dcb.fOutxDsrFlow = FALSE;
+		dcb.fDsrSensitivity = FALSE;
+		dcb.fTXContinueOnXoff = TRUE;
+		dcb.fOutX = FALSE;
+		dcb.fInX = FALSE;
+		dcb.fErrorChar = FALSE;
+		dcb.fNull = FALSE;
+		dcb.fAbortOnError = FALSE;
+		dcb.XonLim = 2048;
+		dcb.XoffLim = 512;
+		dcb.XonChar = (char)17; //DC1
+		dcb.XoffChar = (char)19; //DC3
+
+		if(SetCommState(comm, &dcb)) {
+			COMMTIMEOUTS comm_timeouts = { 0 };
+			comm_timeouts.ReadIntervalTimeout = 0;
+			comm_timeouts.ReadTotalTimeoutConstant = 100;
+			comm_timeouts.ReadTotalTimeoutMultiplier = 0;
+			comm_timeouts.WriteTotalTimeoutConstant = 0;
+			comm_timeouts.WriteTotalTimeoutMultiplier = 0;
+			if(SetCommTimeouts(comm, &comm_timeouts)) {
+				return_value = 1;
+			}
+		}
+	}
+	return return_value;
+}
+
+int _serial_window_set_flow_control_mode(_LONG port_handle, int mask) {
+	HANDLE comm = (HANDLE)port_handle;
+	int return_value = 0;
+	DCB dcb = { 0 };
+
+	dcb.DCBlength = sizeof(DCB);
+	if(GetCommState(comm, &dcb)) {
+		dcb.fRtsControl = RTS_CONTROL_ENABLE;
+		dcb.fOutxCtsFlow = FALSE;
+		dcb.fOutX = FALSE;
+		dcb.fInX = FALSE;
+		if(mask != _SERIAL_FLOWCONTROL_NONE) {
+			if((mask & _SERIAL_FLOWCONTROL_RTSCTS_IN) == _SERIAL_FLOWCONTROL_RTSCTS_IN) {
+				dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+			}
+			if((mask & _SERIAL_FLOWCONTROL_RTSCTS_OUT) == _SERIAL_FLOWCONTROL_RTSCTS_OUT) {
+				dcb.fOutxCtsFlow = TRUE;
+			}
+			if((mask & _SERIAL_FLOWCONTROL_XONXOFF_IN) == _SERIAL_FLOWCONTROL_XONXOFF_IN) {
+				dcb.fInX = TRUE;
+			}
+			if((mask & _SERIAL_FLOWCONTROL_XONXOFF_OUT) == _SERIAL_FLOWCONTROL_XONXOFF_OUT) {
+				dcb.fOutX = TRUE;
+			}
+		}
+		if(SetCommState(comm, &dcb)) {
+			return_value = 1;
+		}
+	}
+	return return_value;
+}
+
+int _serial_window_purge_port(_LONG port_handle, int flags) {
+	return PurgeComm((HANDLE)port_handle, (DWORD)flags) ? 1 : 0;
+}
+
+int _serial_window_count_read_bytes(_LONG port_handle) {
+	HANDLE comm = (HANDLE)port_handle;
+	DWORD errors;
+	COMSTAT comstat = { 0 };
+	int return_value = -1;
+
+	if(ClearCommError(comm, &errors, &comstat)) {
+		return_value = comstat.cbInQue;
+	} else {
+		return_value = -1;
+	}
+	return return_value;
+}
+
+int _serial_window_wait_read_bytes(_LONG port_handle, int timeout) {
+	HANDLE comm = (HANDLE)port_handle;
+	DWORD event_mask = 0;
+	DWORD number_of_bytes_transferred;
+	OVERLAPPED overlapped = { 0 };
+	int return_value = -1;
+
+	if(!SetCommMask(comm, EV_RXCHAR)) return -1;
+	if(_serial_window_count_read_bytes(port_handle) > 0) return 1;
+
+	overlapped.hEvent = CreateEventA(NULL, 1, 0, NULL);
+	if(WaitCommEvent(comm, &event_mask, &overlapped)) {
+		return_value = 1;
+	} else if(GetLastError() == ERROR_IO_PENDING) {
+		if(WaitForSingleObject(overlapped.hEvent, timeout < 0 ? INFINITE : (DWORD)timeout) == WAIT_OBJECT_0) {
+			return_value = GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 0) ? 1 : -1;
+		} else {
+			// changing the mask completes the pending wait so that overlapped can be released
+			SetCommMask(comm, EV_RXCHAR);
+			GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 1);
+			return_value = 0;
+		}
+	}
+	CloseHandle(overlapped.hEvent);
+	return return_value;
+}
+
+int _serial_window_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size) {
+	HANDLE comm = (HANDLE)port_handle;
+	DWORD number_of_bytes_transferred;
+	DWORD number_of_bytes_read;
+	OVERLAPPED overlapped = { 0 };
+	int return_value = 0;
+
+	overlapped.hEvent = CreateEventA(NULL, 1, 0, NULL);
+	if(ReadFile(comm, buffer, (DWORD)buffer_size, &number_of_bytes_read, &overlapped)) {
+		return_value = number_of_bytes_read;
+	} else if(GetLastError() == ERROR_IO_PENDING) {
+		if(WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
+			if(GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 0)) {
+				return_value = number_of_bytes_transferred;
+			}
+		}
+	}
+	CloseHandle(overlapped.hEvent);
+	return return_value;
+}
+
+int _serial_window_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size) {
+	HANDLE comm = (HANDLE)port_handle;
+	DWORD number_of_bytes_transferred;
+	DWORD number_of_bytes_written;
+	OVERLAPPED overlapped = { 0 };
+	int return_value = 0;
+
+	overlapped.hEvent = CreateEventA(NULL, 1, 0, NULL);
+	if(WriteFile(comm, buffer, buffer_size, &number_of_bytes_written, &overlapped)) {
+		return_value = 1;
+	} else if(GetLastError() == ERROR_IO_PENDING) {
+		if(WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
+			if(GetOverlappedResult(comm, &overlapped, &number_of_bytes_transferred, 0)) {
+				return_value = 1;
+			}
+		}
+	}
+	CloseHandle(overlapped.hEvent);
+	return return_value;
+}
+
+#else
+
+const char* _SERIAL_POSIX_PREFIXES[] = { "ttyUSB", "ttyACM", "cu.usbmodem", "cu.usbserial", NULL };
+
+int _serial_posix_add_port_name(char** names, int count, const char* path) {
+	int i;
+
+	for(i = 0; i < count; ++i) {
+		if(strcmp(names[i], path) == 0) return count;
+	}
+	names[count] = (char*)malloc(sizeof(char) * _TEMP_CHAR_BUFFER_SIZE);
+	_STRNCPY(names[count], _TEMP_CHAR_BUFFER_SIZE, path, _TEMP_CHAR_BUFFER_SIZE - 1);
+	names[count][_TEMP_CHAR_BUFFER_SIZE - 1] = '\0';
+	return count + 1;
+}
+
+char** _serial_posix_get_serial_port_names(const char* keyword, int* count) {
+	char** names = NULL;
+	int names_count = 0, names_size = 16;
+	char path[_TEMP_CHAR_BUFFER_SIZE];
+	char real_path[PATH_MAX];
+	struct dirent* entry;
+	DIR* dir;
+	int i;
+
+	names = (char**)malloc(sizeof(char*) * names_size);
+
+	// stable names first, resolved to the tty node so that a port is listed only once
+	dir = opendir("/dev/serial/by-id");
+	if(dir != NULL) {
+		while((entry = readdir(dir)) != NULL) {
+			if(entry->d_name[0] == '.') continue;
+			if(keyword != NULL && strstr(entry->d_name, keyword) == NULL) continue;
+			if(snprintf(path, _TEMP_CHAR_BUFFER_SIZE, "/dev/serial/by-id/%s", entry->d_name) >= _TEMP_CHAR_BUFFER_SIZE) continue; // too long for a port name
+			if(realpath(path, real_path) == NULL) continue;
+			if(names_count >= names_size) {
+				names_size *= 2;
+				names = (char**)realloc(names, sizeof(char*) * names_size);
+			}
+			names_count = _serial_posix_add_port_name(names, names_count, real_path);
+		}
+		closedir(dir);
+	}
+	dir = opendir("/dev");
+	if(dir != NULL) {
+		while((entry = readdir(dir)) != NULL) {
+			for(i = 0; _SERIAL_POSIX_PREFIXES[i] != NULL; ++i) {
+				if(strncmp(entry->d_name, _SERIAL_POSIX_PREFIXES[i], strlen(_SERIAL_POSIX_PREFIXES[i])) == 0) break;
+			}
+			if(_SERIAL_POSIX_PREFIXES[i] == NULL) continue;
+			if(keyword != NULL && strstr(entry->d_name, keyword) == NULL) continue;
+			if(snprintf(path, _TEMP_CHAR_BUFFER_SIZE, "/dev/%s", entry->d_name) >= _TEMP_CHAR_BUFFER_SIZE) continue;
+			if(names_count >= names_size) {
+				names_size *= 2;
+				names = (char**)realloc(names, sizeof(char*) * names_size);
+			}
+			names_count = _serial_posix_add_port_name(names, names_count, path);
+		}
+		closedir(dir);
+	}
+	if(names_count == 0) {
+		free(names);
+		names = NULL;
+	}
+	*count = names_count;
+	return names;
+}
+
+_LONG _serial_posix_open_port(const char* port_name) {
+	char port_full_name[_TEMP_CHAR_BUFFER_SIZE];
+	struct termios tio;
+	int fd;
+
+	if(port_name[0] == '/') {
+		_STRNCPY(port_full_name, _TEMP_CHAR_BUFFER_SIZE, port_name, _TEMP_CHAR_BUFFER_SIZE - 1);
+		port_full_name[_TEMP_CHAR_BUFFER_SIZE - 1] = '\0';
+	} else {
+		snprintf(port_full_name, _TEMP_CHAR_BUFFER_SIZE, "/dev/%s", port_name);
+	}
+
+	fd = open(port_full_name, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(fd < 0) {
+		if(errno == EBUSY) return _SERIAL_ERROR_PORT_BUSY;
+		if(errno == EACCES) return _SERIAL_ERROR_PERMISSION_DENIED;
+		if(errno == ENOENT) return _SERIAL_ERROR_PORT_NOT_FOUND;
+		return _SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+	}
+	// same exclusive access as CreateFile with no sharing
+	if(flock(fd, LOCK_EX | LOCK_NB) != 0) {
+		close(fd);
+		return _SERIAL_ERROR_PORT_BUSY;
+	}
+	if(tcgetattr(fd, &tio) != 0) {
+		close(fd);
+		return _SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+	}
+#ifdef TIOCEXCL
+	ioctl(fd, TIOCEXCL);
+#endif
+	return (_LONG)fd;
+}
+
+int _serial_posix_close_port(_LONG port_handle) {
+	int fd = (int)port_handle;
+
+	flock(fd, LOCK_UN);
+	return close(fd) == 0 ? 1 : 0;
+}
+
+speed_t _serial_posix_get_speed(int baud_rate) {
+	switch(baud_rate) {
+		case _SERIAL_BAUDRATE_110: return B110;
+		case _SERIAL_BAUDRATE_300: return B300;
+		case _SERIAL_BAUDRATE_600: return B600;
+		case _SERIAL_BAUDRATE_1200: return B1200;
+		case _SERIAL_BAUDRATE_4800: return B4800;
+		case _SERIAL_BAUDRATE_9600: return B9600;
+		case _SERIAL_BAUDRATE_19200: return B19200;
+		case _SERIAL_BAUDRATE_38400: return B38400;
+		case _SERIAL_BAUDRATE_57600: return B57600;
+		case _SERIAL_BAUDRATE_115200: return B115200;
+	}
+	return B0;
+}
+
+int _serial_posix_set_params(_LONG port_handle, int baud_rate, int byte_size, int stop_bits, int parity, int set_rts, int set_dtr, int flags) {
+	int fd = (int)port_handle;
+	struct termios tio;
+	speed_t speed;
+	int modem_bits;
+
+	if(tcgetattr(fd, &tio) != 0) return 0;
+	speed = _serial_posix_get_speed(baud_rate);
+	if(speed == B0) return 0;
+
+	tio.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY | INPCK | IGNPAR);
+	tio.c_oflag &= ~OPOST;
+	tio.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+	tio.c_cflag &= ~(CSIZE | CSTOPB | PARENB | PARODD);
+	tio.c_cflag |= CREAD | CLOCAL;
+
+	switch(byte_size) {
+		case _SERIAL_DATABITS_5: tio.c_cflag |= CS5; break;
+		case _SERIAL_DATABITS_6: tio.c_cflag |= CS6; break;
+		case _SERIAL_DATABITS_7: tio.c_cflag |= CS7; break;
+		default: tio.c_cflag |= CS8; break;
+	}
+	if(stop_bits == 2) { // TWOSTOPBITS
+		tio.c_cflag |= CSTOPB;
+	}
+	if(parity == _SERIAL_PARITY_ODD) {
+		tio.c_cflag |= PARENB | PARODD;
+	} else if(parity == _SERIAL_PARITY_EVEN) {
+		tio.c_cflag |= PARENB;
+	}
+	if((flags & _SERIAL_PARAMS_FLAG_IGNPAR) == _SERIAL_PARAMS_FLAG_IGNPAR) {
+		tio.c_iflag |= IGNPAR;
+	}
+	if((flags & _SERIAL_PARAMS_FLAG_PARMRK) == _SERIAL_PARAMS_FLAG_PARMRK) {
+		tio.c_iflag |= PARMRK;
+	}
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	if(tcsetattr(fd, TCSANOW, &tio) != 0) return 0;
+
+	if(ioctl(fd, TIOCMGET, &modem_bits) == 0) {
+		if(set_rts == 1) modem_bits |= TIOCM_RTS;
+		else modem_bits &= ~TIOCM_RTS;
+		if(set_dtr == 1) modem_bits |= TIOCM_DTR;
+		else modem_bits &= ~TIOCM_DTR;
+		ioctl(fd, TIOCMSET, &modem_bits);
+	}
+	return 1;
+}
+
+int _serial_posix_set_flow_control_mode(_LONG port_handle, int mask) {
+	int fd = (int)port_handle;
+	struct termios tio;
+
+	if(tcgetattr(fd, &tio) != 0) return 0;
+#ifdef CRTSCTS
+	tio.c_cflag &= ~CRTSCTS;
+	if((mask & (_SERIAL_FLOWCONTROL_RTSCTS_IN | _SERIAL_FLOWCONTROL_RTSCTS_OUT)) != 0) {
+		tio.c_cflag |= CRTSCTS;
+	}
+#endif
+	tio.c_iflag &= ~(IXON | IXOFF);
+	if((mask & _SERIAL_FLOWCONTROL_XONXOFF_IN) == _SERIAL_FLOWCONTROL_XONXOFF_IN) {
+		tio.c_iflag |= IXOFF;
+	}
+	if((mask & _SERIAL_FLOWCONTROL_XONXOFF_OUT) == _SERIAL_FLOWCONTROL_XONXOFF_OUT) {
+		tio.c_iflag |= IXON;
+	}
+	return tcsetattr(fd, TCSANOW, &tio) == 0 ? 1 : 0;
+}
+
+int _serial_posix_purge_port(_LONG port_handle, int flags) {
+	int rx = (flags & (_SERIAL_PURGE_RXCLEAR | _SERIAL_PURGE_RXABORT)) != 0;
+	int tx = (flags & (_SERIAL_PURGE_TXCLEAR | _SERIAL_PURGE_TXABORT)) != 0;
+
+	if(rx && tx) return tcflush((int)port_handle, TCIOFLUSH) == 0 ? 1 : 0;
+	if(rx) return tcflush((int)port_handle, TCIFLUSH) == 0 ? 1 : 0;
+	if(tx) return tcflush((int)port_handle, TCOFLUSH) == 0 ? 1 : 0;
+	return 1;
+}
+
+int _serial_posix_count_read_bytes(_LONG port_handle) {
+	int count = 0;
+
+	if(ioctl((int)port_handle, FIONREAD, &count) != 0) return -1;
+	return count;
+}
+
+int _serial_posix_wait_read_bytes(_LONG port_handle, int timeout) {
+	struct pollfd fds;
+	int result;
+
+	fds.fd = (int)port_handle;
+	fds.events = POLLIN;
+	fds.revents = 0;
+	do {
+		result = poll(&fds, 1, timeout);
+	} while(result < 0 && errno == EINTR);
+	if(result < 0) return -1;
+	if(result == 0) return 0;
+	return (fds.revents & POLLIN) != 0 ? 1 : -1;
+}
+
+int _serial_posix_read_bytes(_LONG port_handle, unsigned char* buffer, int buffer_size) {
+	int read_bytes = (int)read((int)port_handle, buffer, (size_t)buffer_size);
+	return read_bytes > 0 ? read_bytes : 0;
+}
+
+int _serial_posix_write_bytes(_LONG port_handle, const unsigned char* buffer, int buffer_size) {
+	int fd = (int)port_handle;
+	int written = 0, n;
+
+	while(written < buffer_size) {
+		n = (int)write(fd, buffer + written, (size_t)(buffer_size - written));
+		if(n > 0) {
+			written += n;
+		} else if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			if(_serial_posix_wait_writable(fd) == 0) return 0;
+		} else {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int _serial_posix_wait_writable(int fd) { // 0: still full after _SERIAL_WRITE_TIMEOUT, or an error
+	struct pollfd fds;
+	int result;
+
+	fds.fd = fd;
+	fds.events = POLLOUT;
+	fds.revents = 0;
+	do {
+		result = poll(&fds, 1, _SERIAL_WRITE_TIMEOUT);
+	} while(result < 0 && errno == EINTR);
+	return (result > 0 && (fds.revents & POLLOUT) != 0) ? 1 : 0;
+}
+
+int _serial_posix_write_frames(_LONG port_handle, const struct _serial_frame* frames, int count) {
+	return _serial_posix_write_vector((int)port_handle, frames, count, 0);
+}
+
+int _serial_posix_write_vector(int fd, const struct _serial_frame* frames, int count, int socket) {
+	struct iovec iov[_SERIAL_MAX_WRITE_FRAMES];
+	struct iovec* next = iov;
+	struct msghdr message;
+	int n, flags = 0, i;
+
+	if(count > _SERIAL_MAX_WRITE_FRAMES) return 0;
+	for(i = 0; i < count; ++i) {
+		iov[i].iov_base = (void*)frames[i].data;
+		iov[i].iov_len = (size_t)frames[i].length;
+	}
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	while(count > 0) {
+		if(socket == 1) {
+			memset(&message, 0, sizeof(message));
+			message.msg_iov = next;
+			message.msg_iovlen = count;
+			n = (int)sendmsg(fd, &message, flags);
+		} else {
+			n = (int)writev(fd, next, count);
+		}
+		if(n > 0) {
+			// skip what went out, a partial one is continued
+			while(count > 0 && (size_t)n >= next->iov_len) {
+				n -= (int)next->iov_len;
+				++ next;
+				-- count;
+			}
+			if(count > 0) {
+				next->iov_base = (char*)next->iov_base + n;
+				next->iov_len -= (size_t)n;
+			}
+		} else if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			if(_serial_posix_wait_writable(fd) == 0) return 0;
+		} else {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+#endif
+
+_LONG _serial_port_open(const char* port_name, int baud_rate, int flow_control) {
+	_LONG port_handle = _serial_port_open_port(port_name);
+
+	if(port_handle < 0) return port_handle;
+	_serial_port_set_params(port_handle, baud_rate, _SERIAL_DATABITS_8, 0, _SERIAL_PARITY_NONE, 1, 1, 0);
+	_serial_port_set_flow_control_mode(port_handle, flow_control);
+	return port_handle;
+}
+
+int _serial_port_purge(_LONG port_handle) {
+	return _serial_port_purge_port(port_handle, _SERIAL_PURGE_RXCLEAR | _SERIAL_PURGE_RXABORT | _SERIAL_PURGE_TXCLEAR | _SERIAL_PURGE_TXABORT);
+}
+
+int _serial_port_get_fd(_LONG port_handle) {
+#ifdef _WIN32
+	return -1;
+#else
+	return (int)port_handle;
+#endif
+}
+
+struct _serial_replay { // the received side of a capture, fed back in time
+	struct _capture* capture;
+	size_t offset; // current record
+	int read_bytes; // of the current record
+	int fast; // jump over idle time instead of waiting
+	unsigned long long start;
+	unsigned long long skipped;
+};
+
+const struct _capture_record* _serial_replay_get_record(struct _serial_replay* replay) {
+	const struct _capture_record* record;
+
+	while((record = _capture_get_record(replay->capture, replay->offset)) != NULL) {
+		if(record->direction == _CAPTURE_RECEIVED && replay->read_bytes < (int)record->length) return record;
+		replay->offset = _capture_next_record(record, replay->offset);
+		replay->read_bytes = 0;
+	}
+	return NULL;
+}
+
+_LONG _serial_replay_open(const char* path, int baud_rate, int flow_control) {
+	struct _serial_replay* replay;
+	struct _capture* capture = _capture_open(path);
+
+	if(capture == NULL) return _SERIAL_ERROR_PORT_NOT_FOUND;
+	replay = (struct _serial_replay*)malloc(sizeof(struct _serial_replay));
+	replay->capture = capture;
+	replay->offset = _CAPTURE_MAGIC_SIZE;
+	replay->read_bytes = 0;
+	replay->fast = 0;
+	replay->start = _clock_get_time();
+	replay->skipped = 0;
+	return (_LONG)replay;
+}
+
+_LONG _serial_replay_open_fast(const char* path, int baud_rate, int flow_control) {
+	_LONG handle = _serial_replay_open(path, baud_rate, flow_control);
+
+	if(handle != _SERIAL_ERROR_PORT_NOT_FOUND) ((struct _serial_replay*)handle)->fast = 1;
+	return handle;
+}
+
+int _serial_replay_close(_LONG handle) {
+	struct _serial_replay* replay = (struct _serial_replay*)handle;
+
+	_capture_close(replay->capture);
+	free(replay);
+	return 1;
+}
+
+int _serial_replay_purge(_LONG handle) {
+	return 1; // the capture starts after the purge it recorded
+}
+
+int _serial_replay_count_read_bytes(_LONG handle) {
+	struct _serial_replay* replay = (struct _serial_replay*)handle;
+	const struct _capture_record* record = _serial_replay_get_record(replay);
+
+	if(record == NULL) return 0;
+	if(record->time > _clock_get_time() - replay->start + replay->skipped) return 0; // not due yet
+	return (int)record->length - replay->read_bytes;
+}
+
+int _serial_replay_wait_read_bytes(_LONG handle, int timeout) {
+	struct _serial_replay* replay = (struct _serial_replay*)handle;
+	const struct _capture_record* record = _serial_replay_get_record(replay);
+	unsigned long long now, wait;
+
+	if(record == NULL) return -1; // end of the capture
+	now = _clock_get_time() - replay->start + replay->skipped;
+	if(record->time <= now) return 1;
+	if(replay->fast == 1) {
+		replay->skipped += record->time - now;
+		return 1;
+	}
+	wait = (record->time - now + _CLOCK_MILLISECOND - 1) / _CLOCK_MILLISECOND;
+	if(wait > (unsigned long long)timeout) {
+		_SLEEP(timeout);
+		return 0;
+	}
+	_SLEEP((int)wait);
+	return 1;
+}
+
+int _serial_replay_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size) {
+	struct _serial_replay* replay = (struct _serial_replay*)handle;
+	const struct _capture_record* record = _serial_replay_get_record(replay);
+	int length;
+
+	if(record == NULL) return 0;
+	length = (int)record->length - replay->read_bytes;
+	if(length > buffer_size) length = buffer_size;
+	memcpy(buffer, (const char*)(record + 1) + replay->read_bytes, (size_t)length);
+	replay->read_bytes += length;
+	return length;
+}
+
+int _serial_replay_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size) {
+	return 1; // what was sent is in the capture too, but nobody is listening
+}
+
+int _serial_replay_get_fd(_LONG handle) {
+	return -1;
+}
+
+#ifndef _WIN32
+
+struct _serial_pipe {
+	char name[_TEMP_CHAR_BUFFER_SIZE];
+	int fds[2];
+	int taken[2];
+};
+
+struct _serial_pipe _serial_pipes[_SERIAL_PIPE_MAX];
+pthread_mutex_t _serial_pipes_lock = PTHREAD_MUTEX_INITIALIZER;
+
+_LONG _serial_socket_connect(int fd, const struct sockaddr* address, socklen_t address_length) {
+	struct pollfd fds;
+	int error = 0;
+	socklen_t error_length = sizeof(error);
+
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	if(connect(fd, address, address_length) != 0) {
+		if(errno != EINPROGRESS) {
+			close(fd);
+			return _SERIAL_ERROR_PORT_NOT_FOUND;
+		}
+		fds.fd = fd;
+		fds.events = POLLOUT;
+		fds.revents = 0;
+		if(poll(&fds, 1, 1000) != 1 || getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_length) != 0 || error != 0) {
+			close(fd);
+			return _SERIAL_ERROR_PORT_NOT_FOUND;
+		}
+	}
+#ifdef SO_NOSIGPIPE
+	error = 1;
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &error, sizeof(error));
+#endif
+	return (_LONG)fd;
+}
+
+_LONG _serial_socket_open_tcp(const char* address, int baud_rate, int flow_control) {
+	char host[_TEMP_CHAR_BUFFER_SIZE];
+	const char* port;
+	struct addrinfo hints, *result, *info;
+	_LONG handle = _SERIAL_ERROR_PORT_NOT_FOUND;
+	int fd, no_delay = 1;
+
+	port = strrchr(address, ':');
+	if(port == NULL || port == address || port - address >= _TEMP_CHAR_BUFFER_SIZE) return _SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+	_STRNCPY(host, _TEMP_CHAR_BUFFER_SIZE, address, port - address);
+	host[port - address] = '\0';
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if(getaddrinfo(host, port + 1, &hints, &result) != 0) return _SERIAL_ERROR_PORT_NOT_FOUND;
+	for(info = result; info != NULL; info = info->ai_next) {
+		fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+		if(fd < 0) continue;
+		handle = _serial_socket_connect(fd, info->ai_addr, info->ai_addrlen);
+		if(handle >= 0) {
+			// motoring packets are small and latency matters more than throughput
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+			break;
+		}
+	}
+	freeaddrinfo(result);
+	return handle;
+}
+
+_LONG _serial_socket_open_unix(const char* path, int baud_rate, int flow_control) {
+	struct sockaddr_un address;
+	int fd;
+
+	if(strlen(path) >= sizeof(address.sun_path)) return _SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	_STRCPY(address.sun_path, sizeof(address.sun_path), path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0) return _SERIAL_ERROR_PORT_NOT_FOUND;
+	return _serial_socket_connect(fd, (const struct sockaddr*)&address, sizeof(address));
+}
+
+_LONG _serial_pipe_take(const char* name, int side) { // side 0: library, side 1: peer
+	struct _serial_pipe* pipe = NULL;
+	_LONG handle = _SERIAL_ERROR_PORT_BUSY;
+	int i;
+
+	if(strlen(name) >= _TEMP_CHAR_BUFFER_SIZE) return _SERIAL_ERROR_INCORRECT_SERIAL_PORT;
+	pthread_mutex_lock(&_serial_pipes_lock);
+	for(i = 0; i < _SERIAL_PIPE_MAX; ++i) {
+		if((_serial_pipes[i].taken[0] != _serial_pipes[i].taken[1]) && strcmp(_serial_pipes[i].name, name) == 0) {
+			pipe = &_serial_pipes[i];
+			break;
+		}
+	}
+	if(pipe == NULL) {
+		for(i = 0; i < _SERIAL_PIPE_MAX; ++i) {
+			if(_serial_pipes[i].taken[0] == 0 && _serial_pipes[i].taken[1] == 0) {
+				pipe = &_serial_pipes[i];
+				if(socketpair(AF_UNIX, SOCK_STREAM, 0, pipe->fds) != 0) {
+					pipe = NULL;
+					break;
+				}
+				_STRCPY(pipe->name, _TEMP_CHAR_BUFFER_SIZE, name);
+				fcntl(pipe->fds[0], F_SETFL, O_NONBLOCK);
+				fcntl(pipe->fds[1], F_SETFL, O_NONBLOCK);
+				break;
+			}
+		}
+	}
+	if(pipe != NULL && pipe->taken[side] == 0) {
+		handle = (_LONG)pipe->fds[side];
+		pipe->taken[side] = 1;
+		if(pipe->taken[1 - side] == 1) {
+			// both ends handed out: the slot can be reused
+			pipe->taken[0] = 0;
+			pipe->taken[1] = 0;
+		}
+	}
+	pthread_mutex_unlock(&_serial_pipes_lock);
+	return handle;
+}
+
+_LONG _serial_socket_open_pipe(const char* name, int baud_rate, int flow_control) {
+	return _serial_pipe_take(name, 0);
+}
+
+_LONG _serial_pipe_connect(const char* name) { // the other end of "pipe://name", for an in-process peer
+	return _serial_pipe_take(name, 1);
+}
+
+int _serial_socket_close(_LONG handle) {
+	return close((int)handle) == 0 ? 1 : 0;
+}
+
+int _serial_socket_purge(_LONG handle) {
+	unsigned char buffer[_TEMP_CHAR_BUFFER_SIZE];
+
+	while(recv((int)handle, buffer, sizeof(buffer), MSG_DONTWAIT) > 0);
+	return 1;
+}
+
+int _serial_socket_wait_read_bytes(_LONG handle, int timeout) {
+	int result = _serial_posix_wait_read_bytes(handle, timeout);
+
+	// readable with nothing to read: the peer has gone
+	if(result == 1 && _serial_posix_count_read_bytes(handle) == 0) return -1;
+	return result;
+}
+
+int _serial_socket_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size) {
+	int read_bytes = (int)recv((int)handle, buffer, (size_t)buffer_size, MSG_DONTWAIT);
+	return read_bytes > 0 ? read_bytes : 0;
+}
+
+int _serial_socket_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size) {
+	int fd = (int)handle;
+	int written = 0, n, flags = 0;
+
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	while(written < buffer_size) {
+		n = (int)send(fd, buffer + written, (size_t)(buffer_size - written), flags);
+		if(n > 0) {
+			written += n;
+		} else if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			if(_serial_posix_wait_writable(fd) == 0) return 0;
+		} else {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int _serial_socket_write_frames(_LONG handle, const struct _serial_frame* frames, int count) {
+	return _serial_posix_write_vector((int)handle, frames, count, 1);
+}
+
+#endif
+
+#ifdef _SERIAL_URING
+
+// one thread submits the reads and writes of every serial port and reaps them together once per tick
+struct _serial_uring_port {
+	int fd;
+	int closing;
+	int cancelled; // the read in flight has been asked to stop
+	int failed; // the port has gone: reads end
+	int reading; // an operation is in flight
+	int writing;
+	unsigned char read_buffer[_SERIAL_URING_READ_SIZE];
+	unsigned char inbox[_SERIAL_URING_INBOX_SIZE]; // read by the kernel, not yet taken by the robot thread
+	unsigned int inbox_head;
+	unsigned int inbox_tail;
+	unsigned char outbox[_SERIAL_URING_OUTBOX_SIZE]; // waiting for the next tick
+	int outbox_length;
+	unsigned char sending[_SERIAL_URING_OUTBOX_SIZE]; // in flight
+	int sending_length;
+	int sent; // by the writes completed so far: a short one is resubmitted for the rest
+	pthread_cond_t readable;
+	struct _serial_uring_port* next;
+};
+
+struct _serial_uring {
+	int fd;
+	unsigned int entries;
+	void* ring;
+	size_t ring_size;
+	struct io_uring_sqe* sqes;
+	unsigned int* sq_head;
+	unsigned int* sq_tail;
+	unsigned int* sq_mask;
+	unsigned int* sq_array;
+	unsigned int* cq_head;
+	unsigned int* cq_tail;
+	unsigned int* cq_mask;
+	struct io_uring_cqe* cqes;
+	int in_flight;
+	volatile int running;
+	_THREAD thread;
+	_MUTEX lock;
+	struct _serial_uring_port* ports;
+};
+
+struct _serial_uring* _serial_uring = NULL; // kept to the end: closed ports are let go of by its thread
+int _serial_uring_failed = 0; // not supported by the kernel: serial ports are read the usual way
+pthread_mutex_t _serial_uring_lock = PTHREAD_MUTEX_INITIALIZER; // of the two above and of running
+
+struct _serial_uring* _serial_uring_get(void) { // NULL: open serial ports without it
+	struct _serial_uring* uring;
+
+	pthread_mutex_lock(&_serial_uring_lock);
+	if(_serial_uring == NULL && _serial_uring_failed == 0) {
+		_serial_uring = _serial_uring_setup();
+		if(_serial_uring == NULL) _serial_uring_failed = 1;
+	}
+	uring = _serial_uring;
+	if(uring != NULL && uring->running == 0) { // stopped by dispose_all, or new
+		uring->running = 1;
+		if(_thread_start(&uring->thread, _serial_uring_thread_proc, uring) == 0) {
+			uring->running = 0;
+		}
+	}
+	if(uring != NULL && uring->running == 0) uring = NULL;
+	pthread_mutex_unlock(&_serial_uring_lock);
+	return uring;
+}
+
+struct _serial_uring* _serial_uring_setup(void) {
+	struct _serial_uring* uring;
+	struct io_uring_params params;
+	size_t sq_size, cq_size;
+	int fd;
+
+	memset(&params, 0, sizeof(params));
+	fd = (int)syscall(__NR_io_uring_setup, _SERIAL_URING_ENTRIES, &params);
+	if(fd < 0) return NULL;
+	// one mapping for both rings and a wait with a timeout in io_uring_enter: 5.11 or later
+	if((params.features & IORING_FEAT_SINGLE_MMAP) == 0 || (params.features & IORING_FEAT_EXT_ARG) == 0) {
+		close(fd);
+		return NULL;
+	}
+	uring = (struct _serial_uring*)malloc(sizeof(struct _serial_uring));
+	uring->fd = fd;
+	uring->entries = params.sq_entries;
+	sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	uring->ring_size = sq_size > cq_size ? sq_size : cq_size;
+	uring->ring = mmap(NULL, uring->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	uring->sqes = (struct io_uring_sqe*)mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if(uring->ring == MAP_FAILED || uring->sqes == MAP_FAILED) {
+		if(uring->ring != MAP_FAILED) munmap(uring->ring, uring->ring_size);
+		if(uring->sqes != MAP_FAILED) munmap(uring->sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+		close(fd);
+		free(uring);
+		return NULL;
+	}
+	uring->sq_head = (unsigned int*)((char*)uring->ring + params.sq_off.head);
+	uring->sq_tail = (unsigned int*)((char*)uring->ring + params.sq_off.tail);
+	uring->sq_mask = (unsigned int*)((char*)uring->ring + params.sq_off.ring_mask);
+	uring->sq_array = (unsigned int*)((char*)uring->ring + params.sq_off.array);
+	uring->cq_head = (unsigned int*)((char*)uring->ring + params.cq_off.head);
+	uring->cq_tail = (unsigned int*)((char*)uring->ring + params.cq_off.tail);
+	uring->cq_mask = (unsigned int*)((char*)uring->ring + params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe*)((char*)uring->ring + params.cq_off.cqes);
+	uring->in_flight = 0;
+	uring->running = 0;
+	uring->ports = NULL;
+	_MUTEX_INIT(&uring->lock);
+	return uring;
+}
+
+void _serial_uring_stop(void) {
+	pthread_mutex_lock(&_serial_uring_lock);
+	if(_serial_uring != NULL && _serial_uring->running == 1) {
+		_serial_uring->running = 0;
+		_thread_join(_serial_uring->thread, -1);
+	}
+	pthread_mutex_unlock(&_serial_uring_lock);
+}
+
+int _serial_uring_count_closing(struct _serial_uring* uring) {
+	struct _serial_uring_port* port;
+	int count = 0;
+
+	for(port = uring->ports; port != NULL; port = port->next) {
+		if(port->closing == 1) ++ count;
+	}
+	return count;
+}
+
+struct io_uring_sqe* _serial_uring_get_sqe(struct _serial_uring* uring) {
+	unsigned int tail = *uring->sq_tail;
+	struct io_uring_sqe* sqe;
+
+	if(tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE) >= uring->entries) return NULL; // next tick
+	sqe = &uring->sqes[tail & *uring->sq_mask];
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	uring->sq_array[tail & *uring->sq_mask] = tail & *uring->sq_mask;
+	__atomic_store_n(uring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	++ uring->in_flight;
+	return sqe;
+}
+
+int _serial_uring_prepare(struct _serial_uring* uring) {
+	struct _serial_uring_port** link = &uring->ports;
+	struct _serial_uring_port* port;
+	struct io_uring_sqe* sqe;
+	int count = 0;
+
+	while((port = *link) != NULL) {
+		if(port->closing == 1) {
+			if(port->reading == 0 && port->writing == 0) { // nothing of it left in the kernel
+				*link = port->next;
+				close(port->fd);
+				pthread_cond_destroy(&port->readable);
+				free(port);
+				continue;
+			}
+			if(port->cancelled == 0 && uring->entries - (*uring->sq_tail - *uring->sq_head) >= 2) {
+				// a read waits for data that may never come, a write for flow control
+				if(port->reading == 1) {
+					sqe = _serial_uring_get_sqe(uring);
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->fd = -1;
+					sqe->addr = (unsigned long long)(uintptr_t)port | _SERIAL_URING_READ;
+					sqe->user_data = (unsigned long long)(uintptr_t)port | _SERIAL_URING_CANCEL;
+					++ count;
+				}
+				if(port->writing == 1) {
+					sqe = _serial_uring_get_sqe(uring);
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->fd = -1;
+					sqe->addr = (unsigned long long)(uintptr_t)port | _SERIAL_URING_WRITE;
+					sqe->user_data = (unsigned long long)(uintptr_t)port | _SERIAL_URING_CANCEL;
+					++ count;
+				}
+				port->cancelled = 1;
+			}
+		} else {
+			if(port->reading == 0 && port->failed == 0 && (sqe = _serial_uring_get_sqe(uring)) != NULL) {
+				sqe->opcode = IORING_OP_READ;
+				sqe->fd = port->fd;
+				sqe->addr = (unsigned long long)(uintptr_t)port->read_buffer;
+				sqe->len = _SERIAL_URING_READ_SIZE;
+				sqe->off = (unsigned long long)-1; // current position: not seekable
+				sqe->user_data = (unsigned long long)(uintptr_t)port | _SERIAL_URING_READ;
+				port->reading = 1;
+				++ count;
+			}
+			if(port->writing == 0 && port->failed == 0 && (port->sent < port->sending_length || port->outbox_length > 0) && (sqe = _serial_uring_get_sqe(uring)) != NULL) {
+				if(port->sent == port->sending_length) {
+					memcpy(port->sending, port->outbox, port->outbox_length);
+					port->sending_length = port->outbox_length;
+					port->sent = 0;
+					port->outbox_length = 0;
+				}
+				sqe->opcode = IORING_OP_WRITE;
+				sqe->fd = port->fd;
+				sqe->addr = (unsigned long long)(uintptr_t)(port->sending + port->sent);
+				sqe->len = port->sending_length - port->sent;
+				sqe->off = (unsigned long long)-1;
+				sqe->user_data = (unsigned long long)(uintptr_t)port | _SERIAL_URING_WRITE;
+				port->writing = 1;
+				++ count;
+			}
+		}
+		link = &port->next;
+	}
+	return count;
+}
+
+void _serial_uring_complete(struct _serial_uring* uring) {
+	struct _serial_uring_port* port;
+	struct io_uring_cqe* cqe;
+	unsigned int head = *uring->cq_head, tail, space, i;
+	int length;
+
+	tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+	for(; head != tail; ++head) {
+		cqe = &uring->cqes[head & *uring->cq_mask];
+		port = (struct _serial_uring_port*)(uintptr_t)(cqe->user_data & ~(unsigned long long)_SERIAL_URING_MASK);
+		-- uring->in_flight;
+		switch(cqe->user_data & _SERIAL_URING_MASK) {
+			case _SERIAL_URING_READ:
+				port->reading = 0;
+				length = cqe->res;
+				if(length > 0) {
+					// full: drop the oldest bytes, as the ring of struct _serial does
+					space = _SERIAL_URING_INBOX_SIZE - (port->inbox_tail - port->inbox_head);
+					if((unsigned int)length > space) port->inbox_head += length - space;
+					for(i = 0; i < (unsigned int)length; ++i) {
+						port->inbox[(port->inbox_tail + i) & (_SERIAL_URING_INBOX_SIZE - 1)] = port->read_buffer[i];
+					}
+					port->inbox_tail += length;
+					pthread_cond_broadcast(&port->readable);
+				} else if(length != -EINTR && length != -EAGAIN && port->closing == 0) {
+					port->failed = 1; // hung up or unplugged
+					pthread_cond_broadcast(&port->readable);
+				}
+				break;
+			case _SERIAL_URING_WRITE:
+				port->writing = 0;
+				length = cqe->res;
+				if(length > 0) {
+					port->sent += length; // the rest of a short write goes with the next tick
+				} else if(length != -EINTR && length != -EAGAIN) {
+					port->sent = port->sending_length;
+					if(port->closing == 0) {
+						port->failed = 1;
+						pthread_cond_broadcast(&port->readable);
+					}
+				}
+				break;
+		}
+	}
+	__atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+_THREAD_PROC _serial_uring_thread_proc(void* arg) {
+	struct _serial_uring* uring = (struct _serial_uring*)arg;
+	struct io_uring_getevents_arg wait;
+	struct __kernel_timespec tick;
+	int count;
+
+	tick.tv_sec = 0;
+	tick.tv_nsec = _SERIAL_URING_TICK * 1000000L;
+	memset(&wait, 0, sizeof(wait));
+	wait.ts = (unsigned long long)(uintptr_t)&tick;
+	while(1) {
+		_MUTEX_LOCK(&uring->lock);
+		if(uring->running == 0 && _serial_uring_count_closing(uring) == 0) { // closed ports are let go of first
+			_MUTEX_UNLOCK(&uring->lock);
+			break;
+		}
+		count = _serial_uring_prepare(uring);
+		_MUTEX_UNLOCK(&uring->lock);
+		// submit this tick's batch and sleep until the tick is over or everything in flight has completed
+		syscall(__NR_io_uring_enter, uring->fd, count, uring->in_flight > 0 ? uring->in_flight : 1,
+			IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait, sizeof(wait));
+		_MUTEX_LOCK(&uring->lock);
+		_serial_uring_complete(uring);
+		_MUTEX_UNLOCK(&uring->lock);
+	}
+	return 0;
+}
+
+_LONG _serial_uring_open(const char* port_name, int baud_rate, int flow_control) {
+	struct _serial_uring* uring = _serial_uring;
+	struct _serial_uring_port* port;
+	_LONG fd = _serial_port_open(port_name, baud_rate, flow_control);
+
+	if(fd < 0) return fd;
+	fcntl((int)fd, F_SETFL, fcntl((int)fd, F_GETFL) & ~O_NONBLOCK); // reads wait in the kernel, not in EAGAIN
+	port = (struct _serial_uring_port*)malloc(sizeof(struct _serial_uring_port));
+	port->fd = (int)fd;
+	port->closing = 0;
+	port->cancelled = 0;
+	port->failed = 0;
+	port->reading = 0;
+	port->writing = 0;
+	port->inbox_head = 0;
+	port->inbox_tail = 0;
+	port->outbox_length = 0;
+	port->sending_length = 0;
+	port->sent = 0;
+	_COND_INIT(&port->readable);
+	_MUTEX_LOCK(&uring->lock);
+	port->next = uring->ports;
+	uring->ports = port;
+	_MUTEX_UNLOCK(&uring->lock);
+	return (_LONG)port;
+}
+
+int _serial_uring_close(_LONG handle) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+
+	_MUTEX_LOCK(&_serial_uring->lock);
+	port->closing = 1; // the uring thread closes it once the kernel has let go of its buffers
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	return 1;
+}
+
+int _serial_uring_purge(_LONG handle) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+
+	_MUTEX_LOCK(&_serial_uring->lock);
+	port->inbox_head = port->inbox_tail;
+	port->outbox_length = 0;
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	tcflush(port->fd, TCIOFLUSH);
+	return 1;
+}
+
+int _serial_uring_count_read_bytes(_LONG handle) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+	int count;
+
+	_MUTEX_LOCK(&_serial_uring->lock);
+	count = (int)(port->inbox_tail - port->inbox_head);
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	return count;
+}
+
+int _serial_uring_wait_read_bytes(_LONG handle, int timeout) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+	struct timespec until;
+	int result;
+
+	_cond_get_until(&until, timeout);
+	_MUTEX_LOCK(&_serial_uring->lock);
+	while(port->inbox_tail == port->inbox_head && port->failed == 0) {
+		if(pthread_cond_timedwait(&port->readable, &_serial_uring->lock, &until) != 0) break;
+	}
+	result = (port->inbox_tail != port->inbox_head) ? 1 : (port->failed == 1 ? -1 : 0);
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	return result;
+}
+
+int _serial_uring_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+	int count, i;
+
+	_MUTEX_LOCK(&_serial_uring->lock);
+	count = (int)(port->inbox_tail - port->inbox_head);
+	if(count > buffer_size) count = buffer_size;
+	for(i = 0; i < count; ++i) {
+		buffer[i] = port->inbox[(port->inbox_head + i) & (_SERIAL_URING_INBOX_SIZE - 1)];
+	}
+	port->inbox_head += count;
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	return count;
+}
+
+int _serial_uring_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size) {
+	struct _serial_uring_port* port = (struct _serial_uring_port*)handle;
+	int result = 0;
+
+	_MUTEX_LOCK(&_serial_uring->lock);
+	if(port->failed == 0 && port->outbox_length + buffer_size <= _SERIAL_URING_OUTBOX_SIZE) {
+		memcpy(port->outbox + port->outbox_length, buffer, buffer_size);
+		port->outbox_length += buffer_size;
+		result = 1;
+	}
+	_MUTEX_UNLOCK(&_serial_uring->lock);
+	return result;
+}
+
+int _serial_uring_get_fd(_LONG handle) {
+	return -1; // waited on through its condition
+}
+
+const struct _serial_transport _SERIAL_URING_TRANSPORT = { NULL, 1, _serial_uring_open, _serial_uring_close, _serial_uring_purge, _serial_uring_count_read_bytes, _serial_uring_wait_read_bytes, _serial_uring_read_bytes, _serial_uring_write_bytes, _serial_uring_get_fd, NULL };
+
+#endif
+
+const struct _serial_transport _SERIAL_TRANSPORTS[] = {
+#ifndef _WIN32
+	{ "tcp://", 1, _serial_socket_open_tcp, _serial_socket_close, _serial_socket_purge, _serial_posix_count_read_bytes, _serial_socket_wait_read_bytes, _serial_socket_read_bytes, _serial_socket_write_bytes, _serial_port_get_fd, _serial_socket_write_frames },
+	{ "unix://", 1, _serial_socket_open_unix, _serial_socket_close, _serial_socket_purge, _serial_posix_count_read_bytes, _serial_socket_wait_read_bytes, _serial_socket_read_bytes, _serial_socket_write_bytes, _serial_port_get_fd, _serial_socket_write_frames },
+	{ "pipe://", 1, _serial_socket_open_pipe, _serial_socket_close, _serial_socket_purge, _serial_posix_count_read_bytes, _serial_socket_wait_read_bytes, _serial_socket_read_bytes, _serial_socket_write_bytes, _serial_port_get_fd, _serial_socket_write_frames },
+#endif
+	{ "replay://", 0, _serial_replay_open, _serial_replay_close, _serial_replay_purge, _serial_replay_count_read_bytes, _serial_replay_wait_read_bytes, _serial_replay_read_bytes, _serial_replay_write_bytes, _serial_replay_get_fd, NULL },
+	{ "replay-fast://", 0, _serial_replay_open_fast, _serial_replay_close, _serial_replay_purge, _serial_replay_count_read_bytes, _serial_replay_wait_read_bytes, _serial_replay_read_bytes, _serial_replay_write_bytes, _serial_replay_get_fd, NULL },
+	{ NULL, 1, _serial_port_open, _serial_port_close_port, _serial_port_purge, _serial_port_count_read_bytes, _serial_port_wait_read_bytes, _serial_port_read_bytes, _serial_port_write_bytes, _serial_port_get_fd, _serial_port_write_frames }
+};
+
+const struct _serial_transport* _serial_get_transport(const char* port_name, const char** address) {
+	const struct _serial_transport* transport = _SERIAL_TRANSPORTS;
+	int length;
+
+	for(; transport->scheme != NULL; ++transport) {
+		length = strlen(transport->scheme);
+		if(strncmp(port_name, transport->scheme, length) == 0) {
+			*address = port_name + length;
+			return transport;
+		}
+	}
+	*address = port_name;
+#ifdef _SERIAL_URING
+	if(_serial_uring_get() != NULL) {
+		return &_SERIAL_URING_TRANSPORT;
+	}
+#endif
+	return transport; // serial port
+}
+
+// robots behind one bridge: the connectors that name the same port get one handle on it, each its own
+// struct _serial over a member of the share; lines are handed to the member whose robot they are from
+struct _serial_share_member {
+	struct _serial_share* share;
+	char key[_SERIAL_SHARE_KEY_SIZE + 1]; // address of the robot claimed, "" while looking for one
+	char* inbox; // routed to this member, not yet read
+	unsigned int head;
+	unsigned int tail;
+};
+
+struct _serial_share {
+	char* port_name;
+	const struct _serial_transport* transport; // of the port itself
+	_LONG port_handle;
+	char delimiter;
+	struct _serial_share_member* members[_SERIAL_SHARE_MAX];
+	int members_count;
+	int polling; // a member waits on the port for all of them
+	int failed; // the port has gone: not joined again
+	char line[_SERIAL_SHARE_LINE_SIZE]; // the beginning of the line being routed
+	int line_length;
+	_MUTEX lock; // members, routing and inboxes
+	_MUTEX write_lock;
+	_COND arrived; // something routed, or the port has gone
+	struct _serial_share* next;
+};
+
+struct _serial_share* _serial_shares = NULL;
+_MUTEX _serial_shares_lock;
+int _serial_shares_ready = 0;
+
+void _serial_share_start(void) { // before the first connector opens a port, from the thread that creates robots
+	if(_serial_shares_ready == 1) return;
+	_MUTEX_INIT(&_serial_shares_lock);
+	_serial_shares_ready = 1;
+}
+
+struct _serial_share* _serial_share_join(const char* port_name, struct _serial_share_member* member) { // registry locked
+	struct _serial_share* share;
+
+	for(share = _serial_shares; share != NULL; share = share->next) {
+		if(share->failed == 0 && strcmp(share->port_name, port_name) == 0) break;
+	}
+	if(share == NULL || share->members_count >= _SERIAL_SHARE_MAX) return NULL;
+	_MUTEX_LOCK(&share->lock);
+	member->share = share;
+	share->members[share->members_count++] = member;
+	_MUTEX_UNLOCK(&share->lock);
+	return share;
+}
+
+struct _serial_share* _serial_share_create(const char* port_name, const struct _serial_transport* transport, _LONG port_handle, char delimiter) { // registry locked
+	struct _serial_share* share = (struct _serial_share*)malloc(sizeof(struct _serial_share));
+	int length = strlen(port_name) + 1;
+
+	share->port_name = (char*)malloc(sizeof(char) * length);
+	_STRCPY(share->port_name, length, port_name);
+	share->transport = transport;
+	share->port_handle = port_handle;
+	share->delimiter = delimiter;
+	share->members_count = 0;
+	share->polling = 0;
+	share->failed = 0;
+	share->line_length = 0;
+	_MUTEX_INIT(&share->lock);
+	_MUTEX_INIT(&share->write_lock);
+	_COND_INIT(&share->arrived);
+	share->next = _serial_shares;
+	_serial_shares = share;
+	return share;
+}
+
+int _serial_share_match(const char* key, const char* data) {
+	int i;
+
+	if(key[0] == '\0') return 0;
+	for(i = 0; i < _SERIAL_SHARE_KEY_SIZE; ++i) {
+		if(((unsigned char)key[i] | 0x20) != ((unsigned char)data[i] | 0x20)) return 0;
+	}
+	return 1;
+}
+
+void _serial_share_put(struct _serial_share_member* member, const char* data, int length) {
+	unsigned int space = _SERIAL_SHARE_INBOX_SIZE - (member->tail - member->head);
+	int i;
+
+	// full: drop the oldest bytes, as the ring of struct _serial does
+	if((unsigned int)length > space) member->head += length - space;
+	for(i = 0; i < length; ++i) {
+		member->inbox[(member->tail + i) & (_SERIAL_SHARE_INBOX_SIZE - 1)] = data[i];
+	}
+	member->tail += length;
+}
+
+void _serial_share_deliver(struct _serial_share* share, const char* line, int length) { // share locked
+	const char* key = line + length - 1 - _SERIAL_SHARE_KEY_SIZE;
+	int keyed, i;
+
+	// frames end in -<address>, identity replies in ,<address>
+	keyed = (length > _SERIAL_SHARE_KEY_SIZE + 1 && line[length - 1] == share->delimiter && (key[-1] == '-' || key[-1] == ',')) ? 1 : 0;
+	if(keyed == 1) {
+		for(i = 0; i < share->members_count; ++i) {
+			if(_serial_share_match(share->members[i]->key, key) == 1) {
+				// its robot's frames; the reply of its robot to another member's request is of no use to anyone
+				if(key[-1] == '-') _serial_share_put(share->members[i], line, length);
+				return;
+			}
+		}
+	}
+	// unclaimed robots and lines without an address, for every member still looking for its robot
+	for(i = 0; i < share->members_count; ++i) {
+		if(keyed == 0 || share->members[i]->key[0] == '\0') {
+			_serial_share_put(share->members[i], line, length);
+		}
+	}
+}
+
+int _serial_share_pump(struct _serial_share* share) { // share locked: what the port has, to the members it is for
+	char buffer[_SERIAL_SHARE_READ_SIZE];
+	int read_bytes, total = 0, i;
+
+	while(share->transport->count_read_bytes(share->port_handle) > 0) {
+		read_bytes = share->transport->read_bytes(share->port_handle, (unsigned char*)buffer, _SERIAL_SHARE_READ_SIZE);
+		if(read_bytes <= 0) break;
+		for(i = 0; i < read_bytes; ++i) {
+			share->line[share->line_length++] = buffer[i];
+			if(buffer[i] == share->delimiter || share->line_length == _SERIAL_SHARE_LINE_SIZE) {
+				_serial_share_deliver(share, share->line, share->line_length);
+				share->line_length = 0;
+			}
+		}
+		total += read_bytes;
+	}
+	if(total > 0) {
+		_COND_BROADCAST(&share->arrived);
+	}
+	return total;
+}
+
+int _serial_share_close(_LONG handle) {
+	struct _serial_share_member* member = (struct _serial_share_member*)handle;
+	struct _serial_share* share = member->share;
+	struct _serial_share** link;
+	int i, last;
+
+	_MUTEX_LOCK(&_serial_shares_lock);
+	_MUTEX_LOCK(&share->lock);
+	for(i = 0; i < share->members_count; ++i) {
+		if(share->members[i] == member) {
+			share->members[i] = share->members[--share->members_count];
+			break;
+		}
+	}
+	if(share->members_count == 1 && share->line_length > 0) {
+		// the one left reads the port itself from now on: the start of the next line is its
+		_serial_share_put(share->members[0], share->line, share->line_length);
+		share->line_length = 0;
+	}
+	last = (share->members_count == 0) ? 1 : 0;
+	if(last == 1) {
+		for(link = &_serial_shares; *link != share; link = &(*link)->next);
+		*link = share->next;
+	}
+	_MUTEX_UNLOCK(&share->lock);
+	_MUTEX_UNLOCK(&_serial_shares_lock);
+
+	free(member->inbox);
+	free(member);
+	if(last == 1) {
+		share->transport->close(share->port_handle);
+		_MUTEX_DESTROY(&share->lock);
+		_MUTEX_DESTROY(&share->write_lock);
+		_COND_DESTROY(&share->arrived);
+		free(share->port_name);
+		free(share);
+	}
+	return 1;
+}
+
+int _serial_share_purge(_LONG handle) {
+	struct _serial_share_member* member = (struct _serial_share_member*)handle;
+	struct _serial_share* share = member->share;
+
+	_MUTEX_LOCK(&share->lock);
+	member->head = member->tail;
+	if(share->members_count == 1) { // what is waiting in the port may be for the others
+		share->transport->purge(share->port_handle);
+	}
+	_MUTEX_UNLOCK(&share->lock);
+	return 1;
+}
+
+int _serial_share_count_read_bytes(_LONG handle) {
+	struct _serial_share_member* member = (struct _serial_share_member*)handle;
+	struct _serial_share* share = member->share;
+	int count;
+
+	_MUTEX_LOCK(&share->lock);
+	count = (int)(member->tail - member->head);
+	if(count == 0) {
+		if(share->members_count == 1) {
+			count = share->transport->count_read_bytes(share->port_handle); // alone: straight from the port
+		} else {
+			_serial_share_pump(share);
+			count = (int)(member->tail - member->head);
+		}
+	}
+	_MUTEX_UNLOCK(&share->lock);
+	return count;
+}
+
+int _serial_share_wait_read_bytes(_LONG handle, int timeout) {
+	struct _serial_share_member* member = (struct _serial_share_member*)handle;
+	struct _serial_share* share = member->share;
+	unsigned long long deadline = _clock_get_time() + (unsigned long long)timeout * _CLOCK_MILLISECOND, now;
+	int result = 0, remaining;
+
+	_MUTEX_LOCK(&share->lock);
+	if(share->members_count == 1 && member->tail == member->head) {
+		_MUTEX_UNLOCK(&share->lock);
+		return share->transport->wait_read_bytes(share->port_handle, timeout);
+	}
+	// one member at a time waits on the port and routes what came for everyone, the others on arrived
+	while(member->tail == member->head && share->failed == 0) {
+		now = _clock_get_time();
+		if(now >= deadline) break;
+		remaining = (int)((deadline - now + _CLOCK_MILLISECOND - 1) / _CLOCK_MILLISECOND);
+		if(share->polling == 0) {
+			share->polling = 1;
+			_MUTEX_UNLOCK(&share->lock);
+			result = share->transport->wait_read_bytes(share->port_handle, remaining);
+			_MUTEX_LOCK(&share->lock);
+			share->polling = 0;
+			if(result > 0) {
+				_serial_share_pump(share);
+			} else if(result < 0) {
+				share->failed = 1;
+			}
+			_COND_BROADCAST(&share->arrived); // another member may have to take over the waiting
+		} else {
+			_cond_wait(&share->arrived, &share->lock, remaining);
+		}
+	}
+	result = (member->tail != member->head) ? 1 : (share->failed == 1 ? -1 : 0);
+	_MUTEX_UNLOCK(&share->lock);
+	return result;
+}
+
+int _serial_share_read_bytes(_LONG handle, unsigned char* buffer, int buffer_size) {
+	struct _serial_share_member* member = (struct _serial_share_member*)handle;
+	struct _serial_share* share = member->share;
+	int count, i;
+
+	_MUTEX_LOCK(&share->lock);
+	if(member->tail == member->head) {
+		if(share->members_count == 1) {
+			count = share->transport->read_bytes(share->port_handle, buffer, buffer_size);
+			_MUTEX_UNLOCK(&share->lock);
+			return count;
+		}
+		_serial_share_pump(share);
+	}
+	count = (int)(member->tail - member->head);
+	if(count > buffer_size) count = buffer_size;
+	for(i = 0; i < count; ++i) {
+		buffer[i] = (unsigned char)member->inbox[(member->head + i) & (_SERIAL_SHARE_INBOX_SIZE - 1)];
+	}
+	member->head += count;
+	_MUTEX_UNLOCK(&share->lock);
+	return count;
+}
+
+int _serial_share_write_bytes(_LONG handle, const unsigned char* buffer, int buffer_size) {
+	struct _serial_share* share = ((struct _serial_share_member*)handle)->share;
+	int result;
+
+	_MUTEX_LOCK(&share->write_lock);
+	result = share->transport->write_bytes(share->port_handle, buffer, buffer_size);
+	_MUTEX_UNLOCK(&share->write_lock);
+	return result;
+}
+
+int _serial_share_get_fd(_LONG handle) {
+	struct _serial_share* share = ((struct _serial_share_member*)handle)->share;
+
+	return share->transport->get_fd(share->port_handle);
+}
+
+int _serial_share_write_frames(_LONG handle, const struct _serial_frame* frames, int count) {
+	struct _serial_share* share = ((struct _serial_share_member*)handle)->share;
+	char buffer[_SERIAL_MAX_WRITE_FRAMES * _TEMP_CHAR_BUFFER_SIZE];
+	int result, length = 0, i;
+
+	if(count > _SERIAL_MAX_WRITE_FRAMES) return 0;
+	if(share->transport->write_frames == NULL) {
+		for(i = 0; i < count; ++i) {
+			if(length + frames[i].length > (int)sizeof(buffer)) return 0;
+			memcpy(buffer + length, frames[i].data, frames[i].length);
+			length += frames[i].length;
+		}
+	}
+	_MUTEX_LOCK(&share->write_lock);
+	if(share->transport->write_frames != NULL) {
+		result = share->transport->write_frames(share->port_handle, frames, count);
+	} else {
+		result = share->transport->write_bytes(share->port_handle, (const unsigned char*)buffer, length);
+	}
+	_MUTEX_UNLOCK(&share->write_lock);
+	return result;
+}
+
+const struct _serial_transport _SERIAL_SHARE_TRANSPORT = { NULL, 1, NULL, _serial_share_close, _serial_share_purge, _serial_share_count_read_bytes, _serial_share_wait_read_bytes, _serial_share_read_bytes, _serial_share_write_bytes, _serial_share_get_fd, _serial_share_write_frames };
+
+struct _serial* _serial_create(void) {
+	struct _serial* serial = (struct _serial*)malloc(sizeof(struct _serial));
+	serial->transport = NULL;
+	serial->port_handle = 0;
+	serial->port_opened = 0;
+	serial->buffer = NULL;
+	serial->buffer_size = 0;
+	serial->head = 0;
+	serial->tail = 0;
+	serial->scan = 0;
+	serial->overflow_bytes = 0;
+	serial->overflow_count = 0;
+	serial->capture = NULL;
+	serial->stamps_head = 0;
+	serial->stamps_tail = 0;
+	return serial;
+}
+
+void _serial_dispose(struct _serial* serial) {
+	if(serial == NULL) return;
+	_serial_close(serial); // free buffer
+	free(serial);
+}
+
+int _serial_open(struct _serial* serial, const char* port_name, int baud_rate, int flow_control) {
+	const struct _serial_transport* transport;
+	const char* address;
+	_LONG port_handle;
+
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 1) return 0;
+	
+	transport = _serial_get_transport(port_name, &address);
+	port_handle = transport->open(address, baud_rate, flow_control);
+	if(port_handle == _SERIAL_ERROR_PORT_BUSY) return 0;
+	else if(port_handle == _SERIAL_ERROR_PORT_NOT_FOUND) return 0;
+	else if(port_handle == _SERIAL_ERROR_PERMISSION_DENIED) return 0;
+	else if(port_handle == _SERIAL_ERROR_INCORRECT_SERIAL_PORT) return 0;
+	
+	_serial_attach(serial, transport, port_handle);
+	return 1;
+}
+
+void _serial_attach(struct _serial* serial, const struct _serial_transport* transport, _LONG port_handle) {
+	serial->transport = transport;
+	serial->port_handle = port_handle;
+	serial->port_opened = 1;
+	serial->head = 0;
+	serial->tail = 0;
+	serial->stamps_head = serial->stamps_tail;
+	
+	if(serial->buffer == NULL) {
+		serial->buffer_size = _SERIAL_BUFFER_SIZE;
+		serial->buffer = (char*)malloc(sizeof(char) * _SERIAL_BUFFER_SIZE * 2);
+	}
+}
+
+int _serial_open_shared(struct _serial* serial, const char* port_name, int baud_rate, int flow_control, char delimiter) {
+	const struct _serial_transport* transport;
+	const char* address;
+	struct _serial_share* share;
+	struct _serial_share_member* member;
+	_LONG port_handle;
+
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 1) return 0;
+
+	transport = _serial_get_transport(port_name, &address);
+	if(transport->reopen == 0 || _serial_shares_ready == 0) { // a recording is of one robot
+		return _serial_open(serial, port_name, baud_rate, flow_control);
+	}
+	member = (struct _serial_share_member*)malloc(sizeof(struct _serial_share_member));
+	member->key[0] = '\0';
+	member->inbox = (char*)malloc(sizeof(char) * _SERIAL_SHARE_INBOX_SIZE);
+	member->head = 0;
+	member->tail = 0;
+
+	_MUTEX_LOCK(&_serial_shares_lock);
+	share = _serial_share_join(port_name, member);
+	_MUTEX_UNLOCK(&_serial_shares_lock);
+	if(share == NULL) {
+		// opened outside the lock: the parallel probe opens many ports at once and some take their time
+		port_handle = transport->open(address, baud_rate, flow_control);
+		_MUTEX_LOCK(&_serial_shares_lock);
+		share = _serial_share_join(port_name, member); // another connector may have opened it in the meantime
+		if(share == NULL && port_handle >= 0) {
+			share = _serial_share_create(port_name, transport, port_handle, delimiter);
+			member->share = share;
+			share->members[share->members_count++] = member;
+		} else if(port_handle >= 0) {
+			transport->close(port_handle);
+		}
+		_MUTEX_UNLOCK(&_serial_shares_lock);
+	}
+	if(share == NULL) {
+		free(member->inbox);
+		free(member);
+		return 0;
+	}
+	_serial_attach(serial, &_SERIAL_SHARE_TRANSPORT, (_LONG)member);
+	return 1;
+}
+
+int _serial_claim(struct _serial* serial, const char* key) { // 0 if another connector on the port has the robot
+	struct _serial_share_member* member;
+	struct _serial_share* share;
+	int result = 1, i;
+
+	if(serial == NULL || serial->transport != &_SERIAL_SHARE_TRANSPORT) return 1;
+	member = (struct _serial_share_member*)serial->port_handle;
+	share = member->share;
+	_MUTEX_LOCK(&share->lock);
+	for(i = 0; i < share->members_count; ++i) {
+		if(share->members[i] != member && _serial_share_match(share->members[i]->key, key) == 1) {
+			result = 0;
+			break;
+		}
+	}
+	if(result == 1) {
+		_STRNCPY(member->key, _SERIAL_SHARE_KEY_SIZE + 1, key, _SERIAL_SHARE_KEY_SIZE);
+		member->key[_SERIAL_SHARE_KEY_SIZE] = '\0';
+	}
+	_MUTEX_UNLOCK(&share->lock);
+	return result;
+}
+
+int _serial_is_claimed(const char* port_name, const char* key) { // by a connector on the port, if it is open
+	struct _serial_share* share;
+	int result = 0, i;
+
+	if(_serial_shares_ready == 0) return 0;
+	_MUTEX_LOCK(&_serial_shares_lock);
+	for(share = _serial_shares; share != NULL; share = share->next) {
+		if(share->failed == 0 && strcmp(share->port_name, port_name) == 0) break;
+	}
+	if(share != NULL) {
+		_MUTEX_LOCK(&share->lock);
+		for(i = 0; i < share->members_count && result == 0; ++i) {
+			result = _serial_share_match(share->members[i]->key, key);
+		}
+		_MUTEX_UNLOCK(&share->lock);
+	}
+	_MUTEX_UNLOCK(&_serial_shares_lock);
+	return result;
+}
+
+const void* _serial_get_port(const struct _serial* serial) { // serials with the same one can be written together
+	if(serial->transport == &_SERIAL_SHARE_TRANSPORT) {
+		return ((const struct _serial_share_member*)serial->port_handle)->share;
+	}
+	return serial;
+}
+
+void _serial_close(struct _serial* serial) {
+	if(serial == NULL) return;
+	if(serial->port_opened == 0) return;
+
+	serial->buffer_size = 0;
+	if(serial->buffer != NULL) {
+		free(serial->buffer);
+		serial->buffer = NULL;
+	}
+	if(serial->transport->close(serial->port_handle) == 1) {
+		serial->port_opened = 0;
+	}
+	serial->head = 0;
+	serial->tail = 0;
+	serial->port_handle = 0;
+	serial->capture = NULL; // kept by the connector for the next open
+}
+
+void _serial_clear(struct _serial* serial) {
+	if(serial == NULL) return;
+	if(serial->port_opened == 0) return;
+	
+	serial->head = serial->tail;
+	serial->stamps_head = serial->stamps_tail;
+	serial->transport->purge(serial->port_handle);
+}
+
+int _serial_fill(struct _serial* serial) {
+	const struct _serial_transport* transport = serial->transport;
+	_LONG port_handle = serial->port_handle;
+	unsigned int mask = (unsigned int)serial->buffer_size - 1;
+	int to_read, read_bytes, space, total = 0;
+
+	to_read = transport->count_read_bytes(port_handle);
+	while(to_read > 0 && total < serial->buffer_size) {
+		// read straight into the ring, at most up to its physical end
+		space = serial->buffer_size - (int)(serial->tail & mask);
+		if(to_read > space) to_read = space;
+		space = serial->buffer_size - (int)(serial->tail - serial->head);
+		if(space < to_read) {
+			// full: drop the oldest bytes instead of growing
+			_serial_overflow(serial, to_read - space);
+		}
+		read_bytes = transport->read_bytes(port_handle, (unsigned char*)(serial->buffer + (serial->tail & mask)), to_read);
+		if(read_bytes <= 0) break;
+		if(serial->capture != NULL) {
+			_capture_append(serial->capture, _CAPTURE_RECEIVED, serial->buffer + (serial->tail & mask), read_bytes);
+		}
+		serial->tail += read_bytes;
+		total += read_bytes;
+		_serial_stamp(serial, _clock_get_time());
+		to_read = transport->count_read_bytes(port_handle);
+	}
+	return total;
+}
+
+int _serial_find(struct _serial* serial, unsigned int start, char delimiter) {
+	unsigned int mask = (unsigned int)serial->buffer_size - 1;
+	const char* segment;
+	const char* found;
+	int length;
+
+	// resume where the last scan stopped; bytes of a partial frame are looked at only once
+	if(serial->scan - start > serial->tail - start) {
+		serial->scan = start;
+	}
+	while(serial->scan != serial->tail) {
+		segment = serial->buffer + (serial->scan & mask);
+		length = serial->buffer_size - (int)(serial->scan & mask);
+		if(length > (int)(serial->tail - serial->scan)) {
+			length = (int)(serial->tail - serial->scan);
+		}
+		found = (const char*)memchr(segment, delimiter, (size_t)length);
+		if(found != NULL) {
+			serial->scan += (unsigned int)(found - segment);
+			return (int)(serial->scan - start) + 1;
+		}
+		serial->scan += (unsigned int)length;
+	}
+	return 0;
+}
+
+void _serial_copy(const struct _serial* serial, char* buffer, int length) {
+	int start = (int)(serial->head & ((unsigned int)serial->buffer_size - 1));
+	int first = serial->buffer_size - start;
+
+	if(first >= length) {
+		memcpy(buffer, serial->buffer + start, length);
+	} else {
+		memcpy(buffer, serial->buffer + start, first);
+		memcpy(buffer + first, serial->buffer, length - first);
+	}
+}
+
+void _serial_overflow(struct _serial* serial, int length) {
+	serial->head += length;
+	serial->overflow_bytes += length;
+	serial->overflow_count ++;
+}
+
+void _serial_stamp(struct _serial* serial, unsigned long long time) {
+	struct _serial_stamp* stamp;
+
+	// forget the chunks that have been read out
+	while(serial->stamps_head != serial->stamps_tail && (int)(serial->stamps[serial->stamps_head & (_SERIAL_STAMPS - 1)].tail - serial->head) <= 0) {
+		++ serial->stamps_head;
+	}
+	if(serial->stamps_tail - serial->stamps_head == _SERIAL_STAMPS) {
+		++ serial->stamps_head; // full: the frames of the oldest chunk take the time of the next
+	}
+	stamp = &serial->stamps[serial->stamps_tail & (_SERIAL_STAMPS - 1)];
+	stamp->tail = serial->tail;
+	stamp->time = time;
+	++ serial->stamps_tail;
+}
+
+unsigned long long _serial_get_stamp(struct _serial* serial, unsigned int* stamp, unsigned int end) { // frames in ring order, *stamp from stamps_head
+	while(*stamp != serial->stamps_tail) {
+		if((int)(serial->stamps[*stamp & (_SERIAL_STAMPS - 1)].tail - end) >= 0) {
+			return serial->stamps[*stamp & (_SERIAL_STAMPS - 1)].time;
+		}
+		++ *stamp;
+	}
+	return _clock_get_time(); // no chunk recorded: not filled by this serial
+}
+
+int _serial_wait(struct _serial* serial, char delimiter, int timeout) {
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 0) return 0;
+
+	if(_serial_find(serial, serial->head, delimiter) > 0) return 1;
+	return serial->transport->wait_read_bytes(serial->port_handle, timeout);
+}
+
+int _serial_read_string_until(struct _serial* serial, char* buffer, int buffer_size, char delimiter) {
+	int length;
+
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 0) return 0;
+
+	length = _serial_find(serial, serial->head, delimiter);
+	if(length == 0 && _serial_fill(serial) > 0) {
+		length = _serial_find(serial, serial->head, delimiter);
+	}
+	while(length > 0) {
+		if(length < buffer_size) {
+			_serial_copy(serial, buffer, length);
+			buffer[length] = '\0';
+			serial->head += length;
+			return length;
+		}
+		_serial_overflow(serial, length); // too long for the caller
+		length = _serial_find(serial, serial->head, delimiter);
+	}
+	return 0;
+}
+
+int _serial_read_string_timeout(struct _serial* serial, char* buffer, int buffer_size, char delimiter, int timeout) {
+	unsigned long long deadline = _clock_get_time() + (unsigned long long)timeout * _CLOCK_MILLISECOND, now;
+	int length;
+
+	while(1) {
+		length = _serial_read_string_until(serial, buffer, buffer_size, delimiter);
+		if(length != 0) return length;
+		if(serial == NULL || serial->port_opened == 0) return 0;
+		now = _clock_get_time();
+		if(now >= deadline) return 0;
+		// poll on POSIX, an overlapped WaitCommEvent on Windows: back when bytes arrive or the time is up
+		if(serial->transport->wait_read_bytes(serial->port_handle, (int)((deadline - now + _CLOCK_MILLISECOND - 1) / _CLOCK_MILLISECOND)) < 0) {
+			_SLEEP((int)((deadline - now) / _CLOCK_MILLISECOND)); // port error: don't spin
+			return 0;
+		}
+	}
+}
+
+int _serial_read_frames(struct _serial* serial, char delimiter, struct _serial_frame* frames, int max_count) {
+	unsigned int mask, start, stamp;
+	int count = 0, length, offset, wrapped;
+
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 0) return 0;
+
+	_serial_fill(serial);
+	mask = (unsigned int)serial->buffer_size - 1;
+	start = serial->head;
+	stamp = serial->stamps_head;
+	while(count < max_count && (length = _serial_find(serial, start, delimiter)) > 0) {
+		offset = (int)(start & mask);
+		wrapped = offset + length - serial->buffer_size;
+		if(wrapped > 0) {
+			// mirror the wrapped part past the end of the ring; fill never writes there
+			memcpy(serial->buffer + serial->buffer_size, serial->buffer, wrapped);
+		}
+		frames[count].data = serial->buffer + offset;
+		frames[count].length = length;
+		frames[count].time = _serial_get_stamp(serial, &stamp, start + length);
+		++ count;
+		start += length;
+	}
+	return count;
+}
+
+void _serial_release_frames(struct _serial* serial, const struct _serial_frame* frames, int count) {
+	int i;
+
+	if(serial == NULL) return;
+	for(i = 0; i < count; ++i) {
+		serial->head += frames[i].length;
+	}
+}
+
+int _serial_write(const struct _serial* serial, const char* buffer, int buffer_size) {
+	if(serial == NULL) return 0;
+	if(serial->port_opened == 0) return 0;
+	if(serial->capture != NULL) {
+		_capture_append(serial->capture, _CAPTURE_SENT, buffer, buffer_size);
+	}
+	return serial->transport->write_bytes(serial->port_handle, (const unsigned char*)buffer, buffer_size);
+}
+
+int _serial_write_frames(struct _serial* const* serials, const struct _serial_frame* frames, int count) { // frames[i] from serials[i], all on one port
+	const struct _serial* serial = serials[0];
+	int i;
+
+	for(i = 0; i < count; ++i) {
+		if(serials[i]->port_opened == 0) return 0;
+		if(serials[i]->capture != NULL) {
+			_capture_append(serials[i]->capture, _CAPTURE_SENT, frames[i].data, frames[i].length);
+		}
+	}
+	if(count == 1 || serial->transport->write_frames == NULL) {
+		for(i = 0; i < count; ++i) {
+			if(serial->transport->write_bytes(serial->port_handle, (const unsigned char*)frames[i].data, frames[i].length) == 0) return 0;
+		}
+		return 1;
+	}
+	return serial->transport->write_frames(serial->port_handle, frames, count);
+}
+
+int _serial_can_write(const struct _serial* serial) {
+#ifndef _WIN32
+	struct pollfd fds;
+
+	fds.fd = serial->transport->get_fd(serial->port_handle);
+	if(fds.fd >= 0) {
+		fds.events = POLLOUT;
+		fds.revents = 0;
+		return (poll(&fds, 1, 0) > 0 && (fds.revents & POLLOUT) != 0) ? 1 : 0;
+	}
+#endif
+	return 1; // nothing to ask: the write itself will wait
+}
+
+/*------------------------------
+  HOTPLUG
+------------------------------*/
+
+#define _HOTPLUG_OFF 0
+#define _HOTPLUG_REPORT 1
+#define _HOTPLUG_ATTACH 2
+#define _HOTPLUG_ARRIVED 1
+#define _HOTPLUG_REMOVED 2
+#define _HOTPLUG_MAX_EVENTS 32
+#define _HOTPLUG_POLL_INTERVAL 250 // milliseconds, also the longest inotify wait
+#define _HOTPLUG_SETTLE_TIME 20 // milliseconds for udev to finish a new node
+
+struct _hotplug_event {
+	unsigned int generation;
+	int type;
+	char port_name[_TEMP_CHAR_BUFFER_SIZE];
+};
+
+struct _hotplug {
+	int mode;
+	volatile int running;
+	_THREAD thread;
+	_MUTEX lock;
+	char** port_names; // as of the last look
+	int port_count;
+	volatile unsigned int generation; // of the newest event
+	struct _hotplug_event events[_HOTPLUG_MAX_EVENTS]; // ring indexed by generation
+};
+
+struct _hotplug* _hotplug = NULL;
+
+void _hotplug_start(int mode);
+void _hotplug_stop(void);
+_THREAD_PROC _hotplug_thread_proc(void* arg);
+char** _hotplug_get_port_names(int* count);
+void _hotplug_free_port_names(char** port_names, int count);
+int _hotplug_contains(char** port_names, int count, const char* port_name);
+void _hotplug_update(void);
+void _hotplug_add_event(int type, const char* port_name);
+unsigned int _hotplug_get_generation(void);
+int _hotplug_next_event(unsigned int* generation, int* type, char* port_name);
+
+void _hotplug_start(int mode) {
+	if(mode == _HOTPLUG_OFF) {
+		_hotplug_stop();
+		return;
+	}
+	if(_hotplug == NULL) { // kept to the end: robot threads read the events without asking
+		_hotplug = (struct _hotplug*)malloc(sizeof(struct _hotplug));
+		_hotplug->running = 0;
+		_hotplug->port_names = NULL;
+		_hotplug->port_count = 0;
+		_hotplug->generation = 0;
+		_MUTEX_INIT(&_hotplug->lock);
+	}
+	_hotplug->mode = mode;
+	if(_hotplug->running == 0) {
+		// ports that are already there are not news
+		_hotplug_free_port_names(_hotplug->port_names, _hotplug->port_count);
+		_hotplug->port_names = _hotplug_get_port_names(&_hotplug->port_count);
+		_hotplug->running = 1;
+		if(_thread_start(&_hotplug->thread, _hotplug_thread_proc, _hotplug) == 0) {
+			_hotplug->running = 0;
+			_hotplug->mode = _HOTPLUG_OFF;
+		}
+	}
+}
+
+void _hotplug_stop(void) {
+	if(_hotplug == NULL) return;
+	if(_hotplug->running == 1) {
+		_hotplug->running = 0;
+		_thread_join(_hotplug->thread, -1);
+	}
+	_hotplug->mode = _HOTPLUG_OFF;
+}
+
+_THREAD_PROC _hotplug_thread_proc(void* arg) {
+	struct _hotplug* hotplug = (struct _hotplug*)arg;
+#ifdef __linux__
+	char buffer[4096];
+	struct pollfd pfd;
+	int fd;
+
+	// a bridge appears in /dev first and in /dev/serial/by-id after it
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd >= 0 && inotify_add_watch(fd, "/dev", IN_CREATE | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM) < 0) {
+		close(fd);
+		fd = -1;
+	}
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	while(hotplug->running == 1) {
+		if(fd < 0) {
+			_SLEEP(_HOTPLUG_POLL_INTERVAL);
+		} else if(poll(&pfd, 1, _HOTPLUG_POLL_INTERVAL) > 0) {
+			_SLEEP(_HOTPLUG_SETTLE_TIME);
+			while(read(fd, buffer, sizeof(buffer)) > 0); // the list is read again anyway
+		}
+		_hotplug_update();
+	}
+	if(fd >= 0) close(fd);
+#else
+	// the registry and /dev on macOS have nothing to wait on: look again every so often
+	while(hotplug->running == 1) {
+		_SLEEP(_HOTPLUG_POLL_INTERVAL);
+		_hotplug_update();
+	}
+#endif
+	return 0;
+}
+
+char** _hotplug_get_port_names(int* count) {
+	char** port_names = _serial_port_get_serial_port_names(NULL, count);
+#ifndef _WIN32
+	int i, j;
+
+	// a node udev has not handed to us yet is not there: its permission change brings it back
+	for(i = 0, j = 0; i < *count; ++i) {
+		if(access(port_names[i], R_OK | W_OK) == 0) {
+			port_names[j++] = port_names[i];
+		} else {
+			free(port_names[i]);
+		}
+	}
+	*count = j;
+#endif
+	return port_names;
+}
+
+void _hotplug_free_port_names(char** port_names, int count) {
+	int i;
+
+	if(port_names == NULL) return;
+	for(i = 0; i < count; ++i) {
+		free(port_names[i]);
+	}
+	free(port_names);
+}
+
+int _hotplug_contains(char** port_names, int count, const char* port_name) {
+	int i;
+
+	for(i = 0; i < count; ++i) {
+		if(strcmp(port_names[i], port_name) == 0) return 1;
+	}
+	return 0;
+}
+
+void _hotplug_update(void) {
+	char** port_names;
+	int port_count = 0, i;
+
+	port_names = _hotplug_get_port_names(&port_count);
+	for(i = 0; i < _hotplug->port_count; ++i) {
+		if(_hotplug_contains(port_names, port_count, _hotplug->port_names[i]) == 0) {
+			printf("Serial port removed: %s\n", _hotplug->port_names[i]);
+			_hotplug_add_event(_HOTPLUG_REMOVED, _hotplug->port_names[i]);
+		}
+	}
+	for(i = 0; i < port_count; ++i) {
+		if(_hotplug_contains(_hotplug->port_names, _hotplug->port_count, port_names[i]) == 0) {
+			printf("Serial port added: %s\n", port_names[i]);
+			_hotplug_add_event(_HOTPLUG_ARRIVED, port_names[i]);
+		}
+	}
+	_hotplug_free_port_names(_hotplug->port_names, _hotplug->port_count);
+	_hotplug->port_names = port_names;
+	_hotplug->port_count = port_count;
+}
+
+void _hotplug_add_event(int type, const char* port_name) {
+	struct _hotplug_event* event;
+	unsigned int generation;
+
+	_MUTEX_LOCK(&_hotplug->lock);
+	generation = _hotplug->generation + 1;
+	event = &_hotplug->events[generation % _HOTPLUG_MAX_EVENTS];
+	event->generation = generation;
+	event->type = type;
+	_STRCPY(event->port_name, _TEMP_CHAR_BUFFER_SIZE, port_name);
+	_hotplug->generation = generation;
+	_MUTEX_UNLOCK(&_hotplug->lock);
+}
+
+unsigned int _hotplug_get_generation(void) {
+	if(_hotplug == NULL) return 0;
+	return _hotplug->generation;
+}
+
+int _hotplug_next_event(unsigned int* generation, int* type, char* port_name) {
+	struct _hotplug_event* event;
+
+	if(_hotplug == NULL || *generation == _hotplug->generation) return 0;
+	_MUTEX_LOCK(&_hotplug->lock);
+	if(_hotplug->generation - *generation > _HOTPLUG_MAX_EVENTS) { // fell behind: the oldest ones are gone
+		*generation = _hotplug->generation - _HOTPLUG_MAX_EVENTS;
+	}
+	++ *generation;
+	event = &_hotplug->events[*generation % _HOTPLUG_MAX_EVENTS];
+	*type = event->type;
+	_STRCPY(port_name, _TEMP_CHAR_BUFFER_SIZE, event->port_name);
+	_MUTEX_UNLOCK(&_hotplug->lock);
+	return 1;
+}
+
+/*------------------------------
+  WRITER
+------------------------------*/
+
+#define _WRITER_WAIT 100 // milliseconds with nothing pending
+#define _WRITER_RETRY 2 // milliseconds before asking a link that could not take its packet again
+#define _WRITER_GATHER 5 // milliseconds a packet waits for those of the other robots behind its bridge
+#define _WRITER_BLOCKED 1
+#define _WRITER_GATHERING 2
+
+struct _connector;
+
+struct _writer { // sends the motoring packets so that the robot threads only receive
+	volatile int running;
+	_THREAD thread;
+	_MUTEX lock; // connectors
+	_MUTEX pass_lock; // held while flushing a copy of connectors
+	struct _connector** connectors;
+	int connectors_count;
+	int connectors_size;
+	_MUTEX signal_lock;
+	_COND signal;
+	int signalled;
+};
+
+struct _writer* _writer = NULL;
+
+void _writer_start(void);
+void _writer_stop(void);
+_THREAD_PROC _writer_thread_proc(void* arg);
+void _writer_add(struct _connector* connector);
+void _writer_remove(struct _connector* connector);
+void _writer_signal(void);
+int _connector_flush(struct _connector** connectors, int index, int count, int gather);
+
+void _writer_start(void) {
+	if(_writer == NULL) { // kept to the end like the hotplug watcher
+		_writer = (struct _writer*)malloc(sizeof(struct _writer));
+		_writer->running = 0;
+		_writer->connectors_count = 0;
+		_writer->connectors_size = 4;
+		_writer->connectors = (struct _connector**)malloc(sizeof(struct _connector*) * _writer->connectors_size);
+		_writer->signalled = 0;
+		_MUTEX_INIT(&_writer->lock);
+		_MUTEX_INIT(&_writer->pass_lock);
+		_MUTEX_INIT(&_writer->signal_lock);
+		_COND_INIT(&_writer->signal);
+	}
+	if(_writer->running == 0) {
+		_writer->running = 1;
+		if(_thread_start(&_writer->thread, _writer_thread_proc, _writer) == 0) {
+			_writer->running = 0;
+		}
+	}
+}
+
+void _writer_stop(void) {
+	if(_writer == NULL || _writer->running == 0) return;
+	_writer->running = 0;
+	_writer_signal();
+	_thread_join(_writer->thread, -1);
+}
+
+_THREAD_PROC _writer_thread_proc(void* arg) {
+	struct _writer* writer = (struct _writer*)arg;
+	struct _connector** connectors = NULL; // copied at each pass: adding one does not wait for the writes
+	unsigned long long gather_until = 0;
+	int result = 0, count, size = 0, i;
+
+	while(writer->running == 1) {
+		_MUTEX_LOCK(&writer->signal_lock);
+		if(writer->signalled == 0) {
+			_cond_wait(&writer->signal, &writer->signal_lock, (result & _WRITER_GATHERING) != 0 ? _WRITER_GATHER : ((result & _WRITER_BLOCKED) != 0 ? _WRITER_RETRY : _WRITER_WAIT));
+		}
+		writer->signalled = 0;
+		_MUTEX_UNLOCK(&writer->signal_lock);
+
+		if((result & _WRITER_GATHERING) == 0) { // the first packet of a tick
+			gather_until = _clock_get_time() + _WRITER_GATHER * _CLOCK_MILLISECOND;
+		}
+		result = 0;
+		_MUTEX_LOCK(&writer->pass_lock);
+		_MUTEX_LOCK(&writer->lock);
+		if(writer->connectors_count > size) {
+			size = writer->connectors_size;
+			connectors = (struct _connector**)realloc(connectors, sizeof(struct _connector*) * size);
+		}
+		count = writer->connectors_count;
+		memcpy(connectors, writer->connectors, sizeof(struct _connector*) * count);
+		_MUTEX_UNLOCK(&writer->lock);
+		for(i = 0; i < count; ++i) {
+			result |= _connector_flush(connectors, i, count, _clock_get_time() < gather_until ? 1 : 0);
+		}
+		_MUTEX_UNLOCK(&writer->pass_lock);
+	}
+	free(connectors);
+	return 0;
+}
+
+void _writer_add(struct _connector* connector) {
+	_writer_start();
+	_MUTEX_LOCK(&_writer->lock);
+	if(_writer->connectors_count >= _writer->connectors_size) {
+		_writer->connectors_size *= 2;
+		_writer->connectors = (struct _connector**)realloc(_writer->connectors, sizeof(struct _connector*) * _writer->connectors_size);
+	}
+	_writer->connectors[_writer->connectors_count++] = connector;
+	_MUTEX_UNLOCK(&_writer->lock);
+}
+
+void _writer_remove(struct _connector* connector) {
+	int i;
+
+	if(_writer == NULL) return;
+	_MUTEX_LOCK(&_writer->lock);
+	for(i = 0; i < _writer->connectors_count; ++i) {
+		if(_writer->connectors[i] == connector) {
+			_writer->connectors[i] = _writer->connectors[--_writer->connectors_count];
+			break;
+		}
+	}
+	_MUTEX_UNLOCK(&_writer->lock);
+	// a pass may still hold it in its copy: not in the middle of writing for it once this is taken
+	_MUTEX_LOCK(&_writer->pass_lock);
+	_MUTEX_UNLOCK(&_writer->pass_lock);
+}
+
+void _writer_signal(void) {
+	_MUTEX_LOCK(&_writer->signal_lock);
+	_writer->signalled = 1;
+	_COND_SIGNAL(&_writer->signal);
+	_MUTEX_UNLOCK(&_writer->signal_lock);
+}
+
+/*------------------------------
+  CONNECTOR
+------------------------------*/
+
+#define _CONNECTION_STATE_NONE 0
+#define _CONNECTION_STATE_CONNECTING 1
+#define _CONNECTION_STATE_CONNECTED 2
+#define _CONNECTION_STATE_CONNECTION_LOST 3
+#define _CONNECTION_STATE_DISCONNECTED 4
+#define _CONNECTION_STATE_DISPOSED 5
+#define _CONNECTION_RESULT_FOUND 1
+#define _CONNECTION_RESULT_NOT_CONNECTED 2
+#define _CONNECTION_RESULT_NOT_AVAILABLE 3
+#define _CONNECTION_RESULT_PENDING 0 // the handshake has not finished yet
+
+#define _CONNECTOR_INFO_BUFFER_SIZE 20
+#define _CONNECTOR_BUFFER_SIZE 256 // handshake replies only
+#define _CONNECTOR_MAX_FRAMES 16
+#define _CONNECTOR_RECEIVE_ALL 0
+#define _CONNECTOR_RECEIVE_LATEST 1
+#define _CONNECTOR_PROBE_WORKERS 8 // threads opening ports: opening may block, the handshakes don't
+#define _CONNECTOR_PROBE_TICK 5 // milliseconds between looks at the handshakes in flight
+#define _CONNECTOR_CACHE_SIZE 16
+#define _CONNECTOR_CACHE_TRIES 2 // cached robots asked for before the full scan, about a second each if gone
+#define _CONNECTOR_CACHE_FILE "roboid_ports.txt"
+#define _CONNECTOR_LOSS_TIMEOUT 200 // milliseconds without a valid frame
+#define _CONNECTOR_RETRY_MIN 50 // milliseconds before reopening, doubled after every failure
+#define _CONNECTOR_RETRY_MAX 2000
+#define _CONNECTOR_HANDSHAKE_NONE 0
+#define _CONNECTOR_HANDSHAKE_LISTEN 1 // reading what the bridge sends by itself
+#define _CONNECTOR_HANDSHAKE_IDENTIFY 2 // the identity request is out, waiting for the reply
+#define _CONNECTOR_READ_TIMEOUT 100 // milliseconds for one line of the handshake
+#define _CONNECTOR_IDENTIFY_TIMEOUT 1000 // milliseconds for the reply to the identity request
+#define _WAIT_TIMEOUT 50 // milliseconds
+
+#define _VALID_PACKET_LENGTH 54
+#define _MOTORING_PACKET_LENGTH 54
+#define _CR 13
+
+#define _DATA_LENGTH 40 // hex characters before the '-' and the address
+#define _ADDRESS_LENGTH 12
+
+#define _DEFAULT_ADDRESS "000000000000"
+
+struct _connector;
+typedef int (*_PARSE_IDENTITY)(struct _connector* connector, const char* reply, int length);
+
+struct _connector {
+	struct _serial* serial;
+	char* tag;
+	int index;
+	int packet_length;
+	char delimiter;
+	char* address;
+	char* port_name;
+	int found;
+	int connected;
+	int state; // _CONNECTION_STATE_*
+	unsigned long long timestamp; // of the last valid frame
+	int loss_timeout; // milliseconds
+	int retry_interval; // milliseconds, 0 when the port is not to be opened again
+	unsigned long long retry_time;
+	char* buffer;
+	struct _serial_frame* frames;
+	int frames_count;
+	int receive_mode;
+	int discarded_frames;
+	int rejected_frames;
+	int probing; // a temporary connector of a parallel probe: prints nothing
+	struct _capture* capture; // created once by _connector_open, kept across reopens
+	struct _serial* reopening; // opened again on the robot thread, its handshake stepped without blocking
+	size_t reopen_mark; // capture length before it was opened
+	int reopen_retry; // 1: opened by _connector_reconnect, tried again later if no robot answers
+	int baud_rate;
+	int flow_control;
+	int any_port; // opened without a port name: any bridge will do
+	int opened; // _connector_open has returned: the robot thread may attach and detach
+	unsigned int hotplug_generation; // of the last hotplug event looked at
+	char* pending; // the newest motoring packet the writer has not sent yet
+	int pending_length;
+	int queued; // known to the writer
+	_MUTEX pending_lock;
+	_MUTEX write_lock; // held while the writer uses serial, and to take serial away from it
+	int handshake; // _CONNECTOR_HANDSHAKE_*
+	int handshake_lines; // read while listening
+	int handshake_lengths[2]; // of the last two of them
+	unsigned long long handshake_deadline; // for the line or reply waited for
+	const char* identity_request; // the reply starts with the same two bytes
+	_PARSE_IDENTITY parse_identity;
+	const char* expected_address; // the robot the cache names, NULL for any
+};
+
+struct _connector_probe {
+	struct _connector* connector; // the one being opened
+	char** port_names;
+	int port_count;
+	int next; // next port to probe
+	int result;
+	struct _connector* found; // temporary connector holding the best result so far
+	struct _connector** handshakes; // temporary connectors of opened ports, one per port at most
+	int handshake_count;
+	int opening; // threads still opening ports
+	volatile int cancel;
+	int baud_rate;
+	int flow_control;
+	_MUTEX lock;
+};
+
+struct _connector* _connector_create(const char* tag, int index, int packet_length, char delimiter);
+void _connector_dispose(struct _connector* connector);
+int _connector_open(struct _connector* connector, const char* port_name, int baud_rate, int flow_control);
+int _connector_probe_ports(struct _connector* connector, char** port_names, int port_count, int baud_rate, int flow_control);
+int _connector_get_cache_path(char* path, int size);
+int _connector_load_cache(char (*port_names)[_TEMP_CHAR_BUFFER_SIZE], char (*addresses)[_CONNECTOR_INFO_BUFFER_SIZE], int max_count);
+void _connector_save_cache(const struct _connector* connector);
+int _connector_open_cached(struct _connector* connector, int baud_rate, int flow_control);
+_THREAD_PROC _connector_probe_proc(void* arg);
+void _connector_start_handshake(struct _connector* connector, struct _serial* serial, int handshake);
+int _connector_listen(struct _connector* connector, struct _serial* serial, int length);
+int _connector_feed_handshake(struct _connector* connector, struct _serial* serial, const char* line, int length);
+int _connector_step_handshake(struct _connector* connector, struct _serial* serial, int timeout);
+int _connector_match_field(const char* field, int length, const char* text);
+int _connector_check_port(struct _connector* connector, struct _serial* serial);
+struct _serial* _connector_open_serial(struct _connector* connector, const char* port_name, int baud_rate, int flow_control);
+int _connector_open_port(struct _connector* connector, const char* port_name, int baud_rate, int flow_control);
+struct _capture* _connector_create_capture(const struct _connector* connector);
+void _connector_close(struct _connector* connector);
+void _connector_close_serial(struct _connector* connector);
+int _connector_check_hotplug(struct _connector* connector);
+void _connector_lose(struct _connector* connector, int state);
+int _connector_start_reopen(struct _connector* connector, const char* port_name, int retry);
+int _connector_step_reopen(struct _connector* connector);
+void _connector_drop_reopen(struct _connector* connector);
+void _connector_retry_later(struct _connector* connector);
+int _connector_reconnect(struct _connector* connector);
+int _connector_is_connected(const struct _connector* connector);
+const char* _connector_get_port_name(const struct _connector* connector);
+const char* _connector_get_address(const struct _connector* connector);
+void _connector_set_address(const struct _connector* connector, const char* address);
+void _connector_set_connection_state(struct _connector* connector, int state);
+void _connector_write(struct _connector* connector, const char* buffer, int buffer_size);
+int _connector_flush(struct _connector** connectors, int index, int count, int gather);
+int _connector_wait(const struct _connector* connector, int timeout);
+int _connector_check_frame(struct _connector* connector, struct _serial_frame* frame);
+int _connector_read_latest(struct _connector* connector);
+int _connector_read(struct _connector* _connector);
+void _connector_release(struct _connector* connector);
+void _connector_print_state(const struct _connector* connector, int state);
+void _connector_print_error(const struct _connector* connector, int error_code);
+
+struct _connector* _connector_create(const char* tag, int index, int packet_length, char delimiter) {
+	struct _connector* connector = (struct _connector*)malloc(sizeof(struct _connector));
+	
+	connector->serial = NULL;
+	connector->index = index;
+	connector->packet_length = packet_length;
+	connector->delimiter = delimiter;
+	
+	connector->tag = (char*)malloc(sizeof(char) * _CONNECTOR_INFO_BUFFER_SIZE);
+	connector->address = (char*)malloc(sizeof(char) * _CONNECTOR_INFO_BUFFER_SIZE);
+	connector->port_name = (char*)malloc(sizeof(char) * _TEMP_CHAR_BUFFER_SIZE);
+	_STRCPY(connector->tag, _CONNECTOR_INFO_BUFFER_SIZE, tag);
+	_STRCPY(connector->address, _CONNECTOR_INFO_BUFFER_SIZE, _DEFAULT_ADDRESS);
+	_STRCPY(connector->port_name, _TEMP_CHAR_BUFFER_SIZE, "");
+	
+	connector->found = 0;
+	connector->connected = 0;
+	connector->state = _CONNECTION_STATE_NONE;
+	connector->timestamp = 0;
+	connector->loss_timeout = _CONNECTOR_LOSS_TIMEOUT;
+	connector->retry_interval = 0;
+	connector->retry_time = 0;
+	
+	connector->buffer = (char*)malloc(sizeof(char) * _CONNECTOR_BUFFER_SIZE);
+	connector->frames = (struct _serial_frame*)malloc(sizeof(struct _serial_frame) * _CONNECTOR_MAX_FRAMES);
+	connector->frames_count = 0;
+	connector->receive_mode = _CONNECTOR_RECEIVE_ALL;
+	connector->discarded_frames = 0;
+	connector->rejected_frames = 0;
+	connector->probing = 0;
+	connector->capture = NULL;
+	connector->reopening = NULL;
+	connector->reopen_mark = 0;
+	connector->reopen_retry = 0;
+	connector->baud_rate = 0;
+	connector->flow_control = 0;
+	connector->any_port = 0;
+	connector->opened = 0;
+	connector->hotplug_generation = 0;
+	connector->pending = (char*)malloc(sizeof(char) * packet_length);
+	connector->pending_length = 0;
+	connector->queued = 0;
+	_MUTEX_INIT(&connector->pending_lock);
+	_MUTEX_INIT(&connector->write_lock);
+	connector->expected_address = NULL;
+	connector->handshake = _CONNECTOR_HANDSHAKE_NONE;
+	connector->handshake_lines = 0;
+	connector->handshake_lengths[0] = 0;
+	connector->handshake_lengths[1] = 0;
+	connector->handshake_deadline = 0;
+	connector->identity_request = NULL;
+	connector->parse_identity = NULL;
+
+	return connector;
+}
+
+void _connector_dispose(struct _connector* connector) {
+	if(connector == NULL) return;
+
+	if(connector->queued == 1) {
+		_writer_remove(connector);
+	}
+	_connector_close(connector); // close serial
+	if(connector->capture != NULL) {
+		_capture_close(connector->capture);
+		connector->capture = NULL;
+	}
+	if(connector->tag != NULL) {
+		free(connector->tag);
+		connector->tag = NULL;
+	}
+	if(connector->address != NULL) {
+		free(connector->address);
+		connector->address = NULL;
+	}
+	if(connector->port_name != NULL) {
+		free(connector->port_name);
+		connector->port_name = NULL;
+	}
+	if(connector->buffer != NULL) {
+		free(connector->buffer);
+		connector->buffer = NULL;
+	}
+	if(connector->frames != NULL) {
+		free(connector->frames);
+		connector->frames = NULL;
+	}
+	if(connector->pending != NULL) {
+		free(connector->pending);
+		connector->pending = NULL;
+	}
+	_MUTEX_DESTROY(&connector->pending_lock);
+	_MUTEX_DESTROY(&connector->write_lock);
+	connector->parse_identity = NULL;
+	free(connector);
+}
+
+int _connector_open(struct _connector* connector, const char* port_name, int baud_rate, int flow_control) {
+	int result = _CONNECTION_RESULT_NOT_AVAILABLE;
+
+	if(connector == NULL) return _CONNECTION_RESULT_NOT_AVAILABLE;
+	connector->baud_rate = baud_rate;
+	connector->flow_control = flow_control;
+	connector->any_port = (port_name == NULL) ? 1 : 0;
+	connector->hotplug_generation = _hotplug_get_generation(); // a bridge plugged in from now on is news
+	_serial_share_start();
+	if(_capture_path != NULL && connector->capture == NULL) {
+		connector->capture = _connector_create_capture(connector);
+	}
+	if(port_name == NULL) {
+		int port_count = 0;
+		char** port_names;
+
+		// where a robot was found last time costs one handshake, a full scan many
+		result = _connector_open_cached(connector, baud_rate, flow_control);
+		if(result == _CONNECTION_RESULT_FOUND) {
+			return result;
+		}
+		port_names = _serial_port_get_serial_port_names(NULL, &port_count);
+		if(port_count > 0 && port_names != NULL) {
+			int i;
+	
+			if(port_count > 1 && _capture_path == NULL) {
+				result = _connector_probe_ports(connector, port_names, port_count, baud_rate, flow_control);
+			} else {
+				// one port, or a capture, which must hold the handshake of the port that answers
+				for(i = 0; i < port_count; ++i) {
+					result = _connector_open_port(connector, port_names[i], baud_rate, flow_control);
+					if(result != _CONNECTION_RESULT_NOT_AVAILABLE) {
+						break;
+					}
+				}
+			}
+			for(i = 0; i < port_count; ++i) {
+				free(port_names[i]);
+			}
+			free(port_names);
+		}
+		if(result == _CONNECTION_RESULT_FOUND) {
+			_connector_save_cache(connector);
+		}
+	} else {
+		result = _connector_open_port(connector, port_name, baud_rate, flow_control);
+	}
+	if(result == _CONNECTION_RESULT_NOT_AVAILABLE) {
+		_connector_print_error(connector, result);
+	}
+	connector->opened = 1;
+	return result;
+}
+
+int _connector_get_cache_path(char* path, int size) {
+	const char* dir = getenv("ROBOID_CACHE");
+
+	if(dir != NULL && dir[0] != '\0') { // the file itself
+		snprintf(path, size, "%s", dir);
+		return 1;
+	}
+#ifdef _WIN32
+	dir = getenv("LOCALAPPDATA");
+	if(dir == NULL) dir = getenv("APPDATA");
+	if(dir == NULL) return 0;
+	snprintf(path, size, "%s\\%s", dir, _CONNECTOR_CACHE_FILE);
+#else
+	dir = getenv("HOME");
+	if(dir == NULL) return 0;
+	snprintf(path, size, "%s/.%s", dir, _CONNECTOR_CACHE_FILE);
+#endif
+	return 1;
+}
+
+int _connector_load_cache(char (*port_names)[_TEMP_CHAR_BUFFER_SIZE], char (*addresses)[_CONNECTOR_INFO_BUFFER_SIZE], int max_count) {
+	char path[_TEMP_CHAR_BUFFER_SIZE];
+	char line[_TEMP_CHAR_BUFFER_SIZE + _CONNECTOR_INFO_BUFFER_SIZE];
+	char* space;
+	FILE* file;
+	int count = 0, len;
+
+	if(_connector_get_cache_path(path, _TEMP_CHAR_BUFFER_SIZE) == 0) return 0;
+	file = fopen(path, "r");
+	if(file == NULL) return 0;
+	// one "<address> <port name>" per line, the most recent first
+	while(count < max_count && fgets(line, sizeof(line), file) != NULL) {
+		len = strlen(line);
+		while(len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+		space = strchr(line, ' ');
+		if(space == NULL || space - line >= _CONNECTOR_INFO_BUFFER_SIZE || strlen(space + 1) >= _TEMP_CHAR_BUFFER_SIZE) continue;
+		*space = '\0';
+		_STRCPY(addresses[count], _CONNECTOR_INFO_BUFFER_SIZE, line);
+		_STRCPY(port_names[count], _TEMP_CHAR_BUFFER_SIZE, space + 1);
+		++ count;
+	}
+	fclose(file);
+	return count;
+}
+
+void _connector_save_cache(const struct _connector* connector) {
+	char port_names[_CONNECTOR_CACHE_SIZE][_TEMP_CHAR_BUFFER_SIZE];
+	char addresses[_CONNECTOR_CACHE_SIZE][_CONNECTOR_INFO_BUFFER_SIZE];
+	char path[_TEMP_CHAR_BUFFER_SIZE];
+	FILE* file;
+	int count, i;
+
+	count = _connector_load_cache(port_names, addresses, _CONNECTOR_CACHE_SIZE);
+	if(_connector_get_cache_path(path, _TEMP_CHAR_BUFFER_SIZE) == 0) return;
+	file = fopen(path, "w");
+	if(file == NULL) return;
+	// one line per robot: a bridge may have several behind it
+	fprintf(file, "%s %s\n", connector->address, connector->port_name);
+	for(i = 0; i < count && i < _CONNECTOR_CACHE_SIZE - 1; ++i) {
+		if(_connector_match_field(addresses[i], (int)strlen(addresses[i]), connector->address) == 1) continue;
+		fprintf(file, "%s %s\n", addresses[i], port_names[i]);
+	}
+	fclose(file);
+}
+
+int _connector_open_cached(struct _connector* connector, int baud_rate, int flow_control) {
+	char port_names[_CONNECTOR_CACHE_SIZE][_TEMP_CHAR_BUFFER_SIZE];
+	char addresses[_CONNECTOR_CACHE_SIZE][_CONNECTOR_INFO_BUFFER_SIZE];
+	int count, tries = 0, result, i;
+
+	count = _connector_load_cache(port_names, addresses, _CONNECTOR_CACHE_SIZE);
+	connector->probing = 1; // quiet unless a robot answers
+	for(i = 0; i < count && tries < _CONNECTOR_CACHE_TRIES; ++i) {
+		if(_serial_is_claimed(port_names[i], addresses[i]) == 1) continue; // already with another connector
+		++ tries;
+		connector->expected_address = addresses[i];
+		result = _connector_open_port(connector, port_names[i], baud_rate, flow_control);
+		connector->expected_address = NULL;
+		if(result == _CONNECTION_RESULT_FOUND) {
+			connector->probing = 0;
+			_connector_print_state(connector, _CONNECTION_STATE_CONNECTED);
+			if(i > 0) {
+				_connector_save_cache(connector);
+			}
+			return result;
+		}
+		if(connector->serial != NULL) { // a bridge without that robot: the full scan may do better
+			_connector_close_serial(connector);
+		}
+	}
+	connector->probing = 0;
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+int _connector_probe_ports(struct _connector* connector, char** port_names, int port_count, int baud_rate, int flow_control) {
+	struct _connector_probe probe;
+	struct _connector* temp;
+	_THREAD threads[_CONNECTOR_PROBE_WORKERS];
+	int count = 0, handshake_count, opening, pending, result, i;
+
+	probe.connector = connector;
+	probe.port_names = port_names;
+	probe.port_count = port_count;
+	probe.next = 0;
+	probe.result = _CONNECTION_RESULT_NOT_AVAILABLE;
+	probe.found = NULL;
+	probe.handshakes = (struct _connector**)malloc(sizeof(struct _connector*) * port_count);
+	probe.handshake_count = 0;
+	probe.opening = 0;
+	probe.cancel = 0;
+	probe.baud_rate = baud_rate;
+	probe.flow_control = flow_control;
+	_MUTEX_INIT(&probe.lock);
+
+	for(i = 0; i < _CONNECTOR_PROBE_WORKERS && i < port_count; ++i) {
+		_MUTEX_LOCK(&probe.lock);
+		++ probe.opening;
+		_MUTEX_UNLOCK(&probe.lock);
+		if(_thread_start(&threads[count], _connector_probe_proc, &probe) == 1) {
+			++ count;
+		} else {
+			_MUTEX_LOCK(&probe.lock);
+			-- probe.opening;
+			_MUTEX_UNLOCK(&probe.lock);
+		}
+	}
+	if(count == 0) {
+		probe.opening = 1;
+		_connector_probe_proc(&probe); // no threads: open one by one here, then run the handshakes
+	}
+
+	// this thread runs the handshakes of all opened ports side by side
+	while(1) {
+		_MUTEX_LOCK(&probe.lock);
+		handshake_count = probe.handshake_count;
+		opening = probe.opening;
+		_MUTEX_UNLOCK(&probe.lock);
+
+		pending = 0;
+		for(i = 0; i < handshake_count; ++i) {
+			temp = probe.handshakes[i];
+			if(temp == NULL) continue;
+			result = (probe.cancel == 0) ? _connector_step_handshake(temp, temp->serial, 0) : _CONNECTION_RESULT_NOT_AVAILABLE;
+			if(result == _CONNECTION_RESULT_PENDING) {
+				++ pending;
+				continue;
+			}
+			probe.handshakes[i] = NULL;
+			// a robot beats a bridge without one, otherwise the first answer wins
+			if(result != _CONNECTION_RESULT_NOT_AVAILABLE && (probe.found == NULL
+				|| (result == _CONNECTION_RESULT_FOUND && probe.result != _CONNECTION_RESULT_FOUND))) {
+				struct _connector* replaced = probe.found;
+
+				probe.found = temp;
+				probe.result = result;
+				temp = replaced;
+				if(result == _CONNECTION_RESULT_FOUND) {
+					probe.cancel = 1;
+				}
+			}
+			if(temp != NULL) {
+				_connector_dispose(temp);
+			}
+		}
+		if(pending == 0 && opening == 0) break;
+		_SLEEP(_CONNECTOR_PROBE_TICK);
+	}
+	for(i = 0; i < count; ++i) {
+		_thread_join(threads[i], -1);
+	}
+	_MUTEX_DESTROY(&probe.lock);
+	free(probe.handshakes);
+
+	if(probe.found != NULL) {
+		struct _connector* found = probe.found;
+
+		connector->serial = found->serial;
+		found->serial = NULL;
+		_STRCPY(connector->port_name, _TEMP_CHAR_BUFFER_SIZE, found->port_name);
+		if(probe.result == _CONNECTION_RESULT_FOUND) {
+			_connector_set_address(connector, found->address);
+			_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTED);
+		} else {
+			_connector_print_error(connector, probe.result);
+		}
+		_connector_dispose(found);
+	}
+	return probe.result;
+}
+
+_THREAD_PROC _connector_probe_proc(void* arg) {
+	struct _connector_probe* probe = (struct _connector_probe*)arg;
+	struct _connector* connector = probe->connector;
+	struct _connector* temp;
+	struct _serial* serial;
+	int index;
+
+	while(probe->cancel == 0) {
+		_MUTEX_LOCK(&probe->lock);
+		index = probe->next < probe->port_count ? probe->next++ : -1;
+		_MUTEX_UNLOCK(&probe->lock);
+		if(index < 0) break;
+
+		temp = _connector_create(connector->tag, connector->index, connector->packet_length, connector->delimiter);
+		temp->identity_request = connector->identity_request;
+		temp->parse_identity = connector->parse_identity;
+		temp->probing = 1;
+		serial = _connector_open_serial(temp, probe->port_names[index], probe->baud_rate, probe->flow_control);
+		if(serial == NULL) {
+			_connector_dispose(temp);
+			continue;
+		}
+		temp->serial = serial;
+		_connector_start_handshake(temp, serial, _CONNECTOR_HANDSHAKE_LISTEN);
+		_MUTEX_LOCK(&probe->lock);
+		probe->handshakes[probe->handshake_count++] = temp; // the probing thread owns it from here
+		_MUTEX_UNLOCK(&probe->lock);
+	}
+	_MUTEX_LOCK(&probe->lock);
+	-- probe->opening;
+	_MUTEX_UNLOCK(&probe->lock);
+	return 0;
+}
+
+void _connector_start_handshake(struct _connector* connector, struct _serial* serial, int handshake) {
+	unsigned long long now = _clock_get_time();
+
+	connector->handshake = handshake;
+	connector->handshake_lines = 0;
+	connector->handshake_lengths[0] = 0;
+	connector->handshake_lengths[1] = 0;
+	if(handshake == _CONNECTOR_HANDSHAKE_IDENTIFY) {
+		// sent once: the reply may come after a few frames that were on their way
+		_serial_write(serial, connector->identity_request, (int)strlen(connector->identity_request));
+		connector->handshake_deadline = now + _CONNECTOR_IDENTIFY_TIMEOUT * _CLOCK_MILLISECOND;
+	} else {
+		connector->handshake_deadline = now + _CONNECTOR_READ_TIMEOUT * _CLOCK_MILLISECOND;
+	}
+}
+
+int _connector_listen(struct _connector* connector, struct _serial* serial, int length) {
+	int* lengths = connector->handshake_lengths;
+
+	// the first line may have been cut by opening the port, the next two tell what is on the other side
+	if(connector->handshake_lines ++ > 0) {
+		lengths[0] = lengths[1];
+		lengths[1] = length;
+	}
+	if(connector->handshake_lines < 3) {
+		connector->handshake_deadline = _clock_get_time() + _CONNECTOR_READ_TIMEOUT * _CLOCK_MILLISECOND;
+		return _CONNECTION_RESULT_PENDING;
+	}
+	connector->handshake = _CONNECTOR_HANDSHAKE_NONE;
+	if(lengths[1] == connector->packet_length) {
+		if(connector->parse_identity != NULL) {
+			_connector_start_handshake(connector, serial, _CONNECTOR_HANDSHAKE_IDENTIFY);
+			return _CONNECTION_RESULT_PENDING;
+		}
+	} else if(lengths[0] != 0 && lengths[1] == 2) {
+		_connector_print_error(connector, _CONNECTION_RESULT_NOT_CONNECTED);
+		return _CONNECTION_RESULT_NOT_CONNECTED;
+	}
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+int _connector_feed_handshake(struct _connector* connector, struct _serial* serial, const char* line, int length) {
+	const char* request = connector->identity_request;
+	int result;
+
+	switch(connector->handshake) {
+		case _CONNECTOR_HANDSHAKE_LISTEN:
+			return _connector_listen(connector, serial, length);
+		case _CONNECTOR_HANDSHAKE_IDENTIFY:
+			if(length < 2 || line[0] != request[0] || line[1] != request[1]) {
+				return _CONNECTION_RESULT_PENDING; // a frame sent before the reply
+			}
+			connector->handshake = _CONNECTOR_HANDSHAKE_NONE;
+			result = connector->parse_identity(connector, line, length);
+			if(result == _CONNECTION_RESULT_FOUND && connector->expected_address != NULL
+				&& _connector_match_field(connector->address, (int)strlen(connector->address), connector->expected_address) == 0) {
+				connector->handshake = _CONNECTOR_HANDSHAKE_IDENTIFY;
+				return _CONNECTION_RESULT_PENDING; // another robot behind the bridge: the one waited for may answer too
+			}
+			if(result == _CONNECTION_RESULT_FOUND && _serial_claim(serial, connector->address) == 0) {
+				return _CONNECTION_RESULT_NOT_AVAILABLE; // the robot of another connector behind the same bridge
+			}
+			if(result == _CONNECTION_RESULT_FOUND) {
+				_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTED);
+			}
+			return result;
+	}
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+int _connector_step_handshake(struct _connector* connector, struct _serial* serial, int timeout) {
+	int length, result;
+
+	// everything that has arrived, waiting up to timeout for the first line: 0 never blocks
+	while((length = _serial_read_string_timeout(serial, connector->buffer, _CONNECTOR_BUFFER_SIZE, connector->delimiter, timeout)) != 0) {
+		result = _connector_feed_handshake(connector, serial, connector->buffer, length);
+		if(result != _CONNECTION_RESULT_PENDING) return result;
+		timeout = 0;
+	}
+	if(connector->handshake == _CONNECTOR_HANDSHAKE_NONE) return _CONNECTION_RESULT_NOT_AVAILABLE;
+	if(_clock_get_time() < connector->handshake_deadline) return _CONNECTION_RESULT_PENDING;
+	if(connector->handshake == _CONNECTOR_HANDSHAKE_LISTEN) {
+		return _connector_listen(connector, serial, 0); // a line that did not come counts as empty
+	}
+	connector->handshake = _CONNECTOR_HANDSHAKE_NONE;
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+int _connector_match_field(const char* field, int length, const char* text) {
+	int i;
+
+	for(i = 0; i < length; ++i) {
+		if(text[i] == '\0' || ((unsigned char)field[i] | 0x20) != ((unsigned char)text[i] | 0x20)) return 0;
+	}
+	return text[length] == '\0' ? 1 : 0;
+}
+
+int _connector_check_port(struct _connector* connector, struct _serial* serial) {
+	unsigned long long now;
+	int result, timeout = 0;
+
+	_connector_start_handshake(connector, serial, _CONNECTOR_HANDSHAKE_LISTEN);
+	while((result = _connector_step_handshake(connector, serial, timeout)) == _CONNECTION_RESULT_PENDING) {
+		now = _clock_get_time();
+		timeout = (now < connector->handshake_deadline) ? (int)((connector->handshake_deadline - now + _CLOCK_MILLISECOND - 1) / _CLOCK_MILLISECOND) : 0;
+	}
+	return result;
+}
+
+struct _serial* _connector_open_serial(struct _connector* connector, const char* port_name, int baud_rate, int flow_control) {
+	struct _serial* serial = _serial_create();
+
+	if(_serial_open_shared(serial, port_name, baud_rate, flow_control, connector->delimiter) == 1) {
+		_serial_clear(serial);
+		serial->capture = connector->capture; // NULL for the temporary connectors of a probe
+		if(port_name != connector->port_name) { // opened again by the name it has
+			_STRCPY(connector->port_name, _TEMP_CHAR_BUFFER_SIZE, port_name);
+		}
+		return serial;
+	}
+	_serial_dispose(serial);
+	return NULL;
+}
+
+int _connector_open_port(struct _connector* connector, const char* port_name, int baud_rate, int flow_control) {
+	size_t mark = (connector->capture != NULL) ? _capture_get_length(connector->capture) : 0;
+	struct _serial* serial = _connector_open_serial(connector, port_name, baud_rate, flow_control);
+
+	if(serial != NULL) {
+		int result = _connector_check_port(connector, serial);
+
+		if(result != _CONNECTION_RESULT_NOT_AVAILABLE) {
+			connector->serial = serial;
+			return result;
+		}
+		if(connector->capture != NULL) {
+			_capture_rewind(connector->capture, mark); // a port without a bridge leaves nothing to replay
+		}
+		_serial_close(serial);
+		_serial_dispose(serial);
+	}
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+struct _capture* _connector_create_capture(const struct _connector* connector) {
+	char path[_TEMP_CHAR_BUFFER_SIZE];
+	const char* index = strstr(_capture_path, "%d");
+
+	if(index != NULL) { // one file per robot
+		snprintf(path, _TEMP_CHAR_BUFFER_SIZE, "%.*s%d%s", (int)(index - _capture_path), _capture_path, connector->index, index + 2);
+	} else if(connector->index > 0) { // the robots after the first must not write over its file: name-1.ext, name-2.ext...
+		const char* name = _capture_path;
+		const char* dot;
+
+		if(strrchr(name, '/') != NULL) name = strrchr(name, '/') + 1;
+		if(strrchr(name, '\\') != NULL) name = strrchr(name, '\\') + 1;
+		dot = strrchr(name, '.');
+		if(dot == NULL) dot = name + strlen(name);
+		snprintf(path, _TEMP_CHAR_BUFFER_SIZE, "%.*s-%d%s", (int)(dot - _capture_path), _capture_path, connector->index, dot);
+	} else {
+		snprintf(path, _TEMP_CHAR_BUFFER_SIZE, "%s", _capture_path);
+	}
+	return _capture_create(path);
+}
+
+void _connector_close(struct _connector* connector) {
+	if(connector == NULL) return;
+	_connector_drop_reopen(connector);
+	_connector_close_serial(connector);
+	connector->connected = 0;
+	connector->state = _CONNECTION_STATE_DISPOSED;
+	connector->retry_interval = 0;
+	_connector_print_state(connector, _CONNECTION_STATE_DISPOSED);
+}
+
+void _connector_close_serial(struct _connector* connector) {
+	struct _serial* serial;
+
+	_MUTEX_LOCK(&connector->write_lock);
+	serial = connector->serial;
+	connector->serial = NULL;
+	_MUTEX_UNLOCK(&connector->write_lock);
+	_MUTEX_LOCK(&connector->pending_lock);
+	connector->pending_length = 0; // meant for the link that is gone
+	_MUTEX_UNLOCK(&connector->pending_lock);
+	if(serial != NULL) {
+		_serial_dispose(serial);
+	}
+}
+
+int _connector_check_hotplug(struct _connector* connector) {
+	char port_name[_TEMP_CHAR_BUFFER_SIZE];
+	int type;
+
+	if(connector == NULL || connector->opened == 0) return 0;
+	// one port at a time: the events after it wait until its handshake is over
+	while(connector->reopening == NULL && _hotplug_next_event(&connector->hotplug_generation, &type, port_name) == 1) {
+		if(type == _HOTPLUG_REMOVED) {
+			if(connector->serial != NULL && strcmp(port_name, connector->port_name) == 0) {
+				_connector_lose(connector, _CONNECTION_STATE_DISCONNECTED);
+			}
+		} else if(connector->serial == NULL && _hotplug->mode == _HOTPLUG_ATTACH) {
+			if(connector->any_port == 0 && strcmp(port_name, connector->port_name) != 0) continue;
+			if(_connector_start_reopen(connector, port_name, 0) == 1) {
+				return _connector_step_reopen(connector);
+			}
+		}
+	}
+	return 0;
+}
+
+void _connector_lose(struct _connector* connector, int state) {
+	connector->retry_interval = (connector->serial->transport->reopen == 1) ? _CONNECTOR_RETRY_MIN : 0;
+	connector->retry_time = _clock_get_time() + connector->retry_interval * _CLOCK_MILLISECOND;
+	_connector_close_serial(connector);
+	_connector_set_connection_state(connector, state);
+}
+
+int _connector_start_reopen(struct _connector* connector, const char* port_name, int retry) {
+	struct _serial* serial;
+
+	connector->reopen_mark = (connector->capture != NULL) ? _capture_get_length(connector->capture) : 0;
+	serial = _connector_open_serial(connector, port_name, connector->baud_rate, connector->flow_control);
+	if(serial == NULL) return 0;
+	connector->probing = 1; // quiet unless a robot answers
+	connector->reopen_retry = retry;
+	connector->reopening = serial;
+	_connector_start_handshake(connector, serial, _CONNECTOR_HANDSHAKE_LISTEN);
+	return 1;
+}
+
+int _connector_step_reopen(struct _connector* connector) { // on the robot thread, 1 when the port is back
+	struct _serial* serial = connector->reopening;
+	int result;
+
+	if(serial == NULL) return 0;
+	result = _connector_step_handshake(connector, serial, 0);
+	if(result == _CONNECTION_RESULT_PENDING) return 0;
+	connector->probing = 0;
+	if(result == _CONNECTION_RESULT_NOT_AVAILABLE) {
+		_connector_drop_reopen(connector);
+		if(connector->reopen_retry == 1) {
+			_connector_retry_later(connector);
+		}
+		return 0;
+	}
+	connector->reopening = NULL;
+	_MUTEX_LOCK(&connector->write_lock);
+	connector->serial = serial;
+	_MUTEX_UNLOCK(&connector->write_lock);
+	if(result == _CONNECTION_RESULT_FOUND) {
+		_connector_print_state(connector, _CONNECTION_STATE_CONNECTED);
+		if(connector->reopen_retry == 0 && connector->any_port == 1) {
+			_connector_save_cache(connector);
+		}
+		return 1;
+	}
+	if(connector->reopen_retry == 1) { // the bridge is back but not the robot: ask again later
+		_connector_close_serial(connector);
+		_connector_retry_later(connector);
+		return 0;
+	}
+	_connector_print_error(connector, result); // kept open for the robot to be turned on
+	return 1;
+}
+
+void _connector_drop_reopen(struct _connector* connector) {
+	struct _serial* serial = connector->reopening;
+
+	if(serial == NULL) return;
+	connector->reopening = NULL;
+	connector->probing = 0;
+	if(connector->capture != NULL) {
+		_capture_rewind(connector->capture, connector->reopen_mark); // a port without a bridge leaves nothing to replay
+	}
+	_serial_close(serial);
+	_serial_dispose(serial);
+}
+
+int _connector_reconnect(struct _connector* connector) {
+	if(connector == NULL || connector->opened == 0 || connector->serial != NULL) return 0;
+	if(connector->reopening != NULL) return _connector_step_reopen(connector);
+	if(connector->retry_interval == 0 || _clock_get_time() < connector->retry_time) return 0;
+	connector->state = _CONNECTION_STATE_CONNECTING;
+	if(_connector_start_reopen(connector, connector->port_name, 1) == 0) {
+		_connector_retry_later(connector);
+		return 0;
+	}
+	return _connector_step_reopen(connector);
+}
+
+void _connector_retry_later(struct _connector* connector) {
+	connector->state = _CONNECTION_STATE_CONNECTION_LOST;
+	connector->retry_interval *= 2;
+	if(connector->retry_interval > _CONNECTOR_RETRY_MAX) {
+		connector->retry_interval = _CONNECTOR_RETRY_MAX;
+	}
+	connector->retry_time = _clock_get_time() + connector->retry_interval * _CLOCK_MILLISECOND;
+}
+
+int _connector_is_connected(const struct _connector* connector) {
+	if(connector == NULL) return 0;
+	return connector->connected;
+}
+
+const char* _connector_get_port_name(const struct _connector* connector) {
+	if(connector == NULL) return "";
+	return connector->port_name;
+}
+
+const char* _connector_get_address(const struct _connector* connector) {
+	if(connector == NULL) return _DEFAULT_ADDRESS;
+	return connector->address;
+}
+
+void _connector_set_address(const struct _connector* connector, const char* address) {
+	if(connector == NULL) return;
+	_STRCPY(connector->address, _CONNECTOR_INFO_BUFFER_SIZE, address);
+}
+
+void _connector_set_connection_state(struct _connector* connector, int state) {
+	if(connector == NULL) return;
+	connector->state = state;
+	connector->connected = (state == _CONNECTION_STATE_CONNECTED) ? 1 : 0;
+	if(connector->connected == 1) {
+		connector->timestamp = _clock_get_time(); // the loss timeout starts here
+		connector->retry_interval = 0;
+	}
+	if(connector->found == 0 && connector->connected == 1) {
+		connector->found = 1;
+	}
+	if(connector->found == 1) {
+		_connector_print_state(connector, state);
+	}
+}
+
+void _connector_write(struct _connector* connector, const char* buffer, int buffer_size) {
+	if(connector == NULL || connector->serial == NULL || buffer_size > connector->packet_length) return;
+	_MUTEX_LOCK(&connector->pending_lock);
+	memcpy(connector->pending, buffer, buffer_size); // a packet the link has not taken yet is stale now
+	connector->pending_length = buffer_size;
+	_MUTEX_UNLOCK(&connector->pending_lock);
+	if(connector->queued == 0) {
+		connector->queued = 1;
+		_writer_add(connector);
+	}
+	_writer_signal();
+}
+
+int _connector_flush(struct _connector** connectors, int index, int count, int gather) { // on the writer thread: 0 or _WRITER_*
+	char packets[_SERIAL_MAX_WRITE_FRAMES][_CONNECTOR_BUFFER_SIZE];
+	struct _serial_frame frames[_SERIAL_MAX_WRITE_FRAMES];
+	struct _serial* serials[_SERIAL_MAX_WRITE_FRAMES];
+	struct _connector* held[_SERIAL_MAX_WRITE_FRAMES];
+	struct _connector* connector = connectors[index];
+	struct _connector* other;
+	const void* port;
+	int held_count = 0, frames_count = 0, missing = 0, i;
+
+	if(connector->pending_length == 0) return 0;
+	_MUTEX_LOCK(&connector->write_lock);
+	if(connector->serial == NULL) {
+		_MUTEX_UNLOCK(&connector->write_lock);
+		return 0;
+	}
+	if(_serial_can_write(connector->serial) == 0) {
+		_MUTEX_UNLOCK(&connector->write_lock);
+		return _WRITER_BLOCKED; // keep it: a newer one may replace it in the meantime
+	}
+	held[held_count++] = connector;
+	// robots behind the same bridge go out in one gathered write; only this thread holds more than one write lock
+	port = _serial_get_port(connector->serial);
+	for(i = 0; i < count && held_count < _SERIAL_MAX_WRITE_FRAMES; ++i) {
+		other = connectors[i];
+		if(other == connector) continue;
+		_MUTEX_LOCK(&other->write_lock);
+		if(other->serial != NULL && _serial_get_port(other->serial) == port) {
+			if(other->pending_length > 0) {
+				held[held_count++] = other;
+				continue;
+			}
+			if(other->connected == 1) ++ missing; // its packet of this tick is still to come
+		}
+		_MUTEX_UNLOCK(&other->write_lock);
+	}
+	if(missing > 0 && gather == 1) {
+		for(i = 0; i < held_count; ++i) {
+			_MUTEX_UNLOCK(&held[i]->write_lock);
+		}
+		return _WRITER_GATHERING;
+	}
+	for(i = 0; i < held_count; ++i) {
+		other = held[i];
+		_MUTEX_LOCK(&other->pending_lock);
+		if(other->pending_length > 0) { // not dropped by a close in the meantime
+			memcpy(packets[frames_count], other->pending, other->pending_length);
+			frames[frames_count].data = packets[frames_count];
+			frames[frames_count].length = other->pending_length;
+			serials[frames_count++] = other->serial;
+			other->pending_length = 0;
+		}
+		_MUTEX_UNLOCK(&other->pending_lock);
+	}
+	if(frames_count > 0) {
+		_serial_write_frames(serials, frames, frames_count);
+	}
+	for(i = 0; i < held_count; ++i) {
+		_MUTEX_UNLOCK(&held[i]->write_lock);
+	}
+	return 0;
+}
+
+int _connector_wait(const struct _connector* connector, int timeout) {
+	int result = -1;
+
+	if(connector != NULL && connector->serial != NULL) {
+		result = _serial_wait(connector->serial, connector->delimiter, timeout);
+	} else if(connector != NULL && connector->reopening != NULL) {
+		result = _serial_wait(connector->reopening, connector->delimiter, timeout); // the next line of its handshake
+	}
+	if(result < 0) {
+		_SLEEP(timeout); // not opened or port error: don't spin
+		return 0;
+	}
+	return result;
+}
+
+int _connector_check_frame(struct _connector* connector, struct _serial_frame* frame) {
+	const unsigned char* data = (const unsigned char*)frame->data;
+	const char* address;
+	unsigned int c, bad = 0;
+	int i;
+
+	if(data == NULL) return 0; // rejected before
+	if(frame->length == connector->packet_length && data[_DATA_LENGTH] == '-') {
+		// one pass without branches on the data so the compiler can vectorize it
+		for(i = 0; i < _DATA_LENGTH; ++i) {
+			c = data[i];
+			bad |= ((c - '0') > 9u) & (((c | 0x20) - 'a') > 5u);
+		}
+		if(bad == 0 && connector->found == 1) {
+			address = connector->address;
+			for(i = 0; i < _ADDRESS_LENGTH; ++i) {
+				bad |= (data[_DATA_LENGTH + 1 + i] | 0x20) ^ ((unsigned char)address[i] | 0x20);
+			}
+		}
+		if(bad == 0) return 1;
+	}
+	++ connector->rejected_frames;
+	frame->data = NULL; // keep the length so that the frame is still released
+	return 0;
+}
+
+int _connector_read_latest(struct _connector* connector) {
+	struct _serial* serial = connector->serial;
+	struct _serial_frame* frames = connector->frames;
+	int count, last, i;
+
+	count = _serial_read_frames(serial, connector->delimiter, frames, _CONNECTOR_MAX_FRAMES);
+	while(count == _CONNECTOR_MAX_FRAMES) {
+		// more may be queued: keep only the newest of this batch and read on
+		last = count - 1;
+		for(i = 0; i < last; ++i) {
+			if(_connector_check_frame(connector, &frames[i]) == 1) ++ connector->discarded_frames;
+		}
+		_serial_release_frames(serial, frames, last);
+		count = _serial_read_frames(serial, connector->delimiter, frames, _CONNECTOR_MAX_FRAMES);
+	}
+	for(last = count - 1; last > 0; --last) {
+		if(_connector_check_frame(connector, &frames[last]) == 1) break;
+	}
+	if(last > 0) {
+		for(i = 0; i < last; ++i) {
+			if(_connector_check_frame(connector, &frames[i]) == 1) ++ connector->discarded_frames;
+		}
+		_serial_release_frames(serial, frames, last);
+		for(i = last; i < count; ++i) {
+			frames[i - last] = frames[i];
+		}
+		count -= last;
+	}
+	return count;
+}
+
+int _connector_read(struct _connector* connector) {
+	int count, valid = 0, i;
+
+	if(connector == NULL || connector->serial == NULL) return 0;
+	if(connector->receive_mode == _CONNECTOR_RECEIVE_LATEST && connector->found == 1) {
+		count = _connector_read_latest(connector);
+	} else {
+		count = _serial_read_frames(connector->serial, connector->delimiter, connector->frames, _CONNECTOR_MAX_FRAMES);
+	}
+	if(connector->handshake == _CONNECTOR_HANDSHAKE_IDENTIFY) {
+		// the reply comes in between the frames: look for it without waiting
+		for(i = 0; i < count && connector->handshake == _CONNECTOR_HANDSHAKE_IDENTIFY; ++i) {
+			_connector_feed_handshake(connector, connector->serial, connector->frames[i].data, connector->frames[i].length);
+		}
+		if(connector->handshake == _CONNECTOR_HANDSHAKE_IDENTIFY && _clock_get_time() >= connector->handshake_deadline) {
+			connector->handshake = _CONNECTOR_HANDSHAKE_NONE; // asked again with the next frames
+		}
+	}
+	for(i = 0; i < count; ++i) {
+		if(_connector_check_frame(connector, &connector->frames[i]) == 1) {
+			++ valid;
+		}
+	}
+	connector->frames_count = count;
+	if(valid > 0) {
+		if(connector->found == 0) {
+			_connector_release(connector);
+			if(connector->handshake == _CONNECTOR_HANDSHAKE_NONE && connector->parse_identity != NULL) {
+				_connector_start_handshake(connector, connector->serial, _CONNECTOR_HANDSHAKE_IDENTIFY);
+			}
+			valid = 0;
+		} else if(connector->connected == 0) {
+			_connector_set_connection_state(connector, _CONNECTION_STATE_CONNECTED);
+		}
+		connector->timestamp = _clock_get_time();
+		return valid;
+	}
+	_connector_release(connector); // nothing for the decoder
+	if(connector->connected == 1 && _clock_get_time() - connector->timestamp > connector->loss_timeout * _CLOCK_MILLISECOND) {
+		_connector_lose(connector, _CONNECTION_STATE_CONNECTION_LOST);
+	}
+	return 0;
+}
+
+void _connector_release(struct _connector* connector) {
+	if(connector == NULL || connector->serial == NULL) return;
+	_serial_release_frames(connector->serial, connector->frames, connector->frames_count);
+	connector->frames_count = 0;
+}
+
+void _connector_print_state(const struct _connector* connector, int state) {
+	if(connector->probing == 1) return;
+	switch(state) {
+		case _CONNECTION_STATE_CONNECTED:
+			printf("%s[%d] Connected: %s\n", connector->tag, connector->index, connector->port_name);
+			break;
+		case _CONNECTION_STATE_CONNECTION_LOST:
+			printf("%s[%d] Connection lost\n", connector->tag, connector->index);
+			break;
+		case _CONNECTION_STATE_DISCONNECTED:
+			printf("%s[%d] Disconnected\n", connector->tag, connector->index);
+			break;
+		case _CONNECTION_STATE_DISPOSED:
+			printf("%s[%d] Disposed\n", connector->tag, connector->index);
+			break;
+	}
+}
+
+void _connector_print_error(const struct _connector* connector, int error_code) {
+	if(connector->probing == 1) return;
+	switch(error_code) {
+		case _CONNECTION_RESULT_NOT_AVAILABLE:
+			printf("%s[%d] No available USB to BLE bridge\n", connector->tag, connector->index);
+			break;
+		case _CONNECTION_RESULT_NOT_CONNECTED:
+			printf("%s[%d] Not connected\n", connector->tag, connector->index);
+			break;
+	}
+}
+
+/*------------------------------
+  DEVICE
+------------------------------*/
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+struct _device {
+	char* name;
+	int id;
+	int device_type;
+	int data_type;
+	int data_size;
+	int data_len;
+	void* data;
+	float min_value;
+	float max_value;
+	float initial_value;
+	int event;
+	int fired;
+	int written;
+	void (*reset)(struct _device* device);
+	int (*read)(const struct _device* device);
+	int (*read_at)(const struct _device* device, int index);
+	int (*read_array)(const struct _device* device, int* data, int length);
+	float (*read_float)(const struct _device* device);
+	float (*read_float_at)(const struct _device* device, int index);
+	int (*read_float_array)(const struct _device* device, float* data, int length);
+	int (*write)(struct _device* device, int data);
+	int (*write_at)(struct _device* device, int index, int data);
+	int (*write_array)(struct _device* device, const int* data, int length);
+	int (*write_float)(struct _device* device, float data);
+	int (*write_float_at)(struct _device* device, int index, float data);
+	int (*write_float_array)(struct _device* device, const float* data, int length);
+	int (*put)(struct _device* device, int data);
+	int (*put_at)(struct _device* device, int index, int data);
+	int (*put_array)(struct _device* device, const int* data, int length);
+	int (*put_float)(struct _device* device, float data);
+	int (*put_float_at)(struct _device* device, int index, float data);
+	int (*put_float_array)(struct _device* device, const float* data, int length);
+};
+
+struct _device* _device_create(int id, const char* name, int device_type, int data_type, int data_size, float min_value, float max_value, float initial_value);
+void _device_dispose(struct _device* device);
+const char* _device_get_name(const struct _device* device);
+void _device_set_name(struct _device* device, const char* name);
+int _device_get_id(const struct _device* device);
+int _device_get_device_type(const struct _device* device);
+int _device_get_data_type(const struct _device* device);
+int _device_get_data_size(const struct _device* device);
+int _device_e(const struct _device* device);
+void _device_reset(struct _device* device);
+int _device_read(const struct _device* device);
+int _device_read_at(const struct _device* device, int index);
+int _device_read_array(const struct _device* device, int* data, int length);
+float _device_read_float(const struct _device* device);
+float _device_read_float_at(const struct _device* device, int index);
+int _device_read_float_array(const struct _device* device, float* data, int length);
+int _device_write(struct _device* device, int data);
+int _device_write_at(struct _device* device, int index, int data);
+int _device_write_array(struct _device* device, const int* data, int length);
+int _device_write_float(struct _device* device, float data);
+int _device_write_float_at(struct _device* device, int index, float data);
+int _device_write_float_array(struct _device* device, const float* data, int length);
+int _device_put(struct _device* device, int data);
+int _device_put_at(struct _device* device, int index, int data);
+int _device_put_array(struct _device* device, const int* data, int length);
+int _device_put_float(struct _device* device, float data);
+int _device_put_float_at(struct _device* device, int index, float data);
+int _device_put_float_array(struct _device* device, const float* data, int length);
+void _device_update_device_state(struct _device* device);
+
+void _int_device_reset(struct _device* device) {
+	int* this_data = (int*)device->data;
+	
+	if(this_data != NULL) {
+		int this_len = device->data_len, i;
+		int initial_value = (int)device->initial_value;
+		
+		for(i = 0; i < this_len; ++i) {
+			this_data[i] = initial_value;
+		}
+	}
+	device->event = 0;
+	device->fired = 0;
+	device->written = 0;
+}
+
+int _int_device_read(const struct _device* device) {
+	int* this_data;
+	
+	if(device->data_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	return this_data[0];
+}
+
+int _int_device_read_at(const struct _device* device, int index) {
+	int* this_data;
+
+	if(index < 0 || index >= device->data_len) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	return this_data[index];
+}
+
+int _int_device_read_array(const struct _device* device, int* data, int length) {
+	int* this_data;
+	int this_len, len;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	memcpy(data, this_data, sizeof(int) * len);
+	return len;
+}
+
+float _int_device_read_float(const struct _device* device) {
+	return (float)_int_device_read(device);
+}
+
+float _int_device_read_float_at(const struct _device* device, int index) {
+	return (float)_int_device_read_at(device, index);
+}
+
+int _int_device_read_float_array(const struct _device* device, float* data, int length) {
+	int* this_data;
+	int this_len, len, i;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	for(i = 0; i < len; ++i) {
+		data[i] = (float)this_data[i];
+	}
+	return len;
+}
+
+int _int_device_write(struct _device* device, int data) {
+	int* this_data;
+	int min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(device->data_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	min_value = (int)device->min_value;
+	max_value = (int)device->max_value;
+	if(data < min_value) data = min_value;
+	else if(data > max_value) data = max_value;
+	
+	this_data[0] = data;
+	device->fired = 1;
+	device->written = 1;
+	return 1;
+}
+
+int _int_device_write_at(struct _device* device, int index, int data) {
+	int* this_data;
+	int min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(index < 0 || index >= device->data_len) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	min_value = (int)device->min_value;
+	max_value = (int)device->max_value;
+	if(data < min_value) data = min_value;
+	else if(data > max_value) data = max_value;
+	
+	this_data[index] = data;
+	device->fired = 1;
+	device->written = 1;
+	return 1;
+}
+
+int _int_device_write_array(struct _device* device, const int* data, int length) {
+	int* this_data;
+	int this_len, len, i;
+	int value, min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	min_value = (int)device->min_value;
+	max_value = (int)device->max_value;
+	for(i = 0; i < len; ++i) {
+		value = data[i];
+		if(value < min_value) value = min_value;
+		else if(value > max_value) value = max_value;
+		this_data[i] = value;
+	}
+	device->fired = 1;
+	device->written = 1;
+	return len;
+}
+
+int _int_device_write_float(struct _device* device, float data) {
+	return _int_device_write(device, (int)data);
+}
+
+int _int_device_write_float_at(struct _device* device, int index, float data) {
+	return _int_device_write_at(device, index, (int)data);
+}
+
+int _int_device_write_float_array(struct _device* device, const float* data, int length) {
+	int* this_data;
+	int this_len, len, i;
+	int value, min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	min_value = (int)device->min_value;
+	max_value = (int)device->max_value;
+	for(i = 0; i < len; ++i) {
+		value = (int)data[i];
+		if(value < min_value) value = min_value;
+		else if(value > max_value) value = max_value;
+		this_data[i] = value;
+	}
+	device->fired = 1;
+	device->written = 1;
+	return len;
+}
+
+int _int_device_put(struct _device* device, int data) {
+	int* this_data;
+
+	if(device->data_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	this_data[0] = data;
+	device->fired = 1;
+	return 1;
+}
+
+int _int_device_put_at(struct _device* device, int index, int data) {
+	int* this_data;
+
+	if(index < 0 || index >= device->data_len) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	this_data[index] = data;
+	device->fired = 1;
+	return 1;
+}
+
+int _int_device_put_array(struct _device* device, const int* data, int length) {
+	int* this_data;
+	int this_len, len;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	memcpy(this_data, data, sizeof(int) * len);
+	device->fired = 1;
+	return len;
+}
+
+int _int_device_put_float(struct _device* device, float data) {
+	return _int_device_put(device, (int)data);
+}
+
+int _int_device_put_float_at(struct _device* device, int index, float data) {
+	return _int_device_put_at(device, index, (int)data);
+}
+
+int _int_device_put_float_array(struct _device* device, const float* data, int length) {
+	int* this_data;
+	int this_len, len, i;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (int*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	for(i = 0; i < len; ++i) {
+		this_data[i] = (int)data[i];
+	}
+	device->fired = 1;
+	return len;
+}
+
+void _float_device_reset(struct _device* device) {
+	float* this_data = (float*)device->data;
+	
+	if(this_data != NULL) {
+		int this_len = device->data_len, i;
+		float initial_value = device->initial_value;
+		
+		for(i = 0; i < this_len; ++i) {
+			this_data[i] = initial_value;
+		}
+	}
+	device->event = 0;
+	device->fired = 0;
+	device->written = 0;
+}
+
+int _float_device_read_array(const struct _device* device, int* data, int length) {
+	float* this_data;
+	int this_len, len, i;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	for(i = 0; i < len; ++i) {
+		data[i] = (int)this_data[i];
+	}
+	return len;
+}
+
+float _float_device_read_float(const struct _device* device) {
+	float* this_data;
+
+	if(device->data_len <= 0) return 0.0f;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0.0f;
+	
+	return this_data[0];
+}
+
+float _float_device_read_float_at(const struct _device* device, int index) {
+	float* this_data;
+
+	if(index < 0 || index >= device->data_len) return 0.0f;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0.0f;
+	
+	return this_data[index];
+}
+
+int _float_device_read(const struct _device* device) {
+	return (int)_float_device_read_float(device);
+}
+
+int _float_device_read_at(const struct _device* device, int index) {
+	return (int)_float_device_read_float_at(device, index);
+}
+
+int _float_device_read_float_array(const struct _device* device, float* data, int length) {
+	float* this_data;
+	int this_len, len;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	memcpy(data, this_data, sizeof(float) * len);
+	return len;
+}
+
+int _float_device_write_array(struct _device* device, const int* data, int length) {
+	float* this_data;
+	int this_len, len, i;
+	float value, min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	min_value = device->min_value;
+	max_value = device->max_value;
+	for(i = 0; i < len; ++i) {
+		value = (float)data[i];
+		if(value < min_value) value = min_value;
+		else if(value > max_value) value = max_value;
+		this_data[i] = value;
+	}
+	device->fired = 1;
+	device->written = 1;
+	return len;
+}
+
+int _float_device_write_float(struct _device* device, float data) {
+	float* this_data;
+	float min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(device->data_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	min_value = device->min_value;
+	max_value = device->max_value;
+	if(data < min_value) data = min_value;
+	else if(data > max_value) data = max_value;
+	
+	this_data[0] = data;
+	device->fired = 1;
+	device->written = 1;
+	return 1;
+}
+
+int _float_device_write_float_at(struct _device* device, int index, float data) {
+	float* this_data;
+	float min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(index < 0 || index >= device->data_len) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	min_value = device->min_value;
+	max_value = device->max_value;
+	if(data < min_value) data = min_value;
+	else if(data > max_value) data = max_value;
+	
+	this_data[index] = data;
+	device->fired = 1;
+	device->written = 1;
+	return 1;
+}
+
+int _float_device_write(struct _device* device, int data) {
+	return _float_device_write_float(device, (float)data);
+}
+
+int _float_device_write_at(struct _device* device, int index, int data) {
+	return _float_device_write_float_at(device, index, (float)data);
+}
+
+int _float_device_write_float_array(struct _device* device, const float* data, int length) {
+	float* this_data;
+	int this_len, len, i;
+	float value, min_value, max_value;
+
+	if(device->device_type == DEVICE_TYPE_SENSOR || device->device_type == DEVICE_TYPE_EVENT) return 0;
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	min_value = device->min_value;
+	max_value = device->max_value;
+	for(i = 0; i < len; ++i) {
+		value = data[i];
+		if(value < min_value) value = min_value;
+		else if(value > max_value) value = max_value;
+		this_data[i] = value;
+	}
+	device->fired = 1;
+	device->written = 1;
+	return len;
+}
+
+int _float_device_put_array(struct _device* device, const int* data, int length) {
+	float* this_data;
+	int this_len, len, i;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	for(i = 0; i < len; ++i) {
+		this_data[i] = (float)data[i];
+	}
+	device->fired = 1;
+	return len;
+}
+
+int _float_device_put_float(struct _device* device, float data) {
+	float* this_data;
+
+	if(device->data_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	this_data[0] = data;
+	device->fired = 1;
+	return 1;
+}
+
+int _float_device_put_float_at(struct _device* device, int index, float data) {
+	float* this_data;
+
+	if(index < 0 || index >= device->data_len) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	this_data[index] = data;
+	device->fired = 1;
+	return 1;
+}
+
+int _float_device_put(struct _device* device, int data) {
+	return _float_device_put_float(device, (float)data);
+}
+
+int _float_device_put_at(struct _device* device, int index, int data) {
+	return _float_device_put_float_at(device, index, (float)data);
+}
+
+int _float_device_put_float_array(struct _device* device, const float* data, int length) {
+	float* this_data;
+	int this_len, len;
+
+	if(data == NULL) return 0;
+	if(length <= 0) return 0;
+	
+	this_len = device->data_len;
+	if(this_len <= 0) return 0;
+	this_data = (float*)device->data;
+	if(this_data == NULL) return 0;
+	
+	len = MIN(this_len, length);
+	memcpy(this_data, data, sizeof(float) * len);
+	device->fired = 1;
+	return len;
+}
+
+struct _device* _device_create(int id, const char* name, int device_type, int data_type, int data_size, float min_value, float max_value, float initial_value) {
+	if(data_type == DATA_TYPE_INTEGER || data_type == DATA_TYPE_FLOAT) {
+		struct _device* device = (struct _device*)malloc(sizeof(struct _device));
+		int len;
+
+		if(name == NULL) name = "";
+		len = strlen(name) + 1;
+		device->name = (char*)malloc(sizeof(char) * len);
+		_STRCPY(device->name, len, name);
+
+		device->id = id & 0xfff00fff;
+		device->device_type = device_type;
+		device->data_type = data_type;
+		device->data_size = data_size;
+		device->data_len = 0;
+		device->data = NULL;
+		device->min_value = min_value;
+		device->max_value = max_value;
+		device->initial_value = initial_value;
+		device->event = 0;
+		device->fired = 0;
+		device->written = 0;
+
+		if(data_type == DATA_TYPE_INTEGER) {
+			device->reset = _int_device_reset;
+			device->read = _int_device_read;
+			device->read_at = _int_device_read_at;
+			device->read_array = _int_device_read_array;
+			device->read_float = _int_device_read_float;
+			device->read_float_at = _int_device_read_float_at;
+			device->read_float_array = _int_device_read_float_array;
+			device->write = _int_device_write;
+			device->write_at = _int_device_write_at;
+			device->write_array = _int_device_write_array;
+			device->write_float = _int_device_write_float;
+			device->write_float_at = _int_device_write_float_at;
+			device->write_float_array = _int_device_write_float_array;
+			device->put = _int_device_put;
+			device->put_at = _int_device_put_at;
+			device->put_array = _int_device_put_array;
+			device->put_float = _int_device_put_float;
+			device->put_float_at = _int_device_put_float_at;
+			device->put_float_array = _int_device_put_float_array;
+		
+			if(data_size > 0) {
+				int* data;
+				int i;
+
+				data = (int*)malloc(sizeof(int) * data_size);
+				for(i = 0; i < data_size; ++i) {
+					data[i] = (int)initial_value;
+				}
+				device->data = data;
+				device->data_len = data_size;
+			}
+		} else if(data_type == DATA_TYPE_FLOAT) {
+			device->reset = _float_device_reset;
+			device->read = _float_device_read;
+			device->read_at = _float_device_read_at;
+			device->read_array = _float_device_read_array;
+			device->read_float = _float_device_read_float;
+			device->read_float_at = _float_device_read_float_at;
+			device->read_float_array = _float_device_read_float_array;
+			device->write = _float_device_write;
+			device->write_at = _float_device_write_at;
+			device->write_array = _float_device_write_array;
+			device->write_float = _float_device_write_float;
+			device->write_float_at = _float_device_write_float_at;
+			device->write_float_array = _float_device_write_float_array;
+			device->put = _float_device_put;
+			device->put_at = _float_device_put_at;
+			device->put_array = _float_device_put_array;
+			device->put_float = _float_device_put_float;
+			device->put_float_at = _float_device_put_float_at;
+			device->put_float_array = _float_device_put_float_array;
+		
+			if(data_size > 0) {
+				float* data;
+				int i;
+
+				data = (float*)malloc(sizeof(float) * data_size);
+				for(i = 0; i < data_size; ++i) {
+					data[i] = initial_value;
+				}
+				device->data = data;
+				device->data_len = data_size;
+			}
+		}
+		return device;
+	}
+	return NULL;
+}
+
+void _device_dispose(struct _device* device) {
+	if(device == NULL) return;
+	
+	if(device->name != NULL) {
+		free(device->name);
+		device->name = NULL;
+	}
+	if(device->data_type == DATA_TYPE_INTEGER) {
+		int* data = (int*)device->data;
+		if(data != NULL) {
+			free(data);
+			device->data = NULL;
+		}
+	} else if(device->data_type == DATA_TYPE_FLOAT) {
+		float* data = (float*)device->data;
+		if(data != NULL) {
+			free(data);
+			device->data = NULL;
+		}
+	}
+	free(device);
+}
+
+const char* _device_get_name(const struct _device* device) {
+	if(device == NULL) return "";
+	return device->name;
+}
+
+void _device_set_name(struct _device* device, const char* name) {
+	int len;
+
+	if(device == NULL) return;
+	if(name == NULL) name = "";
+	if(device->name != NULL) {
+		free(device->name);
+	}
+	len = strlen(name) + 1;
+	device->name = (char*)malloc(sizeof(char) * len);
+	_STRCPY(device->name, len, name);
+}
+
+int _device_get_id(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->id;
+}
+
+int _device_get_device_type(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->device_type;
+}
+
+int _device_get_data_type(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->data_type;
+}
+
+int _device_get_data_size(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->data_size;
+}
+
+int _device_e(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->event;
+}
+
+void _device_reset(struct _device* device) {
+	if(device == NULL) return;
+	device->reset(device);
+}
+
+int _device_read(const struct _device* device) {
+	if(device == NULL) return 0;
+	return device->read(device);
+}
+
+int _device_read_at(const struct _device* device, int index) {
+	if(device == NULL) return 0;
+	return device->read_at(device, index);
+}
+
+int _device_read_array(const struct _device* device, int* data, int length) {
+	if(device == NULL) return 0;
+	return device->read_array(device, data, length);
+}
+
+float _device_read_float(const struct _device* device) {
+	if(device == NULL) return 0.0f;
+	return device->read_float(device);
+}
+
+float _device_read_float_at(const struct _device* device, int index) {
+	if(device == NULL) return 0.0f;
+	return device->read_float_at(device, index);
+}
+
+int _device_read_float_array(const struct _device* device, float* data, int length) {
+	if(device == NULL) return 0;
+	return device->read_float_array(device, data, length);
+}
+
+int _device_write(struct _device* device, int data) {
+	if(device == NULL) return 0;
+	return device->write(device, data);
+}
+
+int _device_write_at(struct _device* device, int index, int data) {
+	if(device == NULL) return 0;
+	return device->write_at(device, index, data);
+}
+
+int _device_write_array(struct _device* device, const int* data, int length) {
+	if(device == NULL) return 0;
+	return device->write_array(device, data, length);
+}
+
+int _device_write_float(struct _device* device, float data) {
+	if(device == NULL) return 0;
+	return device->write_float(device, data);
+}
+
+int _device_write_float_at(struct _device* device, int index, float data) {
+	if(device == NULL) return 0;
+	return device->write_float_at(device, index, data);
+}
+
+int _device_write_float_array(struct _device* device, const float* data, int length) {
+	if(device == NULL) return 0;
+	return device->write_float_array(device, data, length);
+}
+
+int _device_put(struct _device* device, int data) {
+	if(device == NULL) return 0;
+	return device->put(device, data);
+}
+
+int _device_put_at(struct _device* device, int index, int data) {
+	if(device == NULL) return 0;
+	return device->put_at(device, index, data);
+}
+
+int _device_put_array(struct _device* device, const int* data, int length) {
+	if(device == NULL) return 0;
+	return device->put_array(device, data, length);
+}
+
+int _device_put_float(struct _device* device, float data) {
+	if(device == NULL) return 0;
+	return device->put_float(device, data);
+}
+
+int _device_put_float_at(struct _device* device, int index, float data) {
+	if(device == NULL) return 0;
+	return device->put_float_at(device, index, data);
+}
+
+int _device_put_float_array(struct _device* device, const float* data, int length) {
+	if(device == NULL) return 0;
+	return device->put_float_array(device, data, length);
+}
+
+void _device_update_device_state(struct _device* device) {
+	if(device == NULL) return;
+	device->event = device->fired;
+	device->fired = 0;
+}
+
+/*------------------------------
+  UTIL
+------------------------------*/
+
+int _value_to_hex(char* buffer, int index, int value, int bytes);
+int _value_to_hex_1(char* buffer, int index, int value);
+int _value_to_hex_2(char* buffer, int index, int value);
+int _value_to_hex_3(char* buffer, int index, int value);
+int _hex_to_value(const char* str, int start, int end);
+int _hex_to_value_1(const char* str, int start);
+int _hex_to_value_2(const char* str, int start);
+int _hex_to_value_3(const char* str, int start);
+void _hex_to_bytes(const char* str, unsigned char* bytes, int count);
+void _bytes_to_hex(const unsigned char* bytes, char* str, int count);
+
+// packet layouts are tables of fields over the bytes of the hex payload, most significant byte first;
+// the codecs are expanded from them with constant offsets and widths
+#define _PACKET_READ_1(bytes, offset) ((int)(bytes)[offset])
+#define _PACKET_READ_2(bytes, offset) (((int)(bytes)[offset] << 8) | (bytes)[(offset) + 1])
+#define _PACKET_READ_3(bytes, offset) (((int)(bytes)[offset] << 16) | ((int)(bytes)[(offset) + 1] << 8) | (bytes)[(offset) + 2])
+#define _PACKET_OR_1(bytes, offset, value) ((bytes)[offset] |= (unsigned char)(value))
+#define _PACKET_OR_2(bytes, offset, value) ((bytes)[offset] |= (unsigned char)((value) >> 8), (bytes)[(offset) + 1] |= (unsigned char)(value))
+#define _PACKET_OR_3(bytes, offset, value) ((bytes)[offset] |= (unsigned char)((value) >> 16), (bytes)[(offset) + 1] |= (unsigned char)((value) >> 8), (bytes)[(offset) + 2] |= (unsigned char)(value))
+// UNSIGNED, SIGNED (two's complement, extended without a branch) or NEGATIVE (always below zero, sent without the sign)
+#define _PACKET_EXTEND_UNSIGNED(value, width) (value)
+#define _PACKET_EXTEND_SIGNED(value, width) (((value) ^ (1 << ((width) * 8 - 1))) - (1 << ((width) * 8 - 1)))
+#define _PACKET_EXTEND_NEGATIVE(value, width) ((value) - (1 << ((width) * 8)))
+#define _PACKET_DECODE(bytes, offset, width, sign) _PACKET_EXTEND_##sign(_PACKET_READ_##width(bytes, offset), width)
+#define _PACKET_TYPE_UNSIGNED_1 unsigned char
+#define _PACKET_TYPE_UNSIGNED_2 unsigned short
+#define _PACKET_TYPE_UNSIGNED_3 int
+#define _PACKET_TYPE_SIGNED_1 signed char
+#define _PACKET_TYPE_SIGNED_2 short
+#define _PACKET_TYPE_SIGNED_3 int
+#define _PACKET_TYPE_NEGATIVE_1 short
+#define _PACKET_TYPE_NEGATIVE_2 int
+#define _PACKET_TYPE_NEGATIVE_3 int
+
+// '0'-'9', 'a'-'f' and 'A'-'F' to their values, anything else to 0: frames are checked before decoding
+const unsigned char _HEX_VALUES[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0, 0,
+	0, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// the two digits of byte b are at _HEX_BYTES[b * 2]
+const char _HEX_BYTES[] =
+	"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+	"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+	"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+	"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+	"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+	"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+	"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+	"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+int _value_to_hex(char* buffer, int index, int value, int bytes) {
+	int i;
+
+	for(i = bytes - 1; i >= 0; --i) {
+		index = _value_to_hex_1(buffer, index, value >> (i * 8));
+	}
+	return index;
+}
+
+int _value_to_hex_1(char* buffer, int index, int value) {
+	const char* hex = _HEX_BYTES + (value & 0xff) * 2;
+
+	buffer[index] = hex[0];
+	buffer[index + 1] = hex[1];
+	return index + 2;
+}
+
+int _value_to_hex_2(char* buffer, int index, int value) {
+	index = _value_to_hex_1(buffer, index, value >> 8);
+	return _value_to_hex_1(buffer, index, value);
+}
+
+int _value_to_hex_3(char* buffer, int index, int value) {
+	index = _value_to_hex_1(buffer, index, value >> 16);
+	index = _value_to_hex_1(buffer, index, value >> 8);
+	return _value_to_hex_1(buffer, index, value);
+}
+
+int _hex_to_value(const char* str, int start, int end) {
+	const unsigned char* s = (const unsigned char*)str;
+	int result = 0, i;
+
+	for(i = start; i < end; ++i) {
+		result = (result << 4) | _HEX_VALUES[s[i]];
+	}
+	return result;
+}
+
+int _hex_to_value_1(const char* str, int start) {
+	const unsigned char* s = (const unsigned char*)str + start;
+
+	return (_HEX_VALUES[s[0]] << 4) | _HEX_VALUES[s[1]];
+}
+
+int _hex_to_value_2(const char* str, int start) {
+	const unsigned char* s = (const unsigned char*)str + start;
+
+	return (_HEX_VALUES[s[0]] << 12) | (_HEX_VALUES[s[1]] << 8) | (_HEX_VALUES[s[2]] << 4) | _HEX_VALUES[s[3]];
+}
+
+int _hex_to_value_3(const char* str, int start) {
+	return (_hex_to_value_1(str, start) << 16) | _hex_to_value_2(str, start + 2);
+}
+
+void _hex_to_bytes(const char* str, unsigned char* bytes, int count) { // count * 2 digits, checked before
+	const unsigned char* s = (const unsigned char*)str;
+	unsigned long long x, v;
+	int i = 0;
+#ifdef _HEX_SSE2
+	const __m128i low = _mm_set1_epi8(0x0f), one = _mm_set1_epi8(0x01), first = _mm_set1_epi16(0x00ff);
+	__m128i c, d;
+
+	// a digit is its low nibble, plus 9 when bit 6 says it is a letter
+	for(; i + 8 <= count; i += 8) {
+		c = _mm_loadu_si128((const __m128i*)(s + i * 2));
+		d = _mm_and_si128(_mm_srli_epi16(c, 6), one);
+		d = _mm_add_epi8(_mm_and_si128(c, low), _mm_add_epi8(d, _mm_slli_epi16(d, 3)));
+		d = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(d, first), 4), _mm_srli_epi16(d, 8));
+		_mm_storel_epi64((__m128i*)(bytes + i), _mm_packus_epi16(d, d));
+	}
+#endif
+	// the same, 8 digits in a 64-bit word
+	for(; i + 4 <= count; i += 4) {
+		const unsigned char* p = s + i * 2;
+
+		x = (unsigned long long)p[0] | ((unsigned long long)p[1] << 8) | ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24)
+			| ((unsigned long long)p[4] << 32) | ((unsigned long long)p[5] << 40) | ((unsigned long long)p[6] << 48) | ((unsigned long long)p[7] << 56);
+		v = (x >> 6) & 0x0101010101010101ULL;
+		v = (x & 0x0f0f0f0f0f0f0f0fULL) + v * 9;
+		v = ((v & 0x00ff00ff00ff00ffULL) << 4) | ((v >> 8) & 0x00ff00ff00ff00ffULL);
+		bytes[i] = (unsigned char)v;
+		bytes[i + 1] = (unsigned char)(v >> 16);
+		bytes[i + 2] = (unsigned char)(v >> 32);
+		bytes[i + 3] = (unsigned char)(v >> 48);
+	}
+	for(; i < count; ++i) {
+		bytes[i] = (unsigned char)_hex_to_value_1(str, i * 2);
+	}
+}
+
+void _bytes_to_hex(const unsigned char* bytes, char* str, int count) {
+	int i;
+
+	for(i = 0; i < count; ++i) {
+		_value_to_hex_1(str, i * 2, bytes[i]);
+	}
+}
+
+/*------------------------------
+  ROBOT
+------------------------------*/
+
+struct _robot;
+typedef void (*_REQUEST_MOTORING_DATA)(struct _robot* robot);
+typedef void (*_UPDATE_SENSORY_DEVICE_STATE)(struct _robot* robot);
+typedef void (*_UPDATE_MOTORING_DEVICE_STATE)(struct _robot* robot);
+typedef void (*_RESET)(struct _robot* robot);
+typedef void (*_DISPOSE)(struct _robot* robot);
+
+struct _robot {
+	int index;
+	char* name;
+	char* write_buffer;
+	int devices_size;
+	struct _device** devices;
+	struct _connector* connector;
+	int alive;
+	int running;
+	int ready;
+	int checked; // counted by the runner as ready or given up
+	int thread_alive;
+	_THREAD thread_handle;
+	_REQUEST_MOTORING_DATA request_motoring_data;
+	_UPDATE_SENSORY_DEVICE_STATE update_sensory_device_state;
+	_UPDATE_MOTORING_DEVICE_STATE update_motoring_device_state;
+	_RESET reset;
+	_DISPOSE dispose;
+};
+
+void _robot_init(struct _robot* robot, int index, const char* name, int write_buffer_size) {
+	if(robot != NULL) {
+		int len;
+		robot->index = index;
+		if(name == NULL) name = "";
+		len = strlen(name) + 1;
+		robot->name = (char*)malloc(sizeof(char) * len);
+		_STRCPY(robot->name, len, name);
+		robot->write_buffer = (char*)malloc(sizeof(char) * write_buffer_size);
+		robot->alive = 0;
+		robot->running = 0;
+		robot->ready = 0;
+		robot->checked = 0;
+		robot->thread_alive = 0;
+		robot->thread_handle = 0;
+	}
+}
+
+void _robot_dispose(struct _robot* robot) {
+	if(robot != NULL) {
+		struct _device** devices = robot->devices;
+		int size = robot->devices_size, i;
+
+		if(robot->connector != NULL) {
+			_connector_dispose(robot->connector);
+			robot->connector = NULL;
+		}
+		if(robot->name != NULL) {
+			free(robot->name);
+			robot->name = NULL;
+		}
+		if(robot->write_buffer != NULL) {
+			free(robot->write_buffer);
+			robot->write_buffer = NULL;
+		}
+		for(i = 0; i < size; ++i) {
+			_device_dispose(devices[i]);
+			devices[i] = NULL;
+		}
+		free(devices);
+		robot->devices = NULL;
+		robot->devices_size = 0;
+	}
+}
+
+const char* _robot_get_name(struct _robot* robot) {
+	if(robot == NULL) return "";
+	return robot->name;
+}
+
+void _robot_set_name(struct _robot* robot, const char* name) {
+	if(robot != NULL) {
+		int len;
+		if(robot->name != NULL) {
+			free(robot->name);
+		}
+		if(name == NULL) name = "";
+		len = strlen(name) + 1;
+		robot->name = (char*)malloc(sizeof(char) * len);
+		_STRCPY(robot->name, len, name);
+	}
+}
+
+int _robot_get_index(struct _robot* robot) {
+	if(robot == NULL) return 0;
+	return robot->index;
+}
+
+void _robot_reset(struct _robot* robot) {
+	if(robot != NULL) {
+		struct _device** devices = robot->devices;
+		int size = robot->devices_size, i;
+		for(i = 0; i < size; ++i) {
+			_device_reset(devices[i]);
+		}
+	}
+}
+
+void _robot_clear_written(struct _robot* robot) {
+	if(robot != NULL) {
+		struct _device** devices = robot->devices;
+		int size = robot->devices_size, i;
+		for(i = 0; i < size; ++i) {
+			devices[i]->written = 0;
+		}
+	}
+}
+
+struct _device* _robot_find_device(struct _robot* robot, int device_id) {
+	if(robot == NULL) return NULL;
+	if(robot->devices == NULL) return NULL;
+	return robot->devices[device_id & 0xffff];
+}
+
+int _robot_e(struct _robot* robot, int device_id) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_e(device);
+}
+
+int _robot_read(struct _robot* robot, int device_id) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read(device);
+}
+
+int _robot_read_at(struct _robot* robot, int device_id, int index) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read_at(device, index);
+}
+
+int _robot_read_array(struct _robot* robot, int device_id, int* data, int length) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read_array(device, data, length);
+}
+
+float _robot_read_float(struct _robot* robot, int device_id) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read_float(device);
+}
+
+float _robot_read_float_at(struct _robot* robot, int device_id, int index) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read_float_at(device, index);
+}
+
+int _robot_read_float_array(struct _robot* robot, int device_id, float* data, int length) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_read_float_array(device, data, length);
+}
+
+int _robot_write(struct _robot* robot, int device_id, int data) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write(device, data);
+}
+
+int _robot_write_at(struct _robot* robot, int device_id, int index, int data) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write_at(device, index, data);
+}
+
+int _robot_write_array(struct _robot* robot, int device_id, const int* data, int length) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write_array(device, data, length);
+}
+
+int _robot_write_float(struct _robot* robot, int device_id, float data) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write_float(device, data);
+}
+
+int _robot_write_float_at(struct _robot* robot, int device_id, int index, float data) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write_float_at(device, index, data);
+}
+
+int _robot_write_float_array(struct _robot* robot, int device_id, const float* data, int length) {
+	struct _device* device = _robot_find_device(robot, device_id);
+	return _device_write_float_array(device, data, length);
+}
+
+#define _NUM_ROBOT_GROUPS 1
+
+struct _robot_group {
+	int robots_size;
+	int robots_count;
+	struct _robot** robots;
+};
+
+struct _robot_group** _robot_groups = NULL;
+
+void _robot_group_dispose_all(void) {
+	if(_robot_groups != NULL) {
+		struct _robot_group* group;
+		int i;
+		for(i = 0; i < _NUM_ROBOT_GROUPS; ++i) {
+			group = _robot_groups[i];
+			if(group != NULL) {
+				if(group->robots != NULL) {
+					free(group->robots);
+					group->robots = NULL;
+				}
+				free(group);
+				_robot_groups[i] = NULL;
+			}
+		}
+		free(_robot_groups);
+		_robot_groups = NULL;
+	}
+}
+
+struct _robot_group* _robot_group_get(int group_index) {
+	struct _robot_group* group;
+	
+	if(group_index < 0 || group_index >= _NUM_ROBOT_GROUPS) return NULL;
+	if(_robot_groups == NULL) {
+		int i;
+		_robot_groups = (struct _robot_group**)malloc(sizeof(struct _robot_group*) * _NUM_ROBOT_GROUPS);
+		for(i = 0; i < _NUM_ROBOT_GROUPS; ++i) {
+			_robot_groups[i] = NULL;
+		}
+	}
+	group = _robot_groups[group_index];
+	if(group == NULL) {
+		group = (struct _robot_group*)malloc(sizeof(struct _robot_group));
+		group->robots_size = 1;
+		group->robots_count = 0;
+		group->robots = (struct _robot**)malloc(sizeof(struct _robot*));
+		group->robots[0] = NULL;
+		_robot_groups[group_index] = group;
+	}
+	return group;
+}
+
+struct _robot* _robot_group_get_robot(int group_index, int robot_index) {
+	struct _robot_group* group = _robot_group_get(group_index);
+	if(group == NULL) return NULL;
+	if(robot_index < 0 || robot_index >= group->robots_count) return NULL;
+	return group->robots[robot_index];
+}
+
+void _robot_group_add_robot(int group_index, struct _robot* robot) {
+	if(robot != NULL) {
+		struct _robot_group* group = _robot_group_get(group_index);
+		if(group != NULL) {
+			if(group->robots_size <= group->robots_count) {
+				int size = group->robots_size * 2, i;
+				struct _robot** temp = (struct _robot**)malloc(sizeof(struct _robot*) * size);
+				for(i = 0; i < size; ++i) {
+					temp[i] = NULL;
+				}
+				memcpy(temp, group->robots, sizeof(struct _robot*) * group->robots_size);
+				free(group->robots);
+				group->robots = temp;
+				group->robots_size = size;
+			}
+			group->robots[group->robots_count] = robot;
+			group->robots_count ++;
+		}
+	}
+}
+
+void _robot_group_remove_robot(int group_index, struct _robot* robot) {
+	if(robot != NULL) {
+		struct _robot_group* group = _robot_group_get(group_index);
+		if(group == NULL) return;
+		if(robot->index < 0 || robot->index >= group->robots_size) return;
+		group->robots[robot->index] = NULL;
+	}
+}
+
+int _robot_group_count_robots(int group_index) {
+	struct _robot_group* group = _robot_group_get(group_index);
+	if(group == NULL) return 0;
+	return group->robots_count;
+}
+
+const char* _robot_group_get_name(int group_index, int robot_index) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_get_name(robot);
+}
+
+void _robot_group_set_name(int group_index, int robot_index, const char* name) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	_robot_set_name(robot, name);
+}
+
+void _robot_group_reset(int group_index, int robot_index) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	if(robot != NULL) {
+		robot->reset(robot);
+	}
+}
+
+void _robot_group_dispose(int group_index, int robot_index) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	if(robot != NULL) {
+		robot->alive = 0;
+		robot->reset(robot);
+		robot->dispose(robot);
+	}
+}
+
+int _robot_group_e(int group_index, int robot_index, int device_id) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_e(robot, device_id);
+}
+
+int _robot_group_read(int group_index, int robot_index, int device_id) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read(robot, device_id);
+}
+
+int _robot_group_read_at(int group_index, int robot_index, int device_id, int index) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read_at(robot, device_id, index);
+}
+
+int _robot_group_read_array(int group_index, int robot_index, int device_id, int* data, int length) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read_array(robot, device_id, data, length);
+}
+
+float _robot_group_read_float(int group_index, int robot_index, int device_id) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read_float(robot, device_id);
+}
+
+float _robot_group_read_float_at(int group_index, int robot_index, int device_id, int index) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read_float_at(robot, device_id, index);
+}
+
+int _robot_group_read_float_array(int group_index, int robot_index, int device_id, float* data, int length) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_read_float_array(robot, device_id, data, length);
+}
+
+int _robot_group_write(int group_index, int robot_index, int device_id, int data) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write(robot, device_id, data);
+}
+
+int _robot_group_write_at(int group_index, int robot_index, int device_id, int index, int data) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write_at(robot, device_id, index, data);
+}
+
+int _robot_group_write_array(int group_index, int robot_index, int device_id, const int* data, int length) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write_array(robot, device_id, data, length);
+}
+
+int _robot_group_write_float(int group_index, int robot_index, int device_id, float data) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write_float(robot, device_id, data);
+}
+
+int _robot_group_write_float_at(int group_index, int robot_index, int device_id, int index, float data) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write_float_at(robot, device_id, index, data);
+}
+
+int _robot_group_write_float_array(int group_index, int robot_index, int device_id, const float* data, int length) {
+	struct _robot* robot = _robot_group_get_robot(group_index, robot_index);
+	return _robot_write_float_array(robot, device_id, data, length);
+}
+
+/*------------------------------
+  RUNNER
+------------------------------*/
+
+typedef void (*_EXECUTE)(void* arg);
+typedef int (*_EVALUATE)(void* arg);
+
+struct _runner {
+	int started;
+	int connection_required;
+	int connection_checked;
+	int robots_count;
+	int robots_size;
+	struct _robot** robots;
+	_EXECUTE execute;
+	void* execute_arg;
+	_EVALUATE evaluate;
+	void* evaluate_arg;
+	int evaluate_result;
+	int running;
+	int thread_alive;
+	_THREAD thread_handle;
+};
+
+struct _runner* _runner = NULL;
+
+void _runner_create(void);
+void _runner_shutdown(void);
+void _runner_start(void);
+void _runner_register_required(void);
+void _runner_register_checked(void);
+int _runner_is_all_checked(void);
+void _runner_add_robot(struct _robot* robot);
+
+void _runner_create(void) {
+	if(_runner != NULL) return;
+	_runner = (struct _runner*)malloc(sizeof(struct _runner));
+	_runner->started = 0;
+	_runner->connection_required = 0;
+	_runner->connection_checked = 0;
+	_runner->robots_count = 0;
+	_runner->robots_size = 1;
+	_runner->robots = (struct _robot**)malloc(sizeof(struct _robot*));
+	_runner->robots[0] = NULL;
+	_runner->execute = NULL;
+	_runner->execute_arg = NULL;
+	_runner->evaluate = NULL;
+	_runner->evaluate_arg = NULL;
+	_runner->evaluate_result = 0;
+	_runner->running = 0;
+	_runner->thread_alive = 0;
+	_runner->thread_handle = 0;
+}
+
+void _runner_shutdown(void) {
+	if(_runner != NULL) {
+		struct _robot** robots = _runner->robots;
+		int count = _runner->robots_count, i;
+		struct _robot* robot;
+
+		if(robots != NULL) {
+			for(i = 0; i < count; ++i) {
+				robot = robots[i];
+				if(robot != NULL) {
+					robot->alive = 0;
+					robot->reset(robot);
+				}
+			}
+		}
+
+		_runner->running = 0;
+		if(_runner->thread_alive == 1) {
+			_thread_join(_runner->thread_handle, -1);
+		}
+
+		if(robots != NULL) {
+			for(i = 0; i < count; ++i) {
+				robot = robots[i];
+				if(robot != NULL) {
+					robot->dispose(robot);
+					robots[i] = NULL;
+				}
+			}
+			free(robots);
+			_runner->robots = NULL;
+		}
+		free(_runner);
+		_runner = NULL;
+	}
+}
+
+_THREAD_PROC _runner_thread_proc(void* arg) {
+	struct _runner* runner = (struct _runner*)arg;
+	struct _robot** robots;
+	struct _robot* robot;
+	int count, i;
+	unsigned long long target_time;
+
+	if(runner == NULL) return 0;
+	
+	runner->thread_alive = 1;
+	target_time = _clock_get_time();
+	while(runner->running == 1) {
+		if(_clock_get_time() > target_time) {
+			robots = runner->robots;
+			count = runner->robots_count;
+	
+			for(i = 0; i < count; ++i) {
+				robot = robots[i];
+				if(robot != NULL && robot->alive == 1) {
+					robot->update_sensory_device_state(robot);
+				}
+			}
+			
+			if(runner->evaluate != NULL) {
+				runner->evaluate_result = runner->evaluate(runner->evaluate_arg);
+				if(runner->evaluate_result == 1) {
+					runner->evaluate = NULL;
+				}
+			}
+			
+			if(runner->execute != NULL) {
+				runner->execute(runner->execute_arg);
+			}
+			
+			for(i = 0; i < count; ++i) {
+				robot = robots[i];
+				if(robot != NULL && robot->alive == 1) {
+					robot->request_motoring_data(robot);
+				}
+			}
+			for(i = 0; i < count; ++i) {
+				robot = robots[i];
+				if(robot != NULL && robot->alive == 1) {
+					robot->update_motoring_device_state(robot);
+				}
+			}
+			target_time += 20 * _CLOCK_MILLISECOND;
+		}
+		_SLEEP(5);
+	}
+	runner->thread_alive = 0;
+	return 0;
+}
+
+void _runner_signal_handler(int sig) {
+	dispose_all();
+	exit(1);
+}
+
+void _runner_start(void) {
+	if(_runner == NULL) return;
+	if(_runner->started == 0) {
+		_runner->started = 1;
+		_runner->running = 1;
+		signal(SIGINT, _runner_signal_handler);
+		_thread_start(&_runner->thread_handle, _runner_thread_proc, _runner);
+	}
+}
+
+void _runner_register_required(void) {
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	_runner->connection_required ++;
+}
+
+void _runner_register_checked(void) {
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	_runner->connection_checked ++;
+}
+
+int _runner_is_all_checked(void) {
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	return (_runner->connection_checked >= _runner->connection_required) ? 1 : 0;
+}
+
+void _runner_add_robot(struct _robot* robot) {
+	if(robot == NULL) return;
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	if(_runner->robots_size <= _runner->robots_count) {
+		int size = _runner->robots_size * 2, i;
+		struct _robot** temp = (struct _robot**)malloc(sizeof(struct _robot*) * size);
+		for(i = 0; i < size; ++i) {
+			temp[i] = 0;
+		}
+		memcpy(temp, _runner->robots, sizeof(struct _robot*) * _runner->robots_size);
+		free(_runner->robots);
+		_runner->robots = temp;
+		_runner->robots_size = size;
+	}
+	_runner->robots[_runner->robots_count] = robot;
+	_runner->robots_count ++;
+}
+
+void _runner_remove_robot(struct _robot* robot) {
+	struct _robot** robots;
+	int count, i;
+	
+	if(robot == NULL) return;
+	if(_runner == NULL) return;
+	count = _runner->robots_count;
+	robots = _runner->robots;
+	for(i = 0; i < count; ++i) {
+		if(robots[i] == robot) {
+			robots[i] = NULL;
+		}
+	}
+}
+
+/*------------------------------
+  COMMON
+------------------------------*/
+
+void scan(void) {
+	int port_count = 0;
+	char** port_names;
+	
+	printf("Serial ports:\n");
+
+	port_names = _serial_port_get_serial_port_names(NULL, &port_count);
+	if(port_count > 0 && port_names != NULL) {
+		int i;
+		for(i = 0; i < port_count; ++i) {
+			printf("%s\n", port_names[i]);
+			free(port_names[i]);
+		}
+		free(port_names);
+	} else {
+		printf("No available serial port\n");
+	}
+}
+
+void capture(const char* path) {
+	if(_capture_path != NULL) {
+		free(_capture_path);
+		_capture_path = NULL;
+	}
+	if(path != NULL) {
+		int len = strlen(path) + 1;
+		_capture_path = (char*)malloc(sizeof(char) * len);
+		_STRCPY(_capture_path, len, path);
+	}
+}
+
+void set_executable(void (*execute)(void* arg), void* arg) {
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	_runner->execute_arg = arg;
+	_runner->execute = execute;
+}
+
+void wait(int milliseconds) {
+	if(milliseconds > 0) {
+		unsigned long long timeout;
+		
+		timeout = _clock_get_time() + milliseconds * _CLOCK_MILLISECOND;
+		while(1) {
+			if(_clock_get_time() >= timeout) {
+				break;
+			}
+			_SLEEP(1);
+		}
+	}
+}
+
+void wait_until(int (*evaluate)(void* arg), void* arg) {
+	if(_runner == NULL) {
+		_runner_create();
+	}
+	_runner->evaluate_arg = arg;
+	_runner->evaluate_result = 0;
+	_runner->evaluate = evaluate;
+	while(_runner->evaluate_result == 0) {
+		_SLEEP(10);
+	}
+}
+
+void wait_until_ready(void) {
+	while(_runner_is_all_checked() == 0) {
+		_SLEEP(10);
+	}
+}
+
+void hotplug(int mode) {
+	_hotplug_start(mode);
+}
+
+void dispose_all(void) {
+	_runner_shutdown();
+	_robot_group_dispose_all();
+	_hotplug_stop();
+	_writer_stop();
+#ifdef _SERIAL_URING
+	_serial_uring_stop();
+#endif
+}
+
+/*------------------------------
+  HAMSTER
+------------------------------*/
+
+#define _HAMSTER_LEFT_WHEEL_INDEX 0
+#define _HAMSTER_RIGHT_WHEEL_INDEX 1
+#define _HAMSTER_BUZZER_INDEX 2
+#define _HAMSTER_OUTPUT_A_INDEX 3
+#define _HAMSTER_OUTPUT_B_INDEX 4
+#define _HAMSTER_TOPOLOGY_INDEX 5
+#define _HAMSTER_LEFT_LED_INDEX 6
+#define _HAMSTER_RIGHT_LED_INDEX 7
+#define _HAMSTER_NOTE_INDEX 8
+#define _HAMSTER_LINE_TRACER_MODE_INDEX 9
+#define _HAMSTER_LINE_TRACER_SPEED_INDEX 10
+#define _HAMSTER_IO_MODE_A_INDEX 11
+#define _HAMSTER_IO_MODE_B_INDEX 12
+#define _HAMSTER_CONFIG_PROXIMITY_INDEX 13
+#define _HAMSTER_CONFIG_GRAVITY_INDEX 14
+#define _HAMSTER_CONFIG_BAND_WIDTH_INDEX 15
+#define _HAMSTER_SIGNAL_STRENGTH_INDEX 16
+#define _HAMSTER_LEFT_PROXIMITY_INDEX 17
+#define _HAMSTER_RIGHT_PROXIMITY_INDEX 18
+#define _HAMSTER_LEFT_FLOOR_INDEX 19
+#define _HAMSTER_RIGHT_FLOOR_INDEX 20
+#define _HAMSTER_ACCELERATION_INDEX 21
+#define _HAMSTER_LIGHT_INDEX 22
+#define _HAMSTER_TEMPERATURE_INDEX 23
+#define _HAMSTER_INPUT_A_INDEX 24
+#define _HAMSTER_INPUT_B_INDEX 25
+#define _HAMSTER_LINE_TRACER_STATE_INDEX 26
+
+#define _GROUP_HAMSTER 0
+#define _HAMSTER_PAYLOAD_SIZE (_DATA_LENGTH / 2) // bytes
+
+struct _hamster_robot {
+	struct _robot robot;
+	int left_wheel;
+	int right_wheel;
+	float buzzer;
+	int output_a;
+	int output_b;
+	int topology;
+	int left_led;
+	int right_led;
+	int note;
+	int line_tracer_mode;
+	int line_tracer_speed;
+	int io_mode_a;
+	int io_mode_b;
+	int config_proximity;
+	int config_gravity;
+	int config_band_width;
+	int light;
+	int temperature;
+	double bpm;
+	int line_tracer_mode_written;
+	int line_tracer_flag;
+	int line_tracer_state;
+	int line_tracer_event;
+	int board_count;
+	int board_state;
+	unsigned char motoring_bytes[_HAMSTER_PAYLOAD_SIZE]; // the payload as it is in write_buffer
+	int motoring_rendered; // write_buffer holds a whole packet to patch
+	unsigned long long frame_time; // arrival of the last decoded frame, 0 before the first
+	int frame_sequence; // frames decoded so far
+	_MUTEX frame_lock; // frame_time is 64 bits: read from the user's thread
+};
+
+#define _HAMSTER_MOTORING_TYPE 0x0010
+
+// X(value, offset, width, shift, mask): fields sharing a byte are or-ed together
+#define _HAMSTER_MOTORING_FIELDS(X, hamster) \
+	X((hamster)->topology, 0, 1, 0, 0x0f) \
+	X(_HAMSTER_MOTORING_TYPE, 1, 2, 0, 0xffff) \
+	X((hamster)->left_wheel, 3, 1, 0, 0xff) \
+	X((hamster)->right_wheel, 4, 1, 0, 0xff) \
+	X((hamster)->left_led, 5, 1, 0, 0xff) \
+	X((hamster)->right_led, 6, 1, 0, 0xff) \
+	X((int)((hamster)->buzzer * 100), 7, 3, 0, 0xffffff) \
+	X((hamster)->note, 10, 1, 0, 0xff) \
+	X((hamster)->line_tracer_mode, 11, 1, 3, 0x0f) \
+	X((hamster)->line_tracer_speed - 1, 11, 1, 0, 0x07) \
+	X((hamster)->line_tracer_flag, 11, 1, 0, 0x80) \
+	X((hamster)->config_proximity, 12, 1, 0, 0xff) \
+	X((hamster)->config_gravity, 13, 1, 4, 0x0f) \
+	X((hamster)->config_band_width, 13, 1, 0, 0x0f) \
+	X((hamster)->io_mode_a, 14, 1, 4, 0x0f) \
+	X((hamster)->io_mode_b, 14, 1, 0, 0x0f) \
+	X((hamster)->output_a, 15, 1, 0, 0xff) \
+	X((hamster)->output_b, 16, 1, 0, 0xff)
+
+// X(name, offset, width, sign)
+#define _HAMSTER_SENSORY_FIELDS(X) \
+	X(signal_strength, 3, 1, NEGATIVE) \
+	X(left_proximity, 4, 1, UNSIGNED) \
+	X(right_proximity, 5, 1, UNSIGNED) \
+	X(left_floor, 6, 1, UNSIGNED) \
+	X(right_floor, 7, 1, UNSIGNED) \
+	X(acceleration_x, 8, 2, SIGNED) \
+	X(acceleration_y, 10, 2, SIGNED) \
+	X(acceleration_z, 12, 2, SIGNED) \
+	X(light_flag, 14, 1, UNSIGNED) /* 0: light follows, otherwise temperature */ \
+	X(light, 15, 2, UNSIGNED) \
+	X(temperature, 15, 1, SIGNED) /* half degrees from 24 */ \
+	X(input_a, 17, 1, UNSIGNED) \
+	X(input_b, 18, 1, UNSIGNED) \
+	X(line_tracer_state, 19, 1, UNSIGNED)
+
+#define _HAMSTER_SENSORY_MEMBER(name, offset, width, sign) _PACKET_TYPE_##sign##_##width name;
+
+struct _hamster_sensory { // the payload of one sensory packet
+	_HAMSTER_SENSORY_FIELDS(_HAMSTER_SENSORY_MEMBER)
+};
+
+int _hamster_parse_identity(struct _connector* connector, const char* reply, int length) {
+	// FF,Hamster,04,<version>,<address>: the fields are walked where they are
+	const char* fields[5];
+	int lengths[5];
+	const char* end = reply + length;
+	const char* p = reply;
+	char address[_ADDRESS_LENGTH + 1];
+	int count = 0;
+
+	while(count < 5) {
+		fields[count] = p;
+		while(p < end && *p != connector->delimiter && (*p != ',' || count == 4)) ++ p;
+		lengths[count] = (int)(p - fields[count]);
+		++ count;
+		if(p >= end || *p != ',') break;
+		++ p;
+	}
+	if(count == 5 && lengths[4] >= _ADDRESS_LENGTH && _connector_match_field(fields[1], lengths[1], "Hamster") == 1
+		&& _connector_match_field(fields[2], lengths[2], "04") == 1) {
+		memcpy(address, fields[4], _ADDRESS_LENGTH);
+		address[_ADDRESS_LENGTH] = '\0';
+		_connector_set_address(connector, address);
+		return _CONNECTION_RESULT_FOUND;
+	}
+	return _CONNECTION_RESULT_NOT_AVAILABLE;
+}
+
+void _hamster_request_motoring_data(struct _robot* robot) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	struct _device** devices = robot->devices;
+	
+	hamster->left_wheel = _device_read(devices[_HAMSTER_LEFT_WHEEL_INDEX]);
+	hamster->right_wheel = _device_read(devices[_HAMSTER_RIGHT_WHEEL_INDEX]);
+	hamster->buzzer = _device_read_float(devices[_HAMSTER_BUZZER_INDEX]);
+	hamster->output_a = _device_read(devices[_HAMSTER_OUTPUT_A_INDEX]);
+	hamster->output_b = _device_read(devices[_HAMSTER_OUTPUT_B_INDEX]);
+	if(devices[_HAMSTER_TOPOLOGY_INDEX]->written == 1) {
+		hamster->topology = _device_read(devices[_HAMSTER_TOPOLOGY_INDEX]);
+	}
+	if(devices[_HAMSTER_LEFT_LED_INDEX]->written == 1) {
+		hamster->left_led = _device_read(devices[_HAMSTER_LEFT_LED_INDEX]);
+	}
+	if(devices[_HAMSTER_RIGHT_LED_INDEX]->written == 1) {
+		hamster->right_led = _device_read(devices[_HAMSTER_RIGHT_LED_INDEX]);
+	}
+	if(devices[_HAMSTER_NOTE_INDEX]->written == 1) {
+		hamster->note = _device_read(devices[_HAMSTER_NOTE_INDEX]);
+	}
+	if(devices[_HAMSTER_LINE_TRACER_MODE_INDEX]->written == 1) {
+		hamster->line_tracer_mode = _device_read(devices[_HAMSTER_LINE_TRACER_MODE_INDEX]);
+		hamster->line_tracer_mode_written = 1;
+	}
+	if(devices[_HAMSTER_LINE_TRACER_SPEED_INDEX]->written == 1) {
+		hamster->line_tracer_speed = _device_read(devices[_HAMSTER_LINE_TRACER_SPEED_INDEX]);
+	}
+	if(devices[_HAMSTER_IO_MODE_A_INDEX]->written == 1) {
+		hamster->io_mode_a = _device_read(devices[_HAMSTER_IO_MODE_A_INDEX]);
+	}
+	if(devices[_HAMSTER_IO_MODE_B_INDEX]->written == 1) {
+		hamster->io_mode_b = _device_read(devices[_HAMSTER_IO_MODE_B_INDEX]);
+	}
+	if(devices[_HAMSTER_CONFIG_PROXIMITY_INDEX]->written == 1) {
+		hamster->config_proximity = _device_read(devices[_HAMSTER_CONFIG_PROXIMITY_INDEX]);
+	}
+	if(devices[_HAMSTER_CONFIG_GRAVITY_INDEX]->written == 1) {
+		hamster->config_gravity = _device_read(devices[_HAMSTER_CONFIG_GRAVITY_INDEX]);
+	}
+	if(devices[_HAMSTER_CONFIG_BAND_WIDTH_INDEX]->written == 1) {
+		hamster->config_band_width = _device_read(devices[_HAMSTER_CONFIG_BAND_WIDTH_INDEX]);
+	}
+	_robot_clear_written(robot);
+}
+
+void _hamster_encode_motoring(const struct _hamster_robot* hamster, unsigned char* bytes) {
+	memset(bytes, 0, _HAMSTER_PAYLOAD_SIZE);
+#define _HAMSTER_MOTORING_PUT(value, offset, width, shift, mask) _PACKET_OR_##width(bytes, offset, ((value) & (mask)) << (shift));
+	_HAMSTER_MOTORING_FIELDS(_HAMSTER_MOTORING_PUT, hamster)
+#undef _HAMSTER_MOTORING_PUT
+}
+
+void _hamster_encode_motoring_packet(struct _robot* robot) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	char* buffer = robot->write_buffer;
+	unsigned char bytes[_HAMSTER_PAYLOAD_SIZE];
+	const char* address;
+	int i;
+
+	if(hamster->line_tracer_mode_written == 1) {
+		if(hamster->line_tracer_mode > 0) {
+			hamster->line_tracer_flag ^= 0x80;
+			hamster->line_tracer_event = 1;
+		}
+		hamster->line_tracer_mode_written = 0;
+	}
+	_hamster_encode_motoring(hamster, bytes);
+	if(hamster->motoring_rendered == 0) {
+		_bytes_to_hex(bytes, buffer, _HAMSTER_PAYLOAD_SIZE);
+		buffer[_DATA_LENGTH] = '-';
+		memset(buffer + _DATA_LENGTH + 1, '0', _ADDRESS_LENGTH);
+		buffer[_MOTORING_PACKET_LENGTH - 1] = '\r';
+		memcpy(hamster->motoring_bytes, bytes, _HAMSTER_PAYLOAD_SIZE);
+		hamster->motoring_rendered = 1;
+	} else {
+		// only what changed since the last packet: moving the wheels touches 4 characters
+		for(i = 0; i < _HAMSTER_PAYLOAD_SIZE; ++i) {
+			if(bytes[i] != hamster->motoring_bytes[i]) {
+				hamster->motoring_bytes[i] = bytes[i];
+				_value_to_hex_1(buffer, i * 2, bytes[i]);
+			}
+		}
+	}
+	address = _connector_get_address(robot->connector);
+	if(memcmp(buffer + _DATA_LENGTH + 1, address, _ADDRESS_LENGTH) != 0) { // once per handshake
+		memcpy(buffer + _DATA_LENGTH + 1, address, _ADDRESS_LENGTH);
+	}
+	
+	_connector_write(robot->connector, buffer, _MOTORING_PACKET_LENGTH);
+}
+
+void _hamster_decode_sensory(const char* packet, struct _hamster_sensory* sensory) {
+	unsigned char bytes[_HAMSTER_PAYLOAD_SIZE];
+
+	_hex_to_bytes(packet, bytes, _HAMSTER_PAYLOAD_SIZE);
+#define _HAMSTER_SENSORY_GET(name, offset, width, sign) sensory->name = (_PACKET_TYPE_##sign##_##width)_PACKET_DECODE(bytes, offset, width, sign);
+	_HAMSTER_SENSORY_FIELDS(_HAMSTER_SENSORY_GET)
+#undef _HAMSTER_SENSORY_GET
+}
+
+int _hamster_decode_sensories(const char* const* packets, struct _hamster_sensory* sensories, int count) { // count packets, of one robot or many
+	int i;
+
+	for(i = 0; i < count; ++i) {
+		_hamster_decode_sensory(packets[i], &sensories[i]);
+	}
+	return count;
+}
+
+void _hamster_put_sensory(struct _robot* robot, const struct _hamster_sensory* sensory) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	struct _device** devices = robot->devices;
+	int value;
+	
+	_device_put(devices[_HAMSTER_SIGNAL_STRENGTH_INDEX], sensory->signal_strength);
+	_device_put(devices[_HAMSTER_LEFT_PROXIMITY_INDEX], sensory->left_proximity);
+	_device_put(devices[_HAMSTER_RIGHT_PROXIMITY_INDEX], sensory->right_proximity);
+	_device_put(devices[_HAMSTER_LEFT_FLOOR_INDEX], sensory->left_floor);
+	_device_put(devices[_HAMSTER_RIGHT_FLOOR_INDEX], sensory->right_floor);
+	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 0, sensory->acceleration_x);
+	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 1, sensory->acceleration_y);
+	_device_put_at(devices[_HAMSTER_ACCELERATION_INDEX], 2, sensory->acceleration_z);
+	if(sensory->light_flag == 0) {
+		hamster->light = sensory->light;
+	} else {
+		hamster->temperature = (int)(sensory->temperature / 2.0f + 24);
+	}
+	_device_put(devices[_HAMSTER_LIGHT_INDEX], hamster->light);
+	_device_put(devices[_HAMSTER_TEMPERATURE_INDEX], hamster->temperature);
+	_device_put(devices[_HAMSTER_INPUT_A_INDEX], sensory->input_a);
+	_device_put(devices[_HAMSTER_INPUT_B_INDEX], sensory->input_b);
+	value = sensory->line_tracer_state;
+	if((value & 0x40) != 0) {
+		if(hamster->line_tracer_event == 1) {
+			if(value != 0x40) {
+				hamster->line_tracer_event = 2;
+			}
+		}
+		if(hamster->line_tracer_event == 2) {
+			if(value != hamster->line_tracer_state) {
+				hamster->line_tracer_state = value;
+				_device_put(devices[_HAMSTER_LINE_TRACER_STATE_INDEX], value);
+				if(value == 0x40) {
+					hamster->line_tracer_event = 0;
+				}
+			}
+		}
+	}
+}
+
+void _hamster_stop_effectors(struct _robot* robot) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	struct _device** devices = robot->devices;
+	
+	_device_reset(devices[_HAMSTER_LEFT_WHEEL_INDEX]);
+	_device_reset(devices[_HAMSTER_RIGHT_WHEEL_INDEX]);
+	_device_reset(devices[_HAMSTER_BUZZER_INDEX]);
+	_device_reset(devices[_HAMSTER_OUTPUT_A_INDEX]);
+	_device_reset(devices[_HAMSTER_OUTPUT_B_INDEX]);
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	hamster->left_wheel = 0;
+	hamster->right_wheel = 0;
+	hamster->buzzer = 0;
+	hamster->output_a = 0;
+	hamster->output_b = 0;
+	hamster->line_tracer_mode = 0;
+}
+
+int _hamster_receive(struct _robot* robot) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	struct _connector* connector = robot->connector;
+	
+	if(connector != NULL) {
+		if(_connector_read(connector) != 0) {
+			const char* packets[_CONNECTOR_MAX_FRAMES];
+			struct _hamster_sensory sensories[_CONNECTOR_MAX_FRAMES];
+			unsigned long long frame_time = 0;
+			int count = 0, i;
+
+			for(i = 0; i < connector->frames_count; ++i) {
+				if(connector->frames[i].data != NULL) { // not rejected by the connector
+					packets[count++] = connector->frames[i].data;
+					frame_time = connector->frames[i].time;
+				}
+			}
+			_hamster_decode_sensories(packets, sensories, count);
+			for(i = 0; i < count; ++i) {
+				_hamster_put_sensory(robot, &sensories[i]);
+			}
+			// stamped after the values are put
+			_MUTEX_LOCK(&hamster->frame_lock);
+			hamster->frame_time = frame_time;
+			hamster->frame_sequence += count;
+			_MUTEX_UNLOCK(&hamster->frame_lock);
+			if(robot->ready == 0) {
+				robot->ready = 1;
+				if(robot->checked == 0) {
+					robot->checked = 1;
+					_runner_register_checked();
+				}
+			}
+			_connector_release(connector);
+			return 1;
+		}
+		if(robot->ready == 1 && connector->connected == 0) { // the link is gone: don't drive on when it comes back
+			robot->ready = 0;
+			_hamster_stop_effectors(robot);
+		}
+	}
+	return 0;
+}
+
+void _hamster_send(struct _robot* robot) {
+	struct _connector* connector = robot->connector;
+	
+	if(connector != NULL) {
+		_hamster_encode_motoring_packet(robot);
+	}
+}
+
+void _hamster_update_sensory_device_state(struct _robot* robot) {
+	struct _device** devices = robot->devices;
+	int i;
+
+	for(i = _HAMSTER_SIGNAL_STRENGTH_INDEX; i <= _HAMSTER_LINE_TRACER_STATE_INDEX; ++i) {
+		_device_update_device_state(devices[i]);
+	}
+}
+
+void _hamster_update_motoring_device_state(struct _robot* robot) {
+	struct _device** devices = robot->devices;
+	int i;
+
+	for(i = _HAMSTER_LEFT_WHEEL_INDEX; i <= _HAMSTER_CONFIG_BAND_WIDTH_INDEX; ++i) {
+		_device_update_device_state(devices[i]);
+	}
+}
+
+void _hamster_reset(struct _robot* robot) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return;
+	_robot_reset(robot);
+	
+	hamster->left_wheel = 0;
+	hamster->right_wheel = 0;
+	hamster->buzzer = 0;
+	hamster->output_a = 0;
+	hamster->output_b = 0;
+	hamster->topology = 0;
+	hamster->left_led = 0;
+	hamster->right_led = 0;
+	hamster->note = 0;
+	hamster->line_tracer_mode = 0;
+	hamster->line_tracer_speed = 5;
+	hamster->io_mode_a = 0;
+	hamster->io_mode_b = 0;
+	hamster->config_proximity = 2;
+	hamster->config_gravity = 0;
+	hamster->config_band_width = 3;
+	
+	hamster->light = 0;
+	hamster->temperature = 0;
+	hamster->line_tracer_mode_written = 0;
+	hamster->line_tracer_flag = 0;
+	hamster->line_tracer_state = 0;
+	hamster->line_tracer_event = 0;
+}
+
+void _hamster_dispose(struct _robot* robot) {
+	_robot_group_remove_robot(_GROUP_HAMSTER, robot);
+	_runner_remove_robot(robot);
+
+	robot->running = 0;
+	if(robot->thread_alive == 1) {
+		// no timeout: the robot and its connector are freed below. The thread leaves its loop within
+		// a few ticks because reopening a port no longer blocks it for a whole handshake
+		_thread_join(robot->thread_handle, -1);
+	}
+	_SLEEP(100);
+	_robot_dispose(robot);
+	_MUTEX_DESTROY(&((struct _hamster_robot*)robot)->frame_lock);
+	free((struct _hamster_robot*)robot);
+}
+
+_THREAD_PROC _hamster_thread_proc(void* arg) {
+	struct _robot* robot = (struct _robot*)arg;
+	int shutdown = 0, shutdown_count = 0;
+	
+	if(robot == NULL) return 0;
+
+	robot->thread_alive = 1;
+	while(1) {
+		_connector_check_hotplug(robot->connector);
+		_connector_reconnect(robot->connector);
+		_connector_wait(robot->connector, _WAIT_TIMEOUT);
+		if(_hamster_receive(robot) == 1) {
+			_hamster_send(robot);
+			if(shutdown == 1) {
+				break;
+			}
+		}
+		if(shutdown == 1) {
+			if(++shutdown_count > 5) {
+				break;
+			}
+		}
+		if(robot->running == 0) {
+			shutdown = 1;
+		}
+	}
+	robot->thread_alive = 0;
+	return 0;
+}
+
+struct _hamster_robot* _hamster_create(const char* port_name) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)malloc(sizeof(struct _hamster_robot));
+	struct _robot* robot = (struct _robot*)hamster;
+	struct _device** devices;
+	struct _connector* connector;
+	
+	_robot_init(robot, _robot_group_count_robots(_GROUP_HAMSTER), "Hamster", 55);
+	
+	hamster->left_wheel = 0;
+	hamster->right_wheel = 0;
+	hamster->buzzer = 0;
+	hamster->output_a = 0;
+	hamster->output_b = 0;
+	hamster->topology = 0;
+	hamster->left_led = 0;
+	hamster->right_led = 0;
+	hamster->note = 0;
+	hamster->line_tracer_mode = 0;
+	hamster->line_tracer_speed = 5;
+	hamster->io_mode_a = 0;
+	hamster->io_mode_b = 0;
+	hamster->config_proximity = 2;
+	hamster->config_gravity = 0;
+	hamster->config_band_width = 3;
+	
+	hamster->light = 0;
+	hamster->temperature = 0;
+	hamster->bpm = 60;
+	hamster->line_tracer_mode_written = 0;
+	hamster->line_tracer_flag = 0;
+	hamster->line_tracer_state = 0;
+	hamster->line_tracer_event = 0;
+	hamster->board_count = 0;
+	hamster->board_state = 0;
+	hamster->motoring_rendered = 0;
+	hamster->frame_time = 0;
+	hamster->frame_sequence = 0;
+	_MUTEX_INIT(&hamster->frame_lock);
+	
+	robot->request_motoring_data = _hamster_request_motoring_data;
+	robot->update_sensory_device_state = _hamster_update_sensory_device_state;
+	robot->update_motoring_device_state = _hamster_update_motoring_device_state;
+	robot->reset = _hamster_reset;
+	robot->dispose = _hamster_dispose;
+	
+	robot->devices_size = 27;
+	devices = (struct _device**)malloc(sizeof(struct _device*) * 27);
+	devices[0] = _device_create(HAMSTER_LEFT_WHEEL, "LeftWheel", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, -100, 100, 0);
+	devices[1] = _device_create(HAMSTER_RIGHT_WHEEL, "RightWheel", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, -100, 100, 0);
+	devices[2] = _device_create(HAMSTER_BUZZER, "Buzzer", DEVICE_TYPE_EFFECTOR, DATA_TYPE_FLOAT, 1, 0, 167772.15f, 0);
+	devices[3] = _device_create(HAMSTER_OUTPUT_A, "OutputA", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[4] = _device_create(HAMSTER_OUTPUT_B, "OutputB", DEVICE_TYPE_EFFECTOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[5] = _device_create(HAMSTER_TOPOLOGY, "Topology", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
+	devices[6] = _device_create(HAMSTER_LEFT_LED, "LeftLed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 7, 0);
+	devices[7] = _device_create(HAMSTER_RIGHT_LED, "RightLed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 7, 0);
+	devices[8] = _device_create(HAMSTER_NOTE, "Note", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 88, 0);
+	devices[9] = _device_create(HAMSTER_LINE_TRACER_MODE, "LineTracerMode", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
+	devices[10] = _device_create(HAMSTER_LINE_TRACER_SPEED, "LineTracerSpeed", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 8, 5);
+	devices[11] = _device_create(HAMSTER_IO_MODE_A, "IoModeA", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
+	devices[12] = _device_create(HAMSTER_IO_MODE_B, "IoModeB", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 15, 0);
+	devices[13] = _device_create(HAMSTER_CONFIG_PROXIMITY, "ConfigProximity", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 7, 2);
+	devices[14] = _device_create(HAMSTER_CONFIG_GRAVITY, "ConfigGravity", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 0, 3, 0);
+	devices[15] = _device_create(HAMSTER_CONFIG_BAND_WIDTH, "ConfigBandWidth", DEVICE_TYPE_COMMAND, DATA_TYPE_INTEGER, 1, 1, 8, 3);
+	devices[16] = _device_create(HAMSTER_SIGNAL_STRENGTH, "SignalStrength", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, -128, 0, 0);
+	devices[17] = _device_create(HAMSTER_LEFT_PROXIMITY, "LeftProximity", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[18] = _device_create(HAMSTER_RIGHT_PROXIMITY, "RightProximity", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[19] = _device_create(HAMSTER_LEFT_FLOOR, "LeftFloor", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[20] = _device_create(HAMSTER_RIGHT_FLOOR, "RightFloor", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[21] = _device_create(HAMSTER_ACCELERATION, "Acceleration", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 3, -32768, 32767, 0);
+	devices[22] = _device_create(HAMSTER_LIGHT, "Light", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 65535, 0);
+	devices[23] = _device_create(HAMSTER_TEMPERATURE, "Temperature", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, -40, 88, 0);
+	devices[24] = _device_create(HAMSTER_INPUT_A, "inputA", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[25] = _device_create(HAMSTER_INPUT_B, "inputB", DEVICE_TYPE_SENSOR, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	devices[26] = _device_create(HAMSTER_LINE_TRACER_STATE, "LineTracerState", DEVICE_TYPE_EVENT, DATA_TYPE_INTEGER, 1, 0, 255, 0);
+	robot->devices = devices;
+	robot->connector = NULL;
+	robot->alive = 1;
+
+	_robot_group_add_robot(_GROUP_HAMSTER, robot);
+	_runner_add_robot(robot);
+	_runner_start();
+	
+	_runner_register_required();
+	robot->running = 1;
+	_thread_start(&robot->thread_handle, _hamster_thread_proc, robot);
+
+	connector = _connector_create("Hamster", robot->index, _VALID_PACKET_LENGTH, _CR);
+	robot->connector = connector;
+	if(connector != NULL) {
+		int result;
+		connector->identity_request = "FF\r";
+		connector->parse_identity = _hamster_parse_identity;
+		result = _connector_open(connector, port_name, _SERIAL_BAUDRATE_115200, _SERIAL_FLOWCONTROL_RTSCTS_IN | _SERIAL_FLOWCONTROL_RTSCTS_OUT);
+		if(result == _CONNECTION_RESULT_FOUND) {
+			while(robot->ready == 0 && robot->running == 1) {
+				_SLEEP(10);
+			}
+		} else if(result == _CONNECTION_RESULT_NOT_AVAILABLE) {
+			robot->checked = 1; // a bridge plugged in later must not count it twice
+			_runner_register_checked();
+		}
+	}
+	return hamster;
+}
+
+const char* _hamster_get_id(void) {
+	return HAMSTER_ID;
+}
+
+void _hamster_wheels(int hamster_index, double left_speed, double right_speed) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)left_speed);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)right_speed);
+}
+
+void _hamster_left_wheel(int hamster_index, double speed) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)speed);
+}
+
+void _hamster_right_wheel(int hamster_index, double speed) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)speed);
+}
+
+void _hamster_stop(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
+}
+
+int _hamster_line_tracer_mode_callback(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 1;
+	return _robot_e(robot, HAMSTER_LINE_TRACER_STATE) && _robot_read(robot, HAMSTER_LINE_TRACER_STATE) == 0x40;
+}
+
+void _hamster_line_tracer_mode(int hamster_index, int mode, int (*callback)(void* arg)) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, mode);
+	
+	switch(mode) {
+		case HAMSTER_LINE_TRACER_MODE_BLACK_MOVE_FORWARD:
+		case HAMSTER_LINE_TRACER_MODE_BLACK_TURN_LEFT:
+		case HAMSTER_LINE_TRACER_MODE_BLACK_TURN_RIGHT:
+		case HAMSTER_LINE_TRACER_MODE_BLACK_UTURN:
+		case HAMSTER_LINE_TRACER_MODE_WHITE_MOVE_FORWARD:
+		case HAMSTER_LINE_TRACER_MODE_WHITE_TURN_LEFT:
+		case HAMSTER_LINE_TRACER_MODE_WHITE_TURN_RIGHT:
+		case HAMSTER_LINE_TRACER_MODE_WHITE_UTURN: {
+			wait_until(callback, NULL);
+			break;
+		}
+	}
+}
+
+void _hamster_line_tracer_speed(int hamster_index, double speed) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LINE_TRACER_SPEED, (int)speed);
+}
+
+int _hamster_board_forward_callback(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return 1;
+	switch(hamster->board_state) {
+		case 1: {
+			if(hamster->board_count < 2) {
+				int left_floor = _robot_read(robot, HAMSTER_LEFT_FLOOR);
+				int right_floor = _robot_read(robot, HAMSTER_RIGHT_FLOOR);
+				int diff = left_floor - right_floor;
+				if(left_floor < 50 && right_floor < 50) {
+					hamster->board_count ++;
+				} else {
+					hamster->board_count = 0;
+				}
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(45 + diff * 0.25f));
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(45 - diff * 0.25f));
+			} else {
+				hamster->board_count = 0;
+				hamster->board_state = 2;
+			}
+			break;
+		}
+		case 2: {
+			if(hamster->board_count < 10) {
+				int diff = _robot_read(robot, HAMSTER_LEFT_FLOOR) - _robot_read(robot, HAMSTER_RIGHT_FLOOR);
+				hamster->board_count ++;
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(45 + diff * 0.25f));
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(45 - diff * 0.25f));
+			} else {
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
+				return 1;
+			}
+			break;
+		}
+	}
+	return 0;
+}
+
+void _hamster_board_forward(int hamster_index, int (*callback)(void* arg)) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return;
+	hamster->board_count = 0;
+	hamster->board_state = 1;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, 45);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 45);
+	wait_until(callback, NULL);
+}
+
+int _hamster_board_left_callback(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return 1;
+	switch(hamster->board_state) {
+		case 1: {
+			if(hamster->board_count < 2) {
+				if(_robot_read(robot, HAMSTER_LEFT_FLOOR) > 50) {
+					hamster->board_count ++;
+				}
+			} else {
+				hamster->board_count = 0;
+				hamster->board_state = 2;
+			}
+			break;
+		}
+		case 2: {
+			if(_robot_read(robot, HAMSTER_LEFT_FLOOR) < 20) {
+				hamster->board_state = 3;
+			}
+			break;
+		}
+		case 3: {
+			if(hamster->board_count < 2) {
+				if(_robot_read(robot, HAMSTER_LEFT_FLOOR) < 20) {
+					hamster->board_count ++;
+				}
+			} else {
+				hamster->board_count = 0;
+				hamster->board_state = 4;
+			}
+			break;
+		}
+		case 4: {
+			if(_robot_read(robot, HAMSTER_LEFT_FLOOR) > 50) {
+				hamster->board_state = 5;
+			}
+			break;
+		}
+		case 5: {
+			int diff = _robot_read(robot, HAMSTER_LEFT_FLOOR) - _robot_read(robot, HAMSTER_RIGHT_FLOOR);
+			if(diff > -15) {
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
+				return 1;
+			} else {
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, (int)(diff * 0.5f));
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, -(int)(diff * 0.5f));
+			}
+			break;
+		}
+	}
+	return 0;
+}
+
+void _hamster_board_left(int hamster_index, int (*callback)(void* arg)) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return;
+	hamster->board_count = 0;
+	hamster->board_state = 1;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, -45);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, 45);
+	wait_until(callback, NULL);
+}
+
+int _hamster_board_right_callback(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return 1;
+	switch(hamster->board_state) {
+		case 1: {
+			if(hamster->board_count < 2) {
+				if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) > 50) {
+					hamster->board_count ++;
+				}
+			} else {
+				hamster->board_count = 0;
+				hamster->board_state = 2;
+			}
+			break;
+		}
+		case 2: {
+			if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) < 20) {
+				hamster->board_state = 3;
+			}
+			break;
+		}
+		case 3: {
+			if(hamster->board_count < 2) {
+				if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) < 20) {
+					hamster->board_count ++;
+				}
+			} else {
+				hamster->board_count = 0;
+				hamster->board_state = 4;
+			}
+			break;
+		}
+		case 4: {
+			if(_robot_read(robot, HAMSTER_RIGHT_FLOOR) > 50) {
+				hamster->board_state = 5;
+			}
+			break;
+		}
+		case 5: {
+			int diff = _robot_read(robot, HAMSTER_RIGHT_FLOOR) - _robot_read(robot, HAMSTER_LEFT_FLOOR);
+			if(diff > -15) {
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, 0);
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, 0);
+				return 1;
+			} else {
+				_robot_write(robot, HAMSTER_LEFT_WHEEL, -(int)(diff * 0.5f));
+				_robot_write(robot, HAMSTER_RIGHT_WHEEL, (int)(diff * 0.5f));
+			}
+			break;
+		}
+	}
+	return 0;
+}
+
+void _hamster_board_right(int hamster_index, int (*callback)(void* arg)) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return;
+	hamster->board_count = 0;
+	hamster->board_state = 1;
+	_robot_write(robot, HAMSTER_LINE_TRACER_MODE, HAMSTER_LINE_TRACER_MODE_OFF);
+	_robot_write(robot, HAMSTER_LEFT_WHEEL, 45);
+	_robot_write(robot, HAMSTER_RIGHT_WHEEL, -45);
+	wait_until(callback, NULL);
+}
+
+void _hamster_leds(int hamster_index, int left_color, int right_color) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LEFT_LED, left_color);
+	_robot_write(robot, HAMSTER_RIGHT_LED, right_color);
+}
+
+void _hamster_left_led(int hamster_index, int color) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_LEFT_LED, color);
+}
+
+void _hamster_right_led(int hamster_index, int color) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_RIGHT_LED, color);
+}
+
+void _hamster_beep(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
+	_robot_write(robot, HAMSTER_BUZZER, 440);
+	wait(200);
+	_robot_write(robot, HAMSTER_BUZZER, 0);
+}
+
+void _hamster_buzzer(int hamster_index, double hz) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
+	_robot_write_float(robot, HAMSTER_BUZZER, (float)hz);
+}
+
+void _hamster_tempo(int hamster_index, double bpm) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)_robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(hamster == NULL) return;
+	if(bpm > 0) {
+		hamster->bpm = bpm;
+	}
+}
+
+void _hamster_pitch(int hamster_index, double pitch) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+
+	if(hamster == NULL) return;
+	if(pitch < 0) return;
+	_robot_write(robot, HAMSTER_BUZZER, 0);
+	_robot_write(robot, HAMSTER_NOTE, (int)pitch);
+}
+
+void _hamster_note(int hamster_index, double pitch, double beats) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	struct _hamster_robot* hamster = (struct _hamster_robot*)robot;
+	
+	if(hamster == NULL) return;
+	if(beats > 0) {
+		double bpm = hamster->bpm;
+		if(bpm > 0) {
+			int _pitch = (int)pitch;
+			if(_pitch == 0) {
+				_robot_write(robot, HAMSTER_BUZZER, 0);
+				_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
+				wait((int)(beats * 60 * 1000 / bpm));
+			} else if(_pitch > 0) {
+				int timeout = (int)(beats * 60 * 1000 / bpm);
+				int tail = 0;
+				if(timeout > 100) {
+					tail = 100;
+				}
+				_robot_write(robot, HAMSTER_BUZZER, 0);
+				_robot_write(robot, HAMSTER_NOTE, _pitch);
+				wait(timeout - tail);
+				_robot_write(robot, HAMSTER_NOTE, HAMSTER_NOTE_OFF);
+				if(tail > 0) {
+					wait(tail);
+				}
+			}
+		}
+	}
+}
+
+void _hamster_io_mode_a(int hamster_index, int mode) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_IO_MODE_A, mode);
+}
+
+void _hamster_io_mode_b(int hamster_index, int mode) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_IO_MODE_B, mode);
+}
+
+void _hamster_output_a(int hamster_index, double value) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_OUTPUT_A, (int)value);
+}
+
+void _hamster_output_b(int hamster_index, double value) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return;
+	_robot_write(robot, HAMSTER_OUTPUT_B, (int)value);
+}
+
+void _hamster_receive_mode(int hamster_index, int mode) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL || robot->connector == NULL) return;
+	if(mode == HAMSTER_RECEIVE_LATEST) {
+		robot->connector->receive_mode = _CONNECTOR_RECEIVE_LATEST;
+	} else {
+		robot->connector->receive_mode = _CONNECTOR_RECEIVE_ALL;
+	}
+}
+
+int _hamster_discarded_frames(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL || robot->connector == NULL) return 0;
+	return robot->connector->discarded_frames;
+}
+
+void _hamster_connection_timeout(int hamster_index, int milliseconds) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL || robot->connector == NULL) return;
+	if(milliseconds > 0) {
+		robot->connector->loss_timeout = milliseconds;
+	}
+}
+
+int _hamster_rejected_frames(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL || robot->connector == NULL) return 0;
+	return robot->connector->rejected_frames;
+}
+
+unsigned long long _hamster_get_frame_time(struct _hamster_robot* hamster) {
+	unsigned long long frame_time;
+	
+	_MUTEX_LOCK(&hamster->frame_lock);
+	frame_time = hamster->frame_time;
+	_MUTEX_UNLOCK(&hamster->frame_lock);
+	return frame_time;
+}
+
+int _hamster_frame_sequence(int hamster_index) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)_robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	int frame_sequence;
+	
+	if(hamster == NULL) return 0;
+	_MUTEX_LOCK(&hamster->frame_lock);
+	frame_sequence = hamster->frame_sequence;
+	_MUTEX_UNLOCK(&hamster->frame_lock);
+	return frame_sequence;
+}
+
+double _hamster_frame_time(int hamster_index) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)_robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(hamster == NULL) return 0;
+	return (double)_hamster_get_frame_time(hamster) / _CLOCK_MILLISECOND;
+}
+
+double _hamster_frame_age(int hamster_index) {
+	struct _hamster_robot* hamster = (struct _hamster_robot*)_robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	unsigned long long frame_time;
+	
+	if(hamster == NULL) return -1;
+	frame_time = _hamster_get_frame_time(hamster);
+	if(frame_time == 0) return -1; // no frame yet
+	return (double)(_clock_get_time() - frame_time) / _CLOCK_MILLISECOND;
+}
+
+int _hamster_signal_strength(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_SIGNAL_STRENGTH);
+}
+
+int _hamster_left_proximity(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_LEFT_PROXIMITY);
+}
+
+int _hamster_right_proximity(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_RIGHT_PROXIMITY);
+}
+
+int _hamster_left_floor(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_LEFT_FLOOR);
+}
+
+int _hamster_right_floor(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_RIGHT_FLOOR);
+}
+
+int _hamster_acceleration_x(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read_at(robot, HAMSTER_ACCELERATION, 0);
+}
+
+int _hamster_acceleration_y(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read_at(robot, HAMSTER_ACCELERATION, 1);
+}
+
+int _hamster_acceleration_z(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read_at(robot, HAMSTER_ACCELERATION, 2);
+}
+
+int _hamster_light(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_LIGHT);
+}
+
+int _hamster_temperature(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_TEMPERATURE);
+}
+
+int _hamster_input_a(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_INPUT_A);
+}
+
+int _hamster_input_b(int hamster_index) {
+	struct _robot* robot = _robot_group_get_robot(_GROUP_HAMSTER, hamster_index);
+	
+	if(robot == NULL) return 0;
+	return _robot_read(robot, HAMSTER_INPUT_B);
+}
+
+#define _MAX_NUM_HAMSTERS 10
+
+#define _FUNCTION_HAMSTER(n) \
+	static __inline const char* _hamster_get_name_##n(void) { return _robot_group_get_name(_GROUP_HAMSTER, n); } \
+	static __inline void _hamster_set_name_##n(const char* name) { _robot_group_set_name(_GROUP_HAMSTER, n, name); } \
+	static __inline const char* _hamster_get_id_##n(void) { return HAMSTER_ID; } \
+	static __inline int _hamster_get_index_##n(void) { return n; } \
+	static __inline int _hamster_e_##n(int device_id) { return _robot_group_e(_GROUP_HAMSTER, n, device_id); } \
+	static __inline int _hamster_read_##n(int device_id) { return _robot_group_read(_GROUP_HAMSTER, n, device_id); } \
+	static __inline int _hamster_read_at_##n(int device_id, int index) { return _robot_group_read_at(_GROUP_HAMSTER, n, device_id, index); } \
+	static __inline int _hamster_read_array_##n(int device_id, int* data, int length) { return _robot_group_read_array(_GROUP_HAMSTER, n, device_id, data, length); } \
+	static __inline float _hamster_read_float_##n(int device_id) { return _robot_group_read_float(_GROUP_HAMSTER, n, device_id); } \
+	static __inline float _hamster_read_float_at_##n(int device_id, int index) { return _robot_group_read_float_at(_GROUP_HAMSTER, n, device_id, index); } \
+	static __inline int _hamster_read_float_array_##n(int device_id, float* data, int length) { return _robot_group_read_float_array(_GROUP_HAMSTER, n, device_id, data, length); } \
+	static __inline int _hamster_write_##n(int device_id, int data) { return _robot_group_write(_GROUP_HAMSTER, n, device_id, data); } \
+	static __inline int _hamster_write_at_##n(int device_id, int index, int data) { return _robot_group_write_at(_GROUP_HAMSTER, n, device_id, index, data); } \
+	static __inline int _hamster_write_array_##n(int device_id, const int* data, int length) { return _robot_group_write_array(_GROUP_HAMSTER, n, device_id, data, length); } \
+	static __inline int _hamster_write_float_##n(int device_id, float data) { return _robot_group_write_float(_GROUP_HAMSTER, n, device_id, data); } \
+	static __inline int _hamster_write_float_at_##n(int device_id, int index, float data) { return _robot_group_write_float_at(_GROUP_HAMSTER, n, device_id, index, data); } \
+	static __inline int _hamster_write_float_array_##n(int device_id, const float* data, int length) { return _robot_group_write_float_array(_GROUP_HAMSTER, n, device_id, data, length); } \
+	static __inline void _hamster_reset_##n(void) { _robot_group_reset(_GROUP_HAMSTER, n); } \
+	static __inline void _hamster_dispose_##n(void) { _robot_group_dispose(_GROUP_HAMSTER, n); } \
+	static __inline void _hamster_wheels_##n(double left_speed, double right_speed) { _hamster_wheels(n, left_speed, right_speed); } \
+	static __inline void _hamster_left_wheel_##n(double speed) { _hamster_left_wheel(n, speed); } \
+	static __inline void _hamster_right_wheel_##n(double speed) { _hamster_right_wheel(n, speed); } \
+	static __inline void _hamster_stop_##n(void) { _hamster_stop(n); } \
+	static __inline int _hamster_line_tracer_mode_callback_##n(void* arg) { return _hamster_line_tracer_mode_callback(n); } \
+	static __inline void _hamster_line_tracer_mode_##n(int mode) { _hamster_line_tracer_mode(n, mode, _hamster_line_tracer_mode_callback_##n); } \
+	static __inline void _hamster_line_tracer_speed_##n(double speed) { _hamster_line_tracer_speed(n, speed); } \
+	static __inline int _hamster_board_forward_callback_##n(void* arg) { return _hamster_board_forward_callback(n); } \
+	static __inline void _hamster_board_forward_##n(void) { _hamster_board_forward(n, _hamster_board_forward_callback_##n); } \
+	static __inline int _hamster_board_left_callback_##n(void* arg) { return _hamster_board_left_callback(n); } \
+	static __inline void _hamster_board_left_##n(void) { _hamster_board_left(n, _hamster_board_left_callback_##n); } \
+	static __inline int _hamster_board_right_callback_##n(void* arg) { return _hamster_board_right_callback(n); } \
+	static __inline void _hamster_board_right_##n(void) { _hamster_board_right(n, _hamster_board_right_callback_##n); } \
+	static __inline void _hamster_leds_##n(int left_color, int right_color) { _hamster_leds(n, left_color, right_color); } \
+	static __inline void _hamster_left_led_##n(int color) { _hamster_left_led(n, color); } \
+	static __inline void _hamster_right_led_##n(int color) { _hamster_right_led(n, color); } \
+	static __inline void _hamster_beep_##n(void) { _hamster_beep(n); } \
+	static __inline void _hamster_buzzer_##n(double hz) { _hamster_buzzer(n, hz); } \
+	static __inline void _hamster_tempo_##n(double bpm) { _hamster_tempo(n, bpm); } \
+	static __inline void _hamster_pitch_##n(double pitch) { _hamster_pitch(n, pitch); } \
+	static __inline void _hamster_note_##n(double pitch, double beats) { _hamster_note(n, pitch, beats); } \
+	static __inline void _hamster_io_mode_a_##n(int mode) { _hamster_io_mode_a(n, mode); } \
+	static __inline void _hamster_io_mode_b_##n(int mode) { _hamster_io_mode_b(n, mode); } \
+	static __inline void _hamster_output_a_##n(double value) { _hamster_output_a(n, value); } \
+	static __inline void _hamster_output_b_##n(double value) { _hamster_output_b(n, value); } \
+	static __inline void _hamster_receive_mode_##n(int mode) { _hamster_receive_mode(n, mode); } \
+	static __inline int _hamster_discarded_frames_##n(void) { return _hamster_discarded_frames(n); } \
+	static __inline int _hamster_rejected_frames_##n(void) { return _hamster_rejected_frames(n); } \
+	static __inline void _hamster_connection_timeout_##n(int milliseconds) { _hamster_connection_timeout(n, milliseconds); } \
+	static __inline int _hamster_frame_sequence_##n(void) { return _hamster_frame_sequence(n); } \
+	static __inline double _hamster_frame_time_##n(void) { return _hamster_frame_time(n); } \
+	static __inline double _hamster_frame_age_##n(void) { return _hamster_frame_age(n); } \
+	static __inline int _hamster_signal_strength_##n(void) { return _hamster_signal_strength(n); } \
+	static __inline int _hamster_left_proximity_##n(void) { return _hamster_left_proximity(n); } \
+	static __inline int _hamster_right_proximity_##n(void) { return _hamster_right_proximity(n); } \
+	static __inline int _hamster_left_floor_##n(void) { return _hamster_left_floor(n); } \
+	static __inline int _hamster_right_floor_##n(void) { return _hamster_right_floor(n); } \
+	static __inline int _hamster_acceleration_x_##n(void) { return _hamster_acceleration_x(n); } \
+	static __inline int _hamster_acceleration_y_##n(void) { return _hamster_acceleration_y(n); } \
+	static __inline int _hamster_acceleration_z_##n(void) { return _hamster_acceleration_z(n); } \
+	static __inline int _hamster_light_##n(void) { return _hamster_light(n); } \
+	static __inline int _hamster_temperature_##n(void) { return _hamster_temperature(n); } \
+	static __inline int _hamster_input_a_##n(void) { return _hamster_input_a(n); } \
+	static __inline int _hamster_input_b_##n(void) { return _hamster_input_b(n); }
+
+#define _FUNCTION_PTR_HAMSTER(name, n) \
+	name->get_name = _hamster_get_name_##n; \
+	name->set_name = _hamster_set_name_##n; \
+	name->get_id = _hamster_get_id_##n; \
+	name->get_index = _hamster_get_index_##n; \
+	name->e = _hamster_e_##n; \
+	name->read = _hamster_read_##n; \
+	name->read_at = _hamster_read_at_##n; \
+	name->read_array = _hamster_read_array_##n; \
+	name->read_float = _hamster_read_float_##n; \
+	name->read_float_at = _hamster_read_float_at_##n; \
+	name->read_float_array = _hamster_read_float_array_##n; \
+	name->write = _hamster_write_##n; \
+	name->write_at = _hamster_write_at_##n; \
+	name->write_array = _hamster_write_array_##n; \
+	name->write_float = _hamster_write_float_##n; \
+	name->write_float_at = _hamster_write_float_at_##n; \
+	name->write_float_array = _hamster_write_float_array_##n; \
+	name->reset = _hamster_reset_##n; \
+	name->dispose = _hamster_dispose_##n; \
+	name->wheels = _hamster_wheels_##n; \
+	name->left_wheel = _hamster_left_wheel_##n; \
+	name->right_wheel = _hamster_right_wheel_##n; \
+	name->stop = _hamster_stop_##n; \
+	name->line_tracer_mode = _hamster_line_tracer_mode_##n; \
+	name->line_tracer_speed = _hamster_line_tracer_speed_##n; \
+	name->board_forward = _hamster_board_forward_##n; \
+	name->board_left = _hamster_board_left_##n; \
+	name->board_right = _hamster_board_right_##n; \
+	name->leds = _hamster_leds_##n; \
+	name->left_led = _hamster_left_led_##n; \
+	name->right_led = _hamster_right_led_##n; \
+	name->beep = _hamster_beep_##n; \
+	name->buzzer = _hamster_buzzer_##n; \
+	name->tempo = _hamster_tempo_##n; \
+	name->pitch = _hamster_pitch_##n; \
+	name->note = _hamster_note_##n; \
+	name->io_mode_a = _hamster_io_mode_a_##n; \
+	name->io_mode_b = _hamster_io_mode_b_##n; \
+	name->output_a = _hamster_output_a_##n; \
+	name->output_b = _hamster_output_b_##n; \
+	name->signal_strength = _hamster_signal_strength_##n; \
+	name->left_proximity = _hamster_left_proximity_##n; \
+	name->right_proximity = _hamster_right_proximity_##n; \
+	name->left_floor = _hamster_left_floor_##n; \
+	name->right_floor = _hamster_right_floor_##n; \
+	name->acceleration_x = _hamster_acceleration_x_##n; \
+	name->acceleration_y = _hamster_acceleration_y_##n; \
+	name->acceleration_z = _hamster_acceleration_z_##n; \
+	name->light = _hamster_light_##n; \
+	name->temperature = _hamster_temperature_##n; \
+	name->input_a = _hamster_input_a_##n; \
+	name->input_b = _hamster_input_b_##n; \
+	name->receive_mode = _hamster_receive_mode_##n; \
+	name->discarded_frames = _hamster_discarded_frames_##n; \
+	name->rejected_frames = _hamster_rejected_frames_##n; \
+	name->connection_timeout = _hamster_connection_timeout_##n; \
+	name->frame_sequence = _hamster_frame_sequence_##n; \
+	name->frame_time = _hamster_frame_time_##n; \
+	name->frame_age = _hamster_frame_age_##n;
+
+_FUNCTION_HAMSTER(0);
+_FUNCTION_HAMSTER(1);
+_FUNCTION_HAMSTER(2);
+_FUNCTION_HAMSTER(3);
+_FUNCTION_HAMSTER(4);
+_FUNCTION_HAMSTER(5);
+_FUNCTION_HAMSTER(6);
+_FUNCTION_HAMSTER(7);
+_FUNCTION_HAMSTER(8);
+_FUNCTION_HAMSTER(9);
+
+Hamster* hamster_create_port(const char* port_name) {
+	if(_robot_group_count_robots(_GROUP_HAMSTER) < _MAX_NUM_HAMSTERS) {
+		struct hamster* hamster = (struct hamster*)malloc(sizeof(struct hamster));
+		struct _robot* robot = (struct _robot*)_hamster_create(port_name);
+	
+		switch(robot->index) {
+			case 0: _FUNCTION_PTR_HAMSTER(hamster, 0); break;
+			case 1: _FUNCTION_PTR_HAMSTER(hamster, 1); break;
+			case 2: _FUNCTION_PTR_HAMSTER(hamster, 2); break;
+			case 3: _FUNCTION_PTR_HAMSTER(hamster, 3); break;
+			case 4: _FUNCTION_PTR_HAMSTER(hamster, 4); break;
+			case 5: _FUNCTION_PTR_HAMSTER(hamster, 5); break;
+			case 6: _FUNCTION_PTR_HAMSTER(hamster, 6); break;
+			case 7: _FUNCTION_PTR_HAMSTER(hamster, 7); break;
+			case 8: _FUNCTION_PTR_HAMSTER(hamster, 8); break;
+			case 9: _FUNCTION_PTR_HAMSTER(hamster, 9); break;
+		}
+		return hamster;
+	}
+	return NULL;
+}
+
+Hamster* hamster_create(void) {
+	return hamster_create_port(NULL);
+}
+
+const char* hamster_get_name(void) {
+	return _robot_group_get_name(_GROUP_HAMSTER, 0);
+}
+
+void hamster_set_name(const char* name) {
+	_robot_group_set_name(_GROUP_HAMSTER, 0, name);
+}
+
+const char* hamster_get_id(void) {
+	return HAMSTER_ID;
+}
+
+int hamster_e(int device_id) {
+	return _robot_group_e(_GROUP_HAMSTER, 0, device_id);
+}
+
+int hamster_read(int device_id) {
+	return _robot_group_read(_GROUP_HAMSTER, 0, device_id);
+}
+
+int hamster_read_at(int device_id, int index) {
+	return _robot_group_read_at(_GROUP_HAMSTER, 0, device_id, index);
+}
+
+int hamster_read_array(int device_id, int* data, int length) {
+	return _robot_group_read_array(_GROUP_HAMSTER, 0, device_id, data, length);
+}
+
+float hamster_read_float(int device_id) {
+	return _robot_group_read_float(_GROUP_HAMSTER, 0, device_id);
+}
+
+float hamster_read_float_at(int device_id, int index) {
+	return _robot_group_read_float_at(_GROUP_HAMSTER, 0, device_id, index);
+}
+
+int hamster_read_float_array(int device_id, float* data, int length) {
+	return _robot_group_read_float_array(_GROUP_HAMSTER, 0, device_id, data, length);
+}
+
+int hamster_write(int device_id, int data) {
+	return _robot_group_write(_GROUP_HAMSTER, 0, device_id, data);
+}
+
+int hamster_write_at(int device_id, int index, int data) {
+	return _robot_group_write_at(_GROUP_HAMSTER, 0, device_id, index, data);
+}
+
+int hamster_write_array(int device_id, const int* data, int length) {
+	return _robot_group_write_array(_GROUP_HAMSTER, 0, device_id, data, length);
+}
+
+int hamster_write_float(int device_id, float data) {
+	return _robot_group_write_float(_GROUP_HAMSTER, 0, device_id, data);
+}
+
+int hamster_write_float_at(int device_id, int index, float data) {
+	return _robot_group_write_float_at(_GROUP_HAMSTER, 0, device_id, index, data);
+}
+
+int hamster_write_float_array(int device_id, const float* data, int length) {
+	return _robot_group_write_float_array(_GROUP_HAMSTER, 0, device_id, data, length);
+}
+
+void hamster_reset(void) {
+	_robot_group_reset(_GROUP_HAMSTER, 0);
+}
+
+void hamster_dispose(void) {
+	_robot_group_dispose(_GROUP_HAMSTER, 0);
+}
+
+void hamster_wheels(double left_speed, double right_speed) {
+	_hamster_wheels(0, left_speed, right_speed);
+}
+
+void hamster_left_wheel(double speed) {
+	_hamster_left_wheel(0, speed);
+}
+
+void hamster_right_wheel(double speed) {
+	_hamster_right_wheel(0, speed);
+}
+
+void hamster_stop(void) {
+	_hamster_stop(0);
+}
+
+int _hamster_line_tracer_mode_evaluate(void* arg) {
+	return _hamster_line_tracer_mode_callback(0);
+}
+
+void hamster_line_tracer_mode(int mode) {
+	_hamster_line_tracer_mode(0, mode, _hamster_line_tracer_mode_evaluate);
+}
+
+void hamster_line_tracer_speed(double speed) {
+	_hamster_line_tracer_speed(0, speed);
+}
+
+int _hamster_board_forward_evaluate(void* arg) {
+	return _hamster_board_forward_callback(0);
+}
+
+void hamster_board_forward(void) {
+	_hamster_board_forward(0, _hamster_board_forward_evaluate);
+}
+
+int _hamster_board_left_evaluate(void* arg) {
+	return _hamster_board_left_callback(0);
+}
+
+void hamster_board_left(void) {
+	_hamster_board_left(0, _hamster_board_left_evaluate);
+}
+
+int _hamster_board_right_evaluate(void* arg) {
+	return _hamster_board_right_callback(0);
+}
+
+void hamster_board_right(void) {
+	_hamster_board_right(0, _hamster_board_right_evaluate);
+}
+
+void hamster_leds(int left_color, int right_color) {
+	_hamster_leds(0, left_color, right_color);
+}
+
+void hamster_left_led(int color) {
+	_hamster_left_led(0, color);
+}
+
+void hamster_right_led(int color) {
+	_hamster_right_led(0, color);
+}
+
+void hamster_beep(void) {
+	_hamster_beep(0);
+}
+
+void hamster_buzzer(double hz) {
+	_hamster_buzzer(0, hz);
+}
+
+void hamster_tempo(double bpm) {
+	_hamster_tempo(0, bpm);
+}
+
+void hamster_pitch(double pitch) {
+	_hamster_pitch(0, pitch);
+}
+
+void hamster_note(double pitch, double beats) {
+	_hamster_note(0, pitch, beats);
+}
+
+void hamster_io_mode_a(int mode) {
+	_hamster_io_mode_a(0, mode);
+}
+
+void hamster_io_mode_b(int mode) {
+	_hamster_io_mode_b(0, mode);
+}
+
+void hamster_output_a(double value) {
+	_hamster_output_a(0, value);
+}
+
+void hamster_output_b(double value) {
+	_hamster_output_b(0, value);
+}
+
+void hamster_receive_mode(int mode) {
+	_hamster_receive_mode(0, mode);
+}
+
+int hamster_discarded_frames(void) {
+	return _hamster_discarded_frames(0);
+}
+
+int hamster_rejected_frames(void) {
+	return _hamster_rejected_frames(0);
+}
+
+void hamster_connection_timeout(int milliseconds) {
+	_hamster_connection_timeout(0, milliseconds);
+}
+
+int hamster_frame_sequence(void) {
+	return _hamster_frame_sequence(0);
+}
+
+double hamster_frame_time(void) {
+	return _hamster_frame_time(0);
+}
+
+double hamster_frame_age(void) {
+	return _hamster_frame_age(0);
+}
+
+int hamster_signal_strength(void) {
+	return _hamster_signal_strength(0);
+}
+
+int hamster_left_proximity(void) {
+	return _hamster_left_proximity(0);
+}
+
+int hamster_right_proximity(void) {
+	return _hamster_right_proximity(0);
+}
+
+int hamster_left_floor(void) {
+	return _hamster_left_floor(0);
+}
+
+int hamster_right_floor(void) {
+	return _hamster_right_floor(0);
+}
+
+int hamster_acceleration_x(void) {
+	return _hamster_acceleration_x(0);
+}
+
+int hamster_acceleration_y(void) {
+	return _hamster_acceleration_y(0);
+}
+
+int hamster_acceleration_z(void) {
+	return _hamster_acceleration_z(0);
+}
+
+int hamster_light(void) {
+	return _hamster_light(0);
+}
+
+int hamster_temperature(void) {
+	return _hamster_temperature(0);
+}
+
+int hamster_input_a(void) {
+	return _hamster_input_a(0);
+}
+
+int hamster_input_b(void) {
+	return _hamster_input_b(0);
+}